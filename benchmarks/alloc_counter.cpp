@@ -0,0 +1,58 @@
+#include "alloc_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global allocation functions for the whole benchmark executable.
+// Only the allocating overloads count; every form of operator delete just frees.
+
+namespace {
+    std::atomic<std::size_t> g_allocations { 0 };
+
+    void* allocate(std::size_t size) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        if (void* ptr { std::malloc(size == 0 ? 1 : size) }) {
+            return ptr;
+        }
+        throw std::bad_alloc {};
+    }
+
+    void* allocateAligned(std::size_t size, std::align_val_t align) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        const auto alignment { static_cast<std::size_t>(align) };
+        // aligned_alloc requires the size to be a multiple of the alignment
+        const std::size_t rounded { (size + alignment - 1) / alignment * alignment };
+        if (void* ptr { std::aligned_alloc(alignment, rounded == 0 ? alignment : rounded) }) {
+            return ptr;
+        }
+        throw std::bad_alloc {};
+    }
+}
+
+std::size_t allocationCount() noexcept {
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t align) { return allocateAligned(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return allocateAligned(size, align); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
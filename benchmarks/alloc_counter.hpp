@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+
+// -----------------------------------------------------------------------------
+// Global heap allocation counter, fed by the operator new replacements in alloc_counter.cpp
+// -----------------------------------------------------------------------------
+
+// Number of calls to any global operator new since the program started
+std::size_t allocationCount() noexcept;
+
+// Counts the allocations made while it's alive
+class AllocationScope {
+public:
+    AllocationScope() noexcept : m_start { allocationCount() } {}
+
+    std::size_t count() const noexcept {
+        return allocationCount() - m_start;
+    }
+
+private:
+    std::size_t m_start {};
+};
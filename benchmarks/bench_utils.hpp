@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Shared helpers for the container benchmarks
+// -----------------------------------------------------------------------------
+
+// Debug builds run the containers' assertValid() on every mutation, which is O(n) per call.
+// Keep inputs small there so the bench_smoke test stays fast; Release (the bench preset) uses real sizes.
+#ifdef NDEBUG
+inline constexpr std::int64_t kBenchMaxElements { 1 << 22 };
+#else
+inline constexpr std::int64_t kBenchMaxElements { 1 << 10 };
+#endif
+
+inline constexpr std::uint64_t kBenchSeed { 0x5EED5EEDull };
+
+inline std::vector<int> makeRandomInts(std::size_t n, std::uint64_t seed = kBenchSeed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> dist;
+    std::vector<int> out(n);
+    for (auto& x : out) {
+        x = dist(rng);
+    }
+    return out;
+}
+
+inline std::vector<std::string> makeRandomStrings(std::size_t n, std::size_t length,
+                                                  std::uint64_t seed = kBenchSeed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> dist('a', 'z');
+    std::vector<std::string> out(n);
+    for (auto& str : out) {
+        str.resize(length);
+        for (auto& c : str) {
+            c = static_cast<char>(dist(rng));
+        }
+    }
+    return out;
+}
@@ -0,0 +1,266 @@
+#include "bench_utils.hpp"
+#include "../tests/utils/lifetime_tracker.hpp"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <systems_dsa/binary_heap.hpp>
+#include <type_traits>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Heap arity: 2, 4 and 8 children per node, 1K - 10M int elements in Release. A heap of n random elements is built
+// outside the timed region; each iteration then runs kHeapOps operations against it.
+// -----------------------------------------------------------------------------
+#ifdef NDEBUG
+inline constexpr std::int64_t kHeapMaxElements { 10'000'000 };
+inline constexpr std::size_t kHeapOps { 1 << 16 };
+#else
+inline constexpr std::int64_t kHeapMaxElements { 1 << 10 };
+inline constexpr std::size_t kHeapOps { 1 << 6 };
+#endif
+
+template <std::size_t Arity>
+using ArityHeap = systems_dsa::binary_heap<int, std::less<int>, std::allocator<int>, Arity>;
+
+template <std::size_t Arity>
+static ArityHeap<Arity> makeHeap(const std::vector<int>& values) {
+    ArityHeap<Arity> heap { values.size() };
+    for (const int value : values) {
+        heap.push(value);
+    }
+    return heap;
+}
+
+// Scheduler steady state: pop the top and push a new element, so the size stays at n. Every pop descends the full
+// depth of the heap; random pushes mostly stop within a level or two.
+template <std::size_t Arity>
+static void BM_HeapPopPush(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const std::vector<int> values { makeRandomInts(n) };
+    const std::vector<int> incoming { makeRandomInts(kHeapOps, kBenchSeed + 1) };
+    ArityHeap<Arity> heap { makeHeap<Arity>(values) };
+    for ([[maybe_unused]] auto _ : state) {
+        for (const int value : incoming) {
+            heap.pop();
+            heap.push(value);
+        }
+        benchmark::DoNotOptimize(heap.top());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kHeapOps));
+}
+
+// Half the operations pushes, half pops, interleaved, on a heap of about n elements
+template <std::size_t Arity>
+static void BM_HeapMixedOps(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const std::vector<int> values { makeRandomInts(n) };
+    const std::vector<int> incoming { makeRandomInts(kHeapOps, kBenchSeed + 1) };
+    ArityHeap<Arity> heap { makeHeap<Arity>(values) };
+    for ([[maybe_unused]] auto _ : state) {
+        for (std::size_t i {}; i < kHeapOps; ++i) {
+            // Two pushes then two pops keeps the size within two of n
+            if ((i & 2) == 0) {
+                heap.push(incoming[i]);
+            } else {
+                heap.pop();
+            }
+        }
+        benchmark::DoNotOptimize(heap.top());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kHeapOps));
+}
+
+#define SYSTEMS_DSA_HEAP_ARITY_BENCH(fn)                                                           \
+    BENCHMARK_TEMPLATE(fn, 2)->RangeMultiplier(10)->Range(1'000, kHeapMaxElements);                 \
+    BENCHMARK_TEMPLATE(fn, 4)->RangeMultiplier(10)->Range(1'000, kHeapMaxElements);                 \
+    BENCHMARK_TEMPLATE(fn, 8)->RangeMultiplier(10)->Range(1'000, kHeapMaxElements)
+
+SYSTEMS_DSA_HEAP_ARITY_BENCH(BM_HeapPopPush);
+SYSTEMS_DSA_HEAP_ARITY_BENCH(BM_HeapMixedOps);
+
+// -----------------------------------------------------------------------------
+// Loading n elements at once: n individual pushes against the range constructor (Floyd's heapify). Random input, and
+// ascending input, which makes every push climb to the root of a max-heap.
+// -----------------------------------------------------------------------------
+enum class LoadOrder : std::uint8_t {
+    random,
+    ascending,
+};
+
+static std::vector<int> makeLoad(std::size_t n, LoadOrder order) {
+    std::vector<int> values { makeRandomInts(n) };
+    if (order == LoadOrder::ascending) {
+        std::sort(values.begin(), values.end());
+    }
+    return values;
+}
+
+template <LoadOrder Order>
+static void BM_HeapLoadPush(benchmark::State& state) {
+    const std::vector<int> values { makeLoad(static_cast<std::size_t>(state.range(0)), Order) };
+    for ([[maybe_unused]] auto _ : state) {
+        systems_dsa::binary_heap<int> heap { values.size() };
+        for (const int value : values) {
+            heap.push(value);
+        }
+        benchmark::DoNotOptimize(heap.top());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <LoadOrder Order>
+static void BM_HeapLoadRange(benchmark::State& state) {
+    const std::vector<int> values { makeLoad(static_cast<std::size_t>(state.range(0)), Order) };
+    for ([[maybe_unused]] auto _ : state) {
+        systems_dsa::binary_heap<int> heap(values.begin(), values.end());
+        benchmark::DoNotOptimize(heap.top());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// An epoch reload: a batch as large as the heap is push_range'd onto it, then popped back off
+template <LoadOrder Order>
+static void BM_HeapEpochPushRange(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const std::vector<int> values { makeLoad(n, Order) };
+    systems_dsa::binary_heap<int> heap(values.begin(), values.end());
+    for ([[maybe_unused]] auto _ : state) {
+        heap.push_range(values);
+        state.PauseTiming();
+        for (std::size_t i {}; i < n; ++i) {
+            heap.pop();
+        }
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(heap.top());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <LoadOrder Order>
+static void BM_HeapEpochPush(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const std::vector<int> values { makeLoad(n, Order) };
+    systems_dsa::binary_heap<int> heap(values.begin(), values.end());
+    for ([[maybe_unused]] auto _ : state) {
+        for (const int value : values) {
+            heap.push(value);
+        }
+        state.PauseTiming();
+        for (std::size_t i {}; i < n; ++i) {
+            heap.pop();
+        }
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(heap.top());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#define SYSTEMS_DSA_HEAP_LOAD_BENCH(fn)                                                            \
+    BENCHMARK_TEMPLATE(fn, LoadOrder::random)->RangeMultiplier(10)->Range(1'000, kHeapMaxElements);    \
+    BENCHMARK_TEMPLATE(fn, LoadOrder::ascending)->RangeMultiplier(10)->Range(1'000, kHeapMaxElements)
+
+SYSTEMS_DSA_HEAP_LOAD_BENCH(BM_HeapLoadPush);
+SYSTEMS_DSA_HEAP_LOAD_BENCH(BM_HeapLoadRange);
+SYSTEMS_DSA_HEAP_LOAD_BENCH(BM_HeapEpochPush);
+SYSTEMS_DSA_HEAP_LOAD_BENCH(BM_HeapEpochPushRange);
+
+// -----------------------------------------------------------------------------
+// Element moves: the pop+push steady state with elements that are costly to move. 24-character strings (past the
+// small string buffer, so a move swaps heap pointers), 64-byte payloads, and LifetimeTracker, whose move counts
+// are reported per operation. 1K - 1M elements in Release.
+// -----------------------------------------------------------------------------
+#ifdef NDEBUG
+inline constexpr std::int64_t kHeapPayloadMaxElements { 1'000'000 };
+#else
+inline constexpr std::int64_t kHeapPayloadMaxElements { 1 << 10 };
+#endif
+
+struct Payload64 {
+    std::uint64_t key {};
+    std::array<std::uint64_t, 7> payload {};
+
+    bool operator<(const Payload64& other) const {
+        return key < other.key;
+    }
+};
+static_assert(sizeof(Payload64) == 64);
+
+template <typename T>
+static std::vector<T> makePayloads(std::size_t n, std::uint64_t seed) {
+    std::vector<T> out {};
+    out.reserve(n);
+    if constexpr (std::is_same_v<T, std::string>) {
+        out = makeRandomStrings(n, 24, seed);
+    } else {
+        for (const int value : makeRandomInts(n, seed)) {
+            if constexpr (std::is_same_v<T, Payload64>) {
+                out.push_back(Payload64 { .key = static_cast<std::uint64_t>(value) });
+            } else {
+                out.emplace_back(value);
+            }
+        }
+    }
+    return out;
+}
+
+template <typename T>
+static void BM_HeapPopPushPayload(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const std::vector<T> values { makePayloads<T>(n, kBenchSeed) };
+    const std::vector<T> incoming { makePayloads<T>(kHeapOps, kBenchSeed + 1) };
+    systems_dsa::binary_heap<T> heap(values.begin(), values.end());
+    if constexpr (std::is_same_v<T, LifetimeTracker>) {
+        LifetimeTracker::resetCounts();
+    }
+    for ([[maybe_unused]] auto _ : state) {
+        for (const T& value : incoming) {
+            heap.pop();
+            heap.push(value);
+        }
+        benchmark::DoNotOptimize(heap.top());
+    }
+    const auto ops { static_cast<double>(state.iterations() * static_cast<std::int64_t>(kHeapOps)) };
+    if constexpr (std::is_same_v<T, LifetimeTracker>) {
+        state.counters["moves_per_op"] = static_cast<double>(LifetimeTracker::moveCtorCount)
+            / ops + static_cast<double>(LifetimeTracker::moveAssignCount) / ops;
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kHeapOps));
+}
+
+// Popping every element of an n-element heap. Here the last element, which a pop moves into the root, almost always
+// belongs back at the bottom.
+template <typename T>
+static void BM_HeapDrainPayload(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const std::vector<T> values { makePayloads<T>(n, kBenchSeed) };
+    for ([[maybe_unused]] auto _ : state) {
+        state.PauseTiming();
+        systems_dsa::binary_heap<T> heap(values.begin(), values.end());
+        if constexpr (std::is_same_v<T, LifetimeTracker>) {
+            LifetimeTracker::resetCounts();
+        }
+        state.ResumeTiming();
+        while (!heap.empty()) {
+            heap.pop();
+        }
+        benchmark::DoNotOptimize(heap.size());
+        if constexpr (std::is_same_v<T, LifetimeTracker>) {
+            state.counters["moves_per_op"] = static_cast<double>(LifetimeTracker::moveCtorCount
+                + LifetimeTracker::moveAssignCount) / static_cast<double>(n);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_HeapPopPushPayload, std::string)->RangeMultiplier(10)->Range(1'000, kHeapPayloadMaxElements);
+BENCHMARK_TEMPLATE(BM_HeapPopPushPayload, Payload64)->RangeMultiplier(10)->Range(1'000, kHeapPayloadMaxElements);
+BENCHMARK_TEMPLATE(BM_HeapPopPushPayload, LifetimeTracker)
+    ->RangeMultiplier(10)->Range(1'000, kHeapPayloadMaxElements);
+BENCHMARK_TEMPLATE(BM_HeapDrainPayload, std::string)->RangeMultiplier(10)->Range(1'000, kHeapPayloadMaxElements);
+BENCHMARK_TEMPLATE(BM_HeapDrainPayload, Payload64)->RangeMultiplier(10)->Range(1'000, kHeapPayloadMaxElements);
+BENCHMARK_TEMPLATE(BM_HeapDrainPayload, LifetimeTracker)->RangeMultiplier(10)->Range(1'000, kHeapPayloadMaxElements);
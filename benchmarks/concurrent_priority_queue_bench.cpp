@@ -0,0 +1,79 @@
+#include "bench_utils.hpp"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <systems_dsa/binary_heap.hpp>
+#include <systems_dsa/concurrent_priority_queue.hpp>
+#include <thread>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Shared priority queue throughput vs threads: one binary_heap behind a mutex vs the MultiQueue.
+// Workload: every thread alternates push and pop on a queue prefilled with kConcurrentHeapPrefill elements, the
+// steady state of a scheduler whose workers both submit and take tasks.
+// -----------------------------------------------------------------------------
+
+// What callers did before concurrent_priority_queue existed
+class MutexHeap {
+public:
+    explicit MutexHeap(std::size_t) {}
+
+    void push(int value) {
+        std::lock_guard lock { m_mutex };
+        m_heap.push(value);
+    }
+
+    std::optional<int> try_pop() {
+        std::lock_guard lock { m_mutex };
+        if (m_heap.empty()) {
+            return std::nullopt;
+        }
+        return m_heap.extract_top();
+    }
+
+private:
+    std::mutex m_mutex {};
+    systems_dsa::binary_heap<int> m_heap {};
+};
+
+using MultiQueue = systems_dsa::concurrent_priority_queue<int>;
+
+constexpr int kConcurrentHeapPrefill { static_cast<int>(std::min<std::int64_t>(1 << 16, kBenchMaxElements)) };
+constexpr int kConcurrentHeapOpsPerIteration { 256 };
+
+template <typename Queue>
+static std::unique_ptr<Queue> g_concurrentHeap {};
+
+template <typename Queue>
+static void BM_ConcurrentHeapPushPop(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        g_concurrentHeap<Queue> = std::make_unique<Queue>(static_cast<std::size_t>(state.threads()));
+        for (const int value : makeRandomInts(kConcurrentHeapPrefill)) {
+            g_concurrentHeap<Queue>->push(value);
+        }
+    }
+    const auto values { makeRandomInts(kConcurrentHeapOpsPerIteration,
+        kBenchSeed + static_cast<std::uint64_t>(state.thread_index())) };
+
+    for ([[maybe_unused]] auto _ : state) {
+        Queue& queue { *g_concurrentHeap<Queue> };
+        for (int i {}; i < kConcurrentHeapOpsPerIteration; ++i) {
+            if (i % 2 == 0) {
+                queue.push(values[i]);
+            } else {
+                benchmark::DoNotOptimize(queue.try_pop());
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kConcurrentHeapOpsPerIteration);
+
+    if (state.thread_index() == 0) {
+        g_concurrentHeap<Queue>.reset();
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_ConcurrentHeapPushPop, MutexHeap)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ConcurrentHeapPushPop, MultiQueue)->ThreadRange(1, 8)->UseRealTime();
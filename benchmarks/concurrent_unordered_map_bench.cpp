@@ -0,0 +1,71 @@
+#include "bench_utils.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <mutex>
+#include <systems_dsa/concurrent_unordered_map.hpp>
+#include <systems_dsa/unordered_map.hpp>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Shared map throughput vs threads: one global mutex vs per-shard reader-writer locks.
+// Workload: 90% find, 10% insert over a fixed key range.
+// -----------------------------------------------------------------------------
+
+// What callers did before concurrent_unordered_map existed
+class MutexMap {
+public:
+    bool insert(int key, int value) {
+        std::lock_guard lock { m_mutex };
+        return m_map.insert(key, value).second;
+    }
+
+    bool contains(int key) {
+        std::lock_guard lock { m_mutex };
+        return m_map.contains(key);
+    }
+
+private:
+    std::mutex m_mutex {};
+    systems_dsa::unordered_map<int, int> m_map {};
+};
+
+using ShardedMap = systems_dsa::concurrent_unordered_map<int, int>;
+
+constexpr int kConcurrentKeyRange { static_cast<int>(std::min<std::int64_t>(1 << 16, kBenchMaxElements)) };
+constexpr int kConcurrentOpsPerIteration { 256 };
+
+template <typename Map>
+static std::unique_ptr<Map> g_concurrentMap {};
+
+template <typename Map>
+static void BM_ConcurrentMapReadMostly(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        g_concurrentMap<Map> = std::make_unique<Map>();
+        for (int key {}; key < kConcurrentKeyRange; key += 2) {
+            g_concurrentMap<Map>->insert(key, key);
+        }
+    }
+    const auto keys { makeRandomInts(kConcurrentOpsPerIteration, kBenchSeed + static_cast<std::uint64_t>(state.thread_index())) };
+
+    for ([[maybe_unused]] auto _ : state) {
+        Map& hashMap { *g_concurrentMap<Map> };
+        for (int i {}; i < kConcurrentOpsPerIteration; ++i) {
+            const int key { static_cast<int>(static_cast<unsigned>(keys[i]) % kConcurrentKeyRange) };
+            if (i % 10 == 0) {
+                benchmark::DoNotOptimize(hashMap.insert(key, key));
+            } else {
+                benchmark::DoNotOptimize(hashMap.contains(key));
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kConcurrentOpsPerIteration);
+
+    if (state.thread_index() == 0) {
+        g_concurrentMap<Map>.reset();
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_ConcurrentMapReadMostly, MutexMap)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ConcurrentMapReadMostly, ShardedMap)->ThreadRange(1, 8)->UseRealTime();
@@ -0,0 +1,183 @@
+#include "bench_utils.hpp"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <systems_dsa/huge_page_allocator.hpp>
+#include <systems_dsa/unordered_map.hpp>
+#include <systems_dsa/vector.hpp>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// -----------------------------------------------------------------------------
+// Random lookups over working sets far larger than the TLB reach of 4K pages (1536 entries * 4K = 6MB on a typical
+// core), with std::allocator against huge_page_allocator. Where perf_event_open is allowed the dTLB load misses per
+// lookup are reported next to the time; otherwise the counter reads -1. 1MB - 512MB working sets in Release.
+// -----------------------------------------------------------------------------
+#ifdef NDEBUG
+inline constexpr std::int64_t kTlbMinBytes { std::int64_t { 1 } << 20 };
+inline constexpr std::int64_t kTlbMaxBytes { std::int64_t { 512 } << 20 };
+inline constexpr std::size_t kTlbLookups { 1 << 20 };
+#else
+inline constexpr std::int64_t kTlbMinBytes { std::int64_t { 64 } << 10 };
+inline constexpr std::int64_t kTlbMaxBytes { std::int64_t { 256 } << 10 };
+inline constexpr std::size_t kTlbLookups { 1 << 10 };
+#endif
+
+// Counts dTLB load misses of the calling thread between start() and stop()
+class DtlbMissCounter {
+public:
+    DtlbMissCounter() {
+    #if defined(__linux__)
+        perf_event_attr attr {};
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    #endif
+    }
+
+    DtlbMissCounter(const DtlbMissCounter&) = delete;
+    DtlbMissCounter& operator=(const DtlbMissCounter&) = delete;
+
+    ~DtlbMissCounter() {
+    #if defined(__linux__)
+        if (m_fd >= 0) {
+            close(m_fd);
+        }
+    #endif
+    }
+
+    bool available() const noexcept {
+        return m_fd >= 0;
+    }
+
+    void start() noexcept {
+    #if defined(__linux__)
+        if (available()) {
+            ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    #endif
+    }
+
+    void stop() noexcept {
+    #if defined(__linux__)
+        if (available()) {
+            ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    #endif
+    }
+
+    std::uint64_t misses() const noexcept {
+        std::uint64_t count {};
+    #if defined(__linux__)
+        if (available() && read(m_fd, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) {
+            count = 0;
+        }
+    #endif
+        return count;
+    }
+
+private:
+    int m_fd { -1 };
+};
+
+static void reportTlbMisses(benchmark::State& state, const DtlbMissCounter& counter, std::size_t lookups) {
+    state.counters["dtlb_misses_per_lookup"] = counter.available()
+        ? static_cast<double>(counter.misses()) / static_cast<double>(state.iterations() * lookups)
+        : -1.0;
+}
+
+// A single random cycle through the whole array (Sattolo's algorithm), so each load depends on the previous one and
+// the prefetchers can't hide the page walks
+template <typename Allocator>
+static void BM_PointerChase(benchmark::State& state) {
+    const auto count { static_cast<std::size_t>(state.range(0)) / sizeof(std::uint64_t) };
+    systems_dsa::vector<std::uint64_t, Allocator> next {};
+    next.resize(count);
+    std::iota(next.begin(), next.end(), std::uint64_t {});
+    std::mt19937_64 rng { kBenchSeed };
+    for (std::size_t i { count - 1 }; i > 0; --i) {
+        std::uniform_int_distribution<std::size_t> dist { 0, i - 1 };
+        std::swap(next[i], next[dist(rng)]);
+    }
+
+    DtlbMissCounter counter {};
+    std::uint64_t position {};
+    for ([[maybe_unused]] auto _ : state) {
+        counter.start();
+        for (std::size_t i {}; i < kTlbLookups; ++i) {
+            position = next[position];
+        }
+        counter.stop();
+        benchmark::DoNotOptimize(position);
+    }
+    reportTlbMisses(state, counter, kTlbLookups);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kTlbLookups));
+}
+
+template <typename T>
+using HugePages = systems_dsa::huge_page_allocator<T>;
+
+BENCHMARK_TEMPLATE(BM_PointerChase, std::allocator<std::uint64_t>)
+    ->RangeMultiplier(8)->Range(kTlbMinBytes, kTlbMaxBytes);
+BENCHMARK_TEMPLATE(BM_PointerChase, HugePages<std::uint64_t>)
+    ->RangeMultiplier(8)->Range(kTlbMinBytes, kTlbMaxBytes);
+
+// -----------------------------------------------------------------------------
+// Random successful finds in an unordered_map whose bucket array spans the working set. Keys are looked up in a
+// shuffled order, each find being independent, so this measures throughput rather than latency.
+// -----------------------------------------------------------------------------
+template <typename Allocator>
+using TlbMap = systems_dsa::unordered_map<std::uint64_t, std::uint64_t, std::hash<std::uint64_t>,
+    std::equal_to<std::uint64_t>, systems_dsa::modulo_bucket_policy, systems_dsa::linear_probe_policy,
+    systems_dsa::auto_hash_cache_policy, Allocator>;
+
+template <typename Allocator>
+static void BM_MapRandomFind(benchmark::State& state) {
+    // Roughly two 16-byte buckets per element at the default load factor
+    const auto count { std::max<std::size_t>(static_cast<std::size_t>(state.range(0)) / 32, 1) };
+    TlbMap<Allocator> map {};
+    for (std::uint64_t key {}; key < count; ++key) {
+        map.insert(key, key);
+    }
+    std::vector<std::uint64_t> order(kTlbLookups);
+    std::mt19937_64 rng { kBenchSeed };
+    std::uniform_int_distribution<std::uint64_t> dist { 0, count - 1 };
+    for (auto& key : order) {
+        key = dist(rng);
+    }
+
+    DtlbMissCounter counter {};
+    for ([[maybe_unused]] auto _ : state) {
+        std::uint64_t sum {};
+        counter.start();
+        for (const std::uint64_t key : order) {
+            sum += map.find(key)->second;
+        }
+        counter.stop();
+        benchmark::DoNotOptimize(sum);
+    }
+    reportTlbMisses(state, counter, kTlbLookups);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kTlbLookups));
+}
+
+BENCHMARK_TEMPLATE(BM_MapRandomFind, std::allocator<std::pair<const std::uint64_t, std::uint64_t>>)
+    ->RangeMultiplier(8)->Range(kTlbMinBytes, kTlbMaxBytes);
+BENCHMARK_TEMPLATE(BM_MapRandomFind, HugePages<std::pair<const std::uint64_t, std::uint64_t>>)
+    ->RangeMultiplier(8)->Range(kTlbMinBytes, kTlbMaxBytes);
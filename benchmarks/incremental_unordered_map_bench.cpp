@@ -0,0 +1,52 @@
+#include "bench_utils.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <systems_dsa/incremental_unordered_map.hpp>
+#include <systems_dsa/unordered_map.hpp>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Insert tail latency: a full rehash on growth vs incremental migration.
+// Every insert into an empty map is timed individually; the counters report the latency percentiles in ns.
+// -----------------------------------------------------------------------------
+
+template <typename Map>
+static void BM_InsertLatency(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const auto keys { makeRandomInts(n) };
+    std::vector<std::int64_t> latencies(n);
+    std::vector<std::int64_t> allLatencies {};
+
+    for ([[maybe_unused]] auto _ : state) {
+        Map hashMap {};
+        for (std::size_t i {}; i < n; ++i) {
+            const auto start { std::chrono::steady_clock::now() };
+            hashMap.insert(keys[i], static_cast<int>(i));
+            const auto stop { std::chrono::steady_clock::now() };
+            latencies[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+        }
+        benchmark::DoNotOptimize(hashMap);
+        state.PauseTiming();
+        allLatencies.insert(allLatencies.end(), latencies.begin(), latencies.end());
+        state.ResumeTiming();
+    }
+
+    std::sort(allLatencies.begin(), allLatencies.end());
+    const auto percentile = [&](double p) {
+        const auto index { static_cast<std::size_t>(p * static_cast<double>(allLatencies.size() - 1)) };
+        return static_cast<double>(allLatencies[index]);
+    };
+    state.counters["p50_ns"] = percentile(0.50);
+    state.counters["p99_ns"] = percentile(0.99);
+    state.counters["p999_ns"] = percentile(0.999);
+    state.counters["max_ns"] = static_cast<double>(allLatencies.back());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+using FullRehashMap = systems_dsa::unordered_map<int, int>;
+using IncrementalMap = systems_dsa::incremental_unordered_map<int, int>;
+
+BENCHMARK_TEMPLATE(BM_InsertLatency, FullRehashMap)->RangeMultiplier(8)->Range(1 << 10, kBenchMaxElements);
+BENCHMARK_TEMPLATE(BM_InsertLatency, IncrementalMap)->RangeMultiplier(8)->Range(1 << 10, kBenchMaxElements);
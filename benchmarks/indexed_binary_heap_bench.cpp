@@ -0,0 +1,113 @@
+#include "bench_utils.hpp"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <systems_dsa/binary_heap.hpp>
+#include <systems_dsa/indexed_binary_heap.hpp>
+#include <utility>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Dijkstra over a random graph of n nodes with kDijkstraDegree out-edges each. The lazy variant pushes a duplicate
+// entry on every improved distance into a binary_heap and skips stale ones when they're popped; the indexed variant
+// keeps one entry per node and lowers it in place with update(). peak_heap_size is the largest heap either ran with.
+// 1K - 1M nodes in Release.
+// -----------------------------------------------------------------------------
+#ifdef NDEBUG
+inline constexpr std::int64_t kDijkstraMaxNodes { 1 << 20 };
+#else
+inline constexpr std::int64_t kDijkstraMaxNodes { 1 << 10 };
+#endif
+inline constexpr std::size_t kDijkstraDegree { 8 };
+
+struct Edge {
+    std::uint32_t to;
+    std::uint32_t weight;
+};
+
+// Adjacency lists stored back to back, node v's edges are [v * kDijkstraDegree, (v + 1) * kDijkstraDegree)
+static std::vector<Edge> makeGraph(std::size_t nodes) {
+    std::mt19937_64 rng { kBenchSeed };
+    std::uniform_int_distribution<std::uint32_t> nodeDist { 0, static_cast<std::uint32_t>(nodes - 1) };
+    std::uniform_int_distribution<std::uint32_t> weightDist { 1, 1'000 };
+    std::vector<Edge> edges(nodes * kDijkstraDegree);
+    for (auto& edge : edges) {
+        edge = Edge { nodeDist(rng), weightDist(rng) };
+    }
+    return edges;
+}
+
+using Distance = std::uint64_t;
+inline constexpr Distance kUnreached { std::numeric_limits<Distance>::max() };
+
+static void BM_DijkstraLazyDeletion(benchmark::State& state) {
+    const auto nodes { static_cast<std::size_t>(state.range(0)) };
+    const std::vector<Edge> edges { makeGraph(nodes) };
+    std::size_t peakSize {};
+    for ([[maybe_unused]] auto _ : state) {
+        std::vector<Distance> distances(nodes, kUnreached);
+        systems_dsa::binary_heap<std::pair<Distance, std::uint32_t>, std::greater<>> heap {};
+        distances[0] = 0;
+        heap.push({ 0, 0 });
+        while (!heap.empty()) {
+            peakSize = std::max(peakSize, heap.size());
+            const auto [distance, node] { heap.top() };
+            heap.pop();
+            if (distance != distances[node]) {
+                continue; // Stale, the node was reached by a shorter path since
+            }
+            for (std::size_t e { node * kDijkstraDegree }; e < (node + 1) * kDijkstraDegree; ++e) {
+                const Distance candidate { distance + edges[e].weight };
+                if (candidate < distances[edges[e].to]) {
+                    distances[edges[e].to] = candidate;
+                    heap.push({ candidate, edges[e].to });
+                }
+            }
+        }
+        benchmark::DoNotOptimize(distances.data());
+    }
+    state.counters["peak_heap_size"] = static_cast<double>(peakSize);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_DijkstraIndexed(benchmark::State& state) {
+    using Heap = systems_dsa::indexed_binary_heap<std::pair<Distance, std::uint32_t>, std::greater<>>;
+    const auto nodes { static_cast<std::size_t>(state.range(0)) };
+    const std::vector<Edge> edges { makeGraph(nodes) };
+    std::size_t peakSize {};
+    for ([[maybe_unused]] auto _ : state) {
+        std::vector<Distance> distances(nodes, kUnreached);
+        std::vector<Heap::handle> handles(nodes);
+        Heap heap {};
+        distances[0] = 0;
+        handles[0] = heap.push({ 0, 0 });
+        while (!heap.empty()) {
+            peakSize = std::max(peakSize, heap.size());
+            const auto [distance, node] { heap.top() };
+            heap.pop();
+            for (std::size_t e { node * kDijkstraDegree }; e < (node + 1) * kDijkstraDegree; ++e) {
+                const Distance candidate { distance + edges[e].weight };
+                const std::uint32_t to { edges[e].to };
+                if (candidate < distances[to]) {
+                    // Only unsettled nodes can improve, and those are either queued already or not yet reached
+                    if (distances[to] == kUnreached) {
+                        handles[to] = heap.push({ candidate, to });
+                    } else {
+                        heap.update(handles[to], { candidate, to });
+                    }
+                    distances[to] = candidate;
+                }
+            }
+        }
+        benchmark::DoNotOptimize(distances.data());
+    }
+    state.counters["peak_heap_size"] = static_cast<double>(peakSize);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_DijkstraLazyDeletion)->RangeMultiplier(8)->Range(1 << 10, kDijkstraMaxNodes);
+BENCHMARK(BM_DijkstraIndexed)->RangeMultiplier(8)->Range(1 << 10, kDijkstraMaxNodes);
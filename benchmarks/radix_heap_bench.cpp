@@ -0,0 +1,101 @@
+#include "bench_utils.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <systems_dsa/binary_heap.hpp>
+#include <systems_dsa/radix_heap.hpp>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Monotone event queues: binary_heap as a min-heap on the key against radix_heap, for uint64_t and double timestamps.
+// 1K - 1M pending events in Release.
+// -----------------------------------------------------------------------------
+#ifdef NDEBUG
+inline constexpr std::int64_t kEventQueueMaxElements { 1'000'000 };
+inline constexpr std::size_t kEventQueueOps { 1 << 16 };
+#else
+inline constexpr std::int64_t kEventQueueMaxElements { 1 << 10 };
+inline constexpr std::size_t kEventQueueOps { 1 << 6 };
+#endif
+
+template <typename Key>
+struct EventLater {
+    bool operator()(const std::pair<Key, int>& lhs, const std::pair<Key, int>& rhs) const {
+        return lhs.first > rhs.first;
+    }
+};
+
+// Both expose push({ key, value }) / top() / pop(); only radix_heap's top() is non-const
+template <typename Key>
+using BinaryEventQueue = systems_dsa::binary_heap<std::pair<Key, int>, EventLater<Key>>;
+template <typename Key>
+using RadixEventQueue = systems_dsa::radix_heap<Key, int>;
+
+template <typename Key>
+static std::vector<Key> makeDelays(std::size_t n, std::uint64_t seed) {
+    std::mt19937_64 rng { seed };
+    std::vector<Key> delays {};
+    delays.reserve(n);
+    for (std::size_t i {}; i < n; ++i) {
+        // Up to ~1M ticks ahead, as a simulator scheduling timers of mixed lengths
+        if constexpr (std::is_floating_point_v<Key>) {
+            delays.push_back(std::uniform_real_distribution<Key> { 0, 1'000'000 }(rng));
+        } else {
+            delays.push_back(std::uniform_int_distribution<Key> { 0, 1'000'000 }(rng));
+        }
+    }
+    return delays;
+}
+
+// The hold model: pop the earliest event and schedule a new one a random delay after it, so n events stay pending
+template <typename Queue, typename Key>
+static void BM_EventQueueHold(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const std::vector<Key> initial { makeDelays<Key>(n, kBenchSeed) };
+    const std::vector<Key> delays { makeDelays<Key>(kEventQueueOps, kBenchSeed + 1) };
+    Queue queue {};
+    for (const Key time : initial) {
+        queue.push({ time, 0 });
+    }
+    for ([[maybe_unused]] auto _ : state) {
+        for (const Key delay : delays) {
+            const Key now { queue.top().first };
+            queue.pop();
+            queue.push({ now + delay, 0 });
+        }
+        benchmark::DoNotOptimize(queue.top());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kEventQueueOps));
+}
+
+// Schedule n events, then run them all in time order
+template <typename Queue, typename Key>
+static void BM_EventQueueLoadDrain(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const std::vector<Key> times { makeDelays<Key>(n, kBenchSeed) };
+    for ([[maybe_unused]] auto _ : state) {
+        Queue queue {};
+        for (const Key time : times) {
+            queue.push({ time, 0 });
+        }
+        while (!queue.empty()) {
+            benchmark::DoNotOptimize(queue.top());
+            queue.pop();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#define SYSTEMS_DSA_EVENT_QUEUE_BENCH(fn)                                                                          \
+    BENCHMARK_TEMPLATE(fn, BinaryEventQueue<std::uint64_t>, std::uint64_t)                                       \
+        ->RangeMultiplier(10)->Range(1'000, kEventQueueMaxElements);                                             \
+    BENCHMARK_TEMPLATE(fn, RadixEventQueue<std::uint64_t>, std::uint64_t)                                        \
+        ->RangeMultiplier(10)->Range(1'000, kEventQueueMaxElements);                                             \
+    BENCHMARK_TEMPLATE(fn, BinaryEventQueue<double>, double)->RangeMultiplier(10)->Range(1'000, kEventQueueMaxElements); \
+    BENCHMARK_TEMPLATE(fn, RadixEventQueue<double>, double)->RangeMultiplier(10)->Range(1'000, kEventQueueMaxElements)
+
+SYSTEMS_DSA_EVENT_QUEUE_BENCH(BM_EventQueueHold);
+SYSTEMS_DSA_EVENT_QUEUE_BENCH(BM_EventQueueLoadDrain);
@@ -0,0 +1,49 @@
+#include "alloc_counter.hpp"
+#include "bench_utils.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+#include <systems_dsa/small_vector.hpp>
+#include <systems_dsa/vector.hpp>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Short-lived vectors with a handful of elements, the per-request pattern small_vector is for: each iteration
+// creates, fills and destroys kShortLivedVectors vectors of n elements. small_vector<T, 8> stays inline up to 8.
+// -----------------------------------------------------------------------------
+inline constexpr std::size_t kShortLivedVectors { 1'000 };
+
+template <typename Vec>
+static void BM_ShortLivedVectors(benchmark::State& state) {
+    using value_type = typename Vec::value_type;
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const value_type value {};
+    AllocationScope scope {};
+    for ([[maybe_unused]] auto _ : state) {
+        for (std::size_t v {}; v < kShortLivedVectors; ++v) {
+            Vec vec {};
+            for (std::size_t i {}; i < n; ++i) {
+                vec.push_back(value);
+            }
+            benchmark::DoNotOptimize(vec.size());
+            benchmark::ClobberMemory();
+        }
+    }
+    // Per short-lived vector, whatever allocations its elements make themselves included
+    state.counters["allocs_per_vector"] = static_cast<double>(scope.count())
+        / static_cast<double>(state.iterations() * kShortLivedVectors);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kShortLivedVectors));
+}
+
+static void shortLivedSizes(benchmark::internal::Benchmark* bench) {
+    for (std::int64_t n : { 1, 4, 8, 16 }) {
+        bench->Arg(n);
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_ShortLivedVectors, systems_dsa::vector<int>)->Apply(shortLivedSizes);
+BENCHMARK_TEMPLATE(BM_ShortLivedVectors, systems_dsa::small_vector<int, 8>)->Apply(shortLivedSizes);
+BENCHMARK_TEMPLATE(BM_ShortLivedVectors, std::vector<int>)->Apply(shortLivedSizes);
+BENCHMARK_TEMPLATE(BM_ShortLivedVectors, systems_dsa::vector<std::string>)->Apply(shortLivedSizes);
+BENCHMARK_TEMPLATE(BM_ShortLivedVectors, systems_dsa::small_vector<std::string, 8>)->Apply(shortLivedSizes);
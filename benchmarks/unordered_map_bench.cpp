@@ -0,0 +1,607 @@
+#include "alloc_counter.hpp"
+#include "bench_utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <memory_resource>
+#include <numeric>
+#include <span>
+#include <string>
+#include <string_view>
+#include <systems_dsa/unordered_map.hpp>
+#include <thread>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Bucket policy: modulo vs power-of-two mask
+// -----------------------------------------------------------------------------
+template <typename K, typename Policy>
+using PolicyMap = systems_dsa::unordered_map<K, int, std::hash<K>, std::equal_to<K>, Policy>;
+
+template <typename K>
+static std::vector<K> makeKeys(std::size_t n, std::uint64_t seed) {
+    if constexpr (std::is_same_v<K, std::string>) {
+        return makeRandomStrings(n, 16, seed);
+    } else {
+        return makeRandomInts(n, seed);
+    }
+}
+
+template <typename K, typename Policy>
+static void BM_UnorderedMapInsert(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const auto keys { makeKeys<K>(n, kBenchSeed) };
+
+    for ([[maybe_unused]] auto _ : state) {
+        PolicyMap<K, Policy> hashMap {};
+        for (const auto& key : keys) {
+            hashMap.insert(key, 1);
+        }
+        benchmark::DoNotOptimize(hashMap.size());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+template <typename K, typename Policy>
+static void BM_UnorderedMapFindHit(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const auto keys { makeKeys<K>(n, kBenchSeed) };
+    PolicyMap<K, Policy> hashMap {};
+    for (const auto& key : keys) {
+        hashMap.insert(key, 1);
+    }
+
+    for ([[maybe_unused]] auto _ : state) {
+        for (const auto& key : keys) {
+            benchmark::DoNotOptimize(hashMap.find(key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+template <typename K, typename Policy>
+static void BM_UnorderedMapFindMiss(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const auto keys { makeKeys<K>(n, kBenchSeed) };
+    const auto missingKeys { makeKeys<K>(n, kBenchSeed + 1) };
+    PolicyMap<K, Policy> hashMap {};
+    for (const auto& key : keys) {
+        hashMap.insert(key, 1);
+    }
+
+    for ([[maybe_unused]] auto _ : state) {
+        for (const auto& key : missingKeys) {
+            benchmark::DoNotOptimize(hashMap.contains(key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+#define SYSTEMS_DSA_POLICY_BENCH(fn, key)                                                          \
+    BENCHMARK_TEMPLATE(fn, key, systems_dsa::modulo_bucket_policy)                                 \
+        ->RangeMultiplier(16)                                                                      \
+        ->Range(1 << 8, kBenchMaxElements);                                                        \
+    BENCHMARK_TEMPLATE(fn, key, systems_dsa::power_of_two_bucket_policy)                           \
+        ->RangeMultiplier(16)                                                                      \
+        ->Range(1 << 8, kBenchMaxElements)
+
+SYSTEMS_DSA_POLICY_BENCH(BM_UnorderedMapInsert, int);
+SYSTEMS_DSA_POLICY_BENCH(BM_UnorderedMapInsert, std::string);
+SYSTEMS_DSA_POLICY_BENCH(BM_UnorderedMapFindHit, int);
+SYSTEMS_DSA_POLICY_BENCH(BM_UnorderedMapFindHit, std::string);
+SYSTEMS_DSA_POLICY_BENCH(BM_UnorderedMapFindMiss, int);
+SYSTEMS_DSA_POLICY_BENCH(BM_UnorderedMapFindMiss, std::string);
+
+// -----------------------------------------------------------------------------
+// Batched lookup: loop of find vs find_batch. The largest sizes exceed the LLC.
+// Each iteration looks up the next kLookupBatch keys of a large random pool, so lookups stay cold.
+// -----------------------------------------------------------------------------
+constexpr std::size_t kLookupBatch { 1024 };
+constexpr std::size_t kLookupPool { 1 << 20 };
+
+struct LookupFixture {
+    systems_dsa::unordered_map<int, int> hashMap {};
+    std::vector<int> probeKeys {};
+    std::vector<systems_dsa::unordered_map<int, int>::iterator> results {};
+
+    explicit LookupFixture(std::size_t n) {
+        const auto keys { makeRandomInts(n) };
+        hashMap.reserve(n);
+        for (const auto& key : keys) {
+            hashMap.insert(key, 1);
+        }
+        const auto picks { makeRandomInts(kLookupPool, kBenchSeed + 2) };
+        probeKeys.resize(kLookupPool);
+        for (std::size_t i {}; i < kLookupPool; ++i) {
+            probeKeys[i] = keys[static_cast<std::size_t>(picks[i]) % n];
+        }
+        results.resize(kLookupBatch);
+    }
+
+    std::span<const int> nextBatch(std::size_t& offset) const {
+        offset = (offset + kLookupBatch) % kLookupPool;
+        return { probeKeys.data() + offset, kLookupBatch };
+    }
+};
+
+static void BM_UnorderedMapFindLoop(benchmark::State& state) {
+    LookupFixture fixture { static_cast<std::size_t>(state.range(0)) };
+    std::size_t offset {};
+
+    for ([[maybe_unused]] auto _ : state) {
+        const auto batch { fixture.nextBatch(offset) };
+        for (std::size_t i {}; i < batch.size(); ++i) {
+            fixture.results[i] = fixture.hashMap.find(batch[i]);
+        }
+        benchmark::DoNotOptimize(fixture.results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kLookupBatch));
+}
+
+static void BM_UnorderedMapFindBatch(benchmark::State& state) {
+    LookupFixture fixture { static_cast<std::size_t>(state.range(0)) };
+    std::size_t offset {};
+
+    for ([[maybe_unused]] auto _ : state) {
+        fixture.hashMap.find_batch(fixture.nextBatch(offset), fixture.results);
+        benchmark::DoNotOptimize(fixture.results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kLookupBatch));
+}
+
+BENCHMARK(BM_UnorderedMapFindLoop)->RangeMultiplier(16)->Range(1 << 10, kBenchMaxElements);
+BENCHMARK(BM_UnorderedMapFindBatch)->RangeMultiplier(16)->Range(1 << 10, kBenchMaxElements);
+
+// -----------------------------------------------------------------------------
+// Probe policy under churn: tombstones vs Robin Hood with backward-shift deletion.
+// A session-table workload: n live keys, every operation retires the oldest key and adds a new one.
+// The counters describe the table after n operations: displacement of each live key from its home bucket, the
+// share of buckets lost to tombstones, and the bucket count the table grew to.
+// -----------------------------------------------------------------------------
+template <typename Probe>
+using ProbeMap = systems_dsa::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+    systems_dsa::modulo_bucket_policy, Probe>;
+
+// Key stream of a churn run: keys [0, n) are live initially, op i retires keys[i] and adds keys[n + i]
+static std::vector<int> makeChurnKeys(std::size_t n) {
+    return makeRandomInts(3 * n, kBenchSeed + 3);
+}
+
+template <typename Probe>
+static ProbeMap<Probe> makeChurnedMap(const std::vector<int>& keys, std::size_t n) {
+    ProbeMap<Probe> hashMap {};
+    for (std::size_t i {}; i < n; ++i) {
+        hashMap.insert(keys[i], 1);
+    }
+    for (std::size_t i {}; i < n; ++i) {
+        hashMap.erase(keys[i]);
+        hashMap.insert(keys[n + i], 1);
+    }
+    return hashMap;
+}
+
+template <typename Probe>
+static void reportProbeCounters(benchmark::State& state, const ProbeMap<Probe>& hashMap) {
+    const std::size_t bucketCount { hashMap.bucket_count() };
+    std::vector<std::size_t> displacements {};
+    for (const auto& pair : hashMap) {
+        const std::size_t home { systems_dsa::modulo_bucket_policy::index(std::hash<int> {}(pair.first), bucketCount) };
+        displacements.push_back((hashMap.bucket(pair.first) + bucketCount - home) % bucketCount);
+    }
+    std::sort(displacements.begin(), displacements.end());
+    state.counters["mean_disp"] = static_cast<double>(std::accumulate(displacements.begin(), displacements.end(), std::size_t {}))
+        / static_cast<double>(displacements.size());
+    state.counters["p99_disp"] = static_cast<double>(displacements[(displacements.size() - 1) * 99 / 100]);
+    state.counters["max_disp"] = static_cast<double>(displacements.back());
+    const double tombstones { std::round(hashMap.load_factor() * static_cast<double>(bucketCount)) - static_cast<double>(hashMap.size()) };
+    state.counters["tombstone_ratio"] = tombstones / static_cast<double>(bucketCount);
+    state.counters["buckets"] = static_cast<double>(bucketCount);
+}
+
+template <typename Probe>
+static void BM_UnorderedMapChurn(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const auto keys { makeChurnKeys(n) };
+    ProbeMap<Probe> hashMap {};
+
+    for ([[maybe_unused]] auto _ : state) {
+        state.PauseTiming();
+        hashMap = ProbeMap<Probe> {};
+        for (std::size_t i {}; i < n; ++i) {
+            hashMap.insert(keys[i], 1);
+        }
+        state.ResumeTiming();
+        for (std::size_t i {}; i < n; ++i) {
+            hashMap.erase(keys[i]);
+            hashMap.insert(keys[n + i], 1);
+        }
+        benchmark::DoNotOptimize(hashMap.size());
+    }
+    reportProbeCounters(state, hashMap);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+// Misses walk the whole run (linear probing: up to an OPEN Group), which is where leftover tombstones cost the most
+template <typename Probe>
+static void BM_UnorderedMapChurnedFindMiss(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const auto keys { makeChurnKeys(n) };
+    const auto hashMap { makeChurnedMap<Probe>(keys, n) };
+
+    for ([[maybe_unused]] auto _ : state) {
+        for (std::size_t i { 2 * n }; i < 3 * n; ++i) {
+            benchmark::DoNotOptimize(hashMap.contains(keys[i]));
+        }
+    }
+    reportProbeCounters(state, hashMap);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+BENCHMARK_TEMPLATE(BM_UnorderedMapChurn, systems_dsa::linear_probe_policy)->RangeMultiplier(16)->Range(1 << 10, kBenchMaxElements);
+BENCHMARK_TEMPLATE(BM_UnorderedMapChurn, systems_dsa::robin_hood_probe_policy)->RangeMultiplier(16)->Range(1 << 10, kBenchMaxElements);
+BENCHMARK_TEMPLATE(BM_UnorderedMapChurnedFindMiss, systems_dsa::linear_probe_policy)->RangeMultiplier(16)->Range(1 << 10, kBenchMaxElements);
+BENCHMARK_TEMPLATE(BM_UnorderedMapChurnedFindMiss, systems_dsa::robin_hood_probe_policy)->RangeMultiplier(16)->Range(1 << 10, kBenchMaxElements);
+
+// -----------------------------------------------------------------------------
+// Heterogeneous lookup: string_view keys against a std::string map.
+// Keys are 32 chars, past any small-string buffer, and the queries are views into a single buffer, as they would be
+// when parsed out of a request. Without transparent hashing each lookup has to materialize a std::string first.
+// -----------------------------------------------------------------------------
+constexpr std::size_t kViewKeyLength { 32 };
+
+using MaterializingStringMap = systems_dsa::unordered_map<std::string, int>;
+using TransparentStringMap = systems_dsa::unordered_map<std::string, int, systems_dsa::string_hash, std::equal_to<>>;
+
+static std::string makeViewBuffer(std::size_t n) {
+    std::string buffer {};
+    buffer.reserve(n * kViewKeyLength);
+    for (const auto& key : makeRandomStrings(n, kViewKeyLength, kBenchSeed + 4)) {
+        buffer += key;
+    }
+    return buffer;
+}
+
+static std::vector<std::string_view> makeViews(const std::string& buffer, std::size_t n) {
+    std::vector<std::string_view> views {};
+    views.reserve(n);
+    for (std::size_t i {}; i < n; ++i) {
+        views.emplace_back(buffer.data() + i * kViewKeyLength, kViewKeyLength);
+    }
+    return views;
+}
+
+template <typename Map>
+static Map makeViewMap(std::span<const std::string_view> views) {
+    Map hashMap {};
+    for (const auto view : views) {
+        hashMap.insert(std::string { view }, 1);
+    }
+    return hashMap;
+}
+
+static void reportAllocations(benchmark::State& state, const AllocationScope& scope, std::size_t opsPerIteration) {
+    state.counters["allocs_per_op"] = static_cast<double>(scope.count())
+        / static_cast<double>(state.iterations() * opsPerIteration);
+}
+
+static void BM_UnorderedMapViewFindMaterialized(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const auto buffer { makeViewBuffer(n) };
+    const auto views { makeViews(buffer, n) };
+    const auto hashMap { makeViewMap<MaterializingStringMap>(views) };
+
+    const AllocationScope scope {};
+    for ([[maybe_unused]] auto _ : state) {
+        for (const auto view : views) {
+            benchmark::DoNotOptimize(hashMap.find(std::string { view }));
+        }
+    }
+    reportAllocations(state, scope, n);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+static void BM_UnorderedMapViewFindTransparent(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const auto buffer { makeViewBuffer(n) };
+    const auto views { makeViews(buffer, n) };
+    const auto hashMap { makeViewMap<TransparentStringMap>(views) };
+
+    const AllocationScope scope {};
+    for ([[maybe_unused]] auto _ : state) {
+        for (const auto view : views) {
+            benchmark::DoNotOptimize(hashMap.find(view));
+        }
+    }
+    reportAllocations(state, scope, n);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+// Upsert where every key is already present: operator[] on a materialized key vs try_emplace on the view
+static void BM_UnorderedMapViewUpsertMaterialized(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const auto buffer { makeViewBuffer(n) };
+    const auto views { makeViews(buffer, n) };
+    auto hashMap { makeViewMap<MaterializingStringMap>(views) };
+
+    const AllocationScope scope {};
+    for ([[maybe_unused]] auto _ : state) {
+        for (const auto view : views) {
+            ++hashMap[std::string { view }];
+        }
+    }
+    reportAllocations(state, scope, n);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+static void BM_UnorderedMapViewUpsertTransparent(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const auto buffer { makeViewBuffer(n) };
+    const auto views { makeViews(buffer, n) };
+    auto hashMap { makeViewMap<TransparentStringMap>(views) };
+
+    const AllocationScope scope {};
+    for ([[maybe_unused]] auto _ : state) {
+        for (const auto view : views) {
+            ++hashMap.try_emplace(view, 0).first->second;
+        }
+    }
+    reportAllocations(state, scope, n);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+BENCHMARK(BM_UnorderedMapViewFindMaterialized)->RangeMultiplier(16)->Range(1 << 10, kBenchMaxElements);
+BENCHMARK(BM_UnorderedMapViewFindTransparent)->RangeMultiplier(16)->Range(1 << 10, kBenchMaxElements);
+BENCHMARK(BM_UnorderedMapViewUpsertMaterialized)->RangeMultiplier(16)->Range(1 << 10, kBenchMaxElements);
+BENCHMARK(BM_UnorderedMapViewUpsertTransparent)->RangeMultiplier(16)->Range(1 << 10, kBenchMaxElements);
+
+// -----------------------------------------------------------------------------
+// Heavy values: building a value_type and moving it into the bucket vs constructing it in place.
+// A 256 byte value is as expensive to move as to copy, so the temporary costs a full extra copy per insert.
+// -----------------------------------------------------------------------------
+struct HeavyValue {
+    std::array<std::uint64_t, 32> words {};
+
+    explicit HeavyValue(std::uint64_t seed) {
+        for (auto& word : words) {
+            word = seed++;
+        }
+    }
+};
+
+using HeavyMap = systems_dsa::unordered_map<int, HeavyValue>;
+
+static void BM_UnorderedMapHeavyInsertTemporary(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const auto keys { makeRandomInts(n) };
+
+    for ([[maybe_unused]] auto _ : state) {
+        HeavyMap hashMap { n * 2 };
+        for (const int key : keys) {
+            hashMap.insert(std::pair<const int, HeavyValue> { key, HeavyValue { static_cast<std::uint64_t>(key) } });
+        }
+        benchmark::DoNotOptimize(hashMap.size());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+static void BM_UnorderedMapHeavyTryEmplace(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const auto keys { makeRandomInts(n) };
+
+    for ([[maybe_unused]] auto _ : state) {
+        HeavyMap hashMap { n * 2 };
+        for (const int key : keys) {
+            hashMap.try_emplace(key, static_cast<std::uint64_t>(key));
+        }
+        benchmark::DoNotOptimize(hashMap.size());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+BENCHMARK(BM_UnorderedMapHeavyInsertTemporary)->RangeMultiplier(16)->Range(1 << 10, kBenchMaxElements);
+BENCHMARK(BM_UnorderedMapHeavyTryEmplace)->RangeMultiplier(16)->Range(1 << 10, kBenchMaxElements);
+
+// -----------------------------------------------------------------------------
+// Hash cache policy on long string keys: rehash reuses the cached hashes instead of rehashing every key, and a miss
+// only compares keys whose full hash matches.
+// -----------------------------------------------------------------------------
+constexpr std::size_t kLongKeyLength { 64 };
+// 64-char keys are ~100 bytes each with their node, cap the sizes so the largest run stays well within memory
+inline constexpr std::int64_t kLongKeyMaxElements { std::min<std::int64_t>(kBenchMaxElements, 1 << 20) };
+
+template <typename HashCachePolicy>
+using LongKeyMap = systems_dsa::unordered_map<std::string, int, std::hash<std::string>, std::equal_to<std::string>,
+    systems_dsa::modulo_bucket_policy, systems_dsa::linear_probe_policy, HashCachePolicy>;
+
+template <typename HashCachePolicy>
+static LongKeyMap<HashCachePolicy> makeLongKeyMap(const std::vector<std::string>& keys) {
+    LongKeyMap<HashCachePolicy> hashMap {};
+    for (const auto& key : keys) {
+        hashMap.insert(key, 1);
+    }
+    return hashMap;
+}
+
+template <typename HashCachePolicy>
+static void BM_UnorderedMapLongKeyRehash(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const auto keys { makeRandomStrings(n, kLongKeyLength, kBenchSeed + 5) };
+
+    for ([[maybe_unused]] auto _ : state) {
+        state.PauseTiming();
+        auto hashMap { makeLongKeyMap<HashCachePolicy>(keys) };
+        state.ResumeTiming();
+        hashMap.rehash(hashMap.bucket_count() * 2);
+        benchmark::DoNotOptimize(hashMap.bucket_count());
+        state.PauseTiming();
+        hashMap = LongKeyMap<HashCachePolicy> {};
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+template <typename HashCachePolicy>
+static void BM_UnorderedMapLongKeyFindMiss(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const auto keys { makeRandomStrings(n, kLongKeyLength, kBenchSeed + 5) };
+    const auto missingKeys { makeRandomStrings(n, kLongKeyLength, kBenchSeed + 6) };
+    const auto hashMap { makeLongKeyMap<HashCachePolicy>(keys) };
+
+    for ([[maybe_unused]] auto _ : state) {
+        for (const auto& key : missingKeys) {
+            benchmark::DoNotOptimize(hashMap.contains(key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+BENCHMARK_TEMPLATE(BM_UnorderedMapLongKeyRehash, systems_dsa::no_hash_cache_policy)->RangeMultiplier(16)->Range(1 << 10, kLongKeyMaxElements);
+BENCHMARK_TEMPLATE(BM_UnorderedMapLongKeyRehash, systems_dsa::cache_hash_policy)->RangeMultiplier(16)->Range(1 << 10, kLongKeyMaxElements);
+BENCHMARK_TEMPLATE(BM_UnorderedMapLongKeyFindMiss, systems_dsa::no_hash_cache_policy)->RangeMultiplier(16)->Range(1 << 10, kLongKeyMaxElements);
+BENCHMARK_TEMPLATE(BM_UnorderedMapLongKeyFindMiss, systems_dsa::cache_hash_policy)->RangeMultiplier(16)->Range(1 << 10, kLongKeyMaxElements);
+
+// -----------------------------------------------------------------------------
+// Bulk build: one insert at a time, growing by doubling, vs the range constructor sizing the table once, vs the
+// parallel build on every hardware thread. 1M and 10M elements in Release.
+// -----------------------------------------------------------------------------
+using BuildMap = systems_dsa::unordered_map<int, int>;
+
+static std::vector<std::pair<int, int>> makeBuildPairs(std::size_t n) {
+    std::vector<std::pair<int, int>> pairs {};
+    pairs.reserve(n);
+    for (const int key : makeRandomInts(n, kBenchSeed + 8)) {
+        pairs.emplace_back(key, 1);
+    }
+    return pairs;
+}
+
+static void BM_UnorderedMapBuildInsertLoop(benchmark::State& state) {
+    const auto pairs { makeBuildPairs(static_cast<std::size_t>(state.range(0))) };
+    for ([[maybe_unused]] auto _ : state) {
+        BuildMap hashMap {};
+        for (const auto& [key, value] : pairs) {
+            hashMap.insert(key, value);
+        }
+        benchmark::DoNotOptimize(hashMap.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_UnorderedMapBuildRangeConstructor(benchmark::State& state) {
+    const auto pairs { makeBuildPairs(static_cast<std::size_t>(state.range(0))) };
+    for ([[maybe_unused]] auto _ : state) {
+        BuildMap hashMap(pairs.begin(), pairs.end());
+        benchmark::DoNotOptimize(hashMap.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_UnorderedMapBuildParallel(benchmark::State& state) {
+    const auto pairs { makeBuildPairs(static_cast<std::size_t>(state.range(0))) };
+    const std::size_t threads { std::max(1u, std::thread::hardware_concurrency()) };
+    for ([[maybe_unused]] auto _ : state) {
+        BuildMap hashMap {};
+        hashMap.insert_range(pairs, threads);
+        benchmark::DoNotOptimize(hashMap.size());
+    }
+    state.counters["threads"] = static_cast<double>(threads);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void buildSizes(benchmark::internal::Benchmark* bench) {
+    bench->Arg(std::min<std::int64_t>(1'000'000, kBenchMaxElements));
+    bench->Arg(std::min<std::int64_t>(10'000'000, kBenchMaxElements * 4));
+    bench->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK(BM_UnorderedMapBuildInsertLoop)->Apply(buildSizes);
+BENCHMARK(BM_UnorderedMapBuildRangeConstructor)->Apply(buildSizes);
+BENCHMARK(BM_UnorderedMapBuildParallel)->Apply(buildSizes);
+
+// -----------------------------------------------------------------------------
+// Allocator: default heap allocation vs a pmr map on a monotonic buffer. The buffer is sized by a dry run and reused
+// every iteration, so the arena map makes no heap allocations at all, and frees nothing until the arena is released.
+// String keys are 16 characters, too long for the small string buffer, so each key is its own allocation. Their
+// arena grows large, so they stop at a smaller size.
+// -----------------------------------------------------------------------------
+template <typename Map, typename Key>
+static void insertArenaKeys(Map& hashMap, const std::vector<Key>& keys) {
+    for (const auto& key : keys) {
+        if constexpr (std::is_same_v<Key, std::string>) {
+            hashMap.insert(std::pmr::string { key, hashMap.get_allocator() }, 1);
+        } else {
+            hashMap.insert(key, 1);
+        }
+    }
+}
+
+// Sums every allocation passed through it, with room for alignment padding
+class ByteCountingResource : public std::pmr::memory_resource {
+public:
+    std::size_t bytes {};
+
+private:
+    void* do_allocate(std::size_t size, std::size_t alignment) override {
+        bytes += size + alignment;
+        return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+    void do_deallocate(void* ptr, std::size_t size, std::size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(ptr, size, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+template <typename Key>
+using ArenaKey = std::conditional_t<std::is_same_v<Key, std::string>, std::pmr::string, Key>;
+
+template <typename Key>
+static void BM_UnorderedMapAllocDefault(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const auto keys { makeKeys<Key>(n, kBenchSeed + 9) };
+
+    const AllocationScope scope {};
+    for ([[maybe_unused]] auto _ : state) {
+        systems_dsa::unordered_map<Key, int> hashMap {};
+        for (const auto& key : keys) {
+            hashMap.insert(Key { key }, 1);
+        }
+        benchmark::DoNotOptimize(hashMap.size());
+    }
+    reportAllocations(state, scope, n);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+template <typename Key>
+static void BM_UnorderedMapAllocMonotonic(benchmark::State& state) {
+    using ArenaMap = systems_dsa::pmr::unordered_map<ArenaKey<Key>, int>;
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const auto keys { makeKeys<Key>(n, kBenchSeed + 9) };
+
+    ByteCountingResource counter {};
+    {
+        ArenaMap hashMap { &counter };
+        insertArenaKeys(hashMap, keys);
+    }
+    std::vector<std::byte> buffer(counter.bytes);
+
+    const AllocationScope scope {};
+    for ([[maybe_unused]] auto _ : state) {
+        // Anything that doesn't fit the buffer would throw instead of reaching the heap
+        std::pmr::monotonic_buffer_resource arena { buffer.data(), buffer.size(), std::pmr::null_memory_resource() };
+        ArenaMap hashMap { &arena };
+        insertArenaKeys(hashMap, keys);
+        benchmark::DoNotOptimize(hashMap.size());
+    }
+    reportAllocations(state, scope, n);
+    state.counters["arena_bytes"] = static_cast<double>(buffer.size());
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+BENCHMARK_TEMPLATE(BM_UnorderedMapAllocDefault, int)->RangeMultiplier(16)->Range(1 << 10, kBenchMaxElements);
+BENCHMARK_TEMPLATE(BM_UnorderedMapAllocMonotonic, int)->RangeMultiplier(16)->Range(1 << 10, kBenchMaxElements);
+BENCHMARK_TEMPLATE(BM_UnorderedMapAllocDefault, std::string)->RangeMultiplier(16)->Range(1 << 10, std::max<std::int64_t>(1 << 10, kBenchMaxElements / 16));
+BENCHMARK_TEMPLATE(BM_UnorderedMapAllocMonotonic, std::string)->RangeMultiplier(16)->Range(1 << 10, std::max<std::int64_t>(1 << 10, kBenchMaxElements / 16));
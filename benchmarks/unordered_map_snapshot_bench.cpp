@@ -0,0 +1,82 @@
+#include "bench_utils.hpp"
+
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <systems_dsa/unordered_map_snapshot.hpp>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Startup: rebuilding a lookup table by inserting every entry vs mapping a snapshot of it.
+// The snapshot is read from the page cache, so this measures the CPU side of startup, not the disk.
+// -----------------------------------------------------------------------------
+using StartupMap = systems_dsa::unordered_map<std::uint64_t, std::uint64_t>;
+using StartupSnapshot = systems_dsa::unordered_map_snapshot<std::uint64_t, std::uint64_t>;
+
+static std::vector<std::uint64_t> makeStartupKeys(std::size_t n) {
+    std::vector<std::uint64_t> keys {};
+    keys.reserve(n);
+    for (const int key : makeRandomInts(n, kBenchSeed + 7)) {
+        keys.push_back(static_cast<std::uint64_t>(key));
+    }
+    return keys;
+}
+
+static std::filesystem::path writeStartupSnapshot(const std::vector<std::uint64_t>& keys) {
+    StartupMap hashMap {};
+    for (const auto key : keys) {
+        hashMap.insert(key, key + 1);
+    }
+    auto path { std::filesystem::temp_directory_path()
+        / ("systems_dsa_bench_" + std::to_string(keys.size()) + ".snapshot") };
+    StartupSnapshot::write(hashMap, path);
+    return path;
+}
+
+static void BM_UnorderedMapStartupInsert(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const auto keys { makeStartupKeys(n) };
+
+    for ([[maybe_unused]] auto _ : state) {
+        StartupMap hashMap {};
+        for (const auto key : keys) {
+            hashMap.insert(key, key + 1);
+        }
+        benchmark::DoNotOptimize(hashMap.find(keys.front()));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+// Open plus one lookup, the point at which the rebuilt map above is ready to serve
+static void BM_UnorderedMapStartupSnapshot(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const auto keys { makeStartupKeys(n) };
+    const auto path { writeStartupSnapshot(keys) };
+
+    for ([[maybe_unused]] auto _ : state) {
+        const auto snapshot { StartupSnapshot::open(path) };
+        benchmark::DoNotOptimize(snapshot.find(keys.front()));
+    }
+    state.counters["file_mb"] = static_cast<double>(std::filesystem::file_size(path)) / (1024.0 * 1024.0);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+    std::filesystem::remove(path);
+}
+
+// Open, then look up every key once: includes faulting in every page of the snapshot
+static void BM_UnorderedMapStartupSnapshotFindAll(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const auto keys { makeStartupKeys(n) };
+    const auto path { writeStartupSnapshot(keys) };
+
+    for ([[maybe_unused]] auto _ : state) {
+        const auto snapshot { StartupSnapshot::open(path) };
+        for (const auto key : keys) {
+            benchmark::DoNotOptimize(snapshot.find(key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+    std::filesystem::remove(path);
+}
+
+BENCHMARK(BM_UnorderedMapStartupInsert)->RangeMultiplier(16)->Range(1 << 10, kBenchMaxElements)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_UnorderedMapStartupSnapshot)->RangeMultiplier(16)->Range(1 << 10, kBenchMaxElements)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_UnorderedMapStartupSnapshotFindAll)->RangeMultiplier(16)->Range(1 << 10, kBenchMaxElements)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,395 @@
+#include "alloc_counter.hpp"
+#include "bench_utils.hpp"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <systems_dsa/vector.hpp>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#ifdef SYSTEMS_DSA_BENCH_PARALLEL
+#include <execution>
+#include <numeric>
+#endif
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+// -----------------------------------------------------------------------------
+// push_back growth: trivially copyable elements are relocated with one memcpy per reallocation, the NonTrivial
+// variants have a user-provided move constructor and take the per-element path. 1K - 100M elements in Release,
+// the 64-byte elements stop at 10M (640MB).
+// -----------------------------------------------------------------------------
+#ifdef NDEBUG
+inline constexpr std::int64_t kGrowthMaxElements { 100'000'000 };
+#else
+inline constexpr std::int64_t kGrowthMaxElements { 10'000 };
+#endif
+
+struct Pod64 {
+    std::array<std::uint64_t, 8> words {};
+};
+static_assert(sizeof(Pod64) == 64 && systems_dsa::is_trivially_relocatable_v<Pod64>);
+
+template <typename T>
+struct NonTrivial {
+    T payload {};
+
+    NonTrivial() = default;
+    NonTrivial(const NonTrivial& other) noexcept : payload { other.payload } {}
+    NonTrivial(NonTrivial&& other) noexcept : payload { other.payload } {}
+    NonTrivial& operator=(const NonTrivial& other) = default;
+};
+static_assert(!systems_dsa::is_trivially_relocatable_v<NonTrivial<int>>);
+
+template <typename T>
+static void pushBackN(std::size_t n) {
+    systems_dsa::vector<T> vec {};
+    for (std::size_t i {}; i < n; ++i) {
+        vec.push_back(T {});
+    }
+    benchmark::DoNotOptimize(vec.size());
+    benchmark::ClobberMemory();
+}
+
+template <typename T>
+static void BM_VectorPushBackGrowth(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    // Untimed run first: glibc raises its mmap threshold as large blocks are freed, and without this, whichever
+    // benchmark runs first pays for fresh mmaps and page faults on every reallocation
+    pushBackN<T>(n);
+    for ([[maybe_unused]] auto _ : state) {
+        pushBackN<T>(n);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(sizeof(T)));
+}
+
+static void growthSizes(benchmark::internal::Benchmark* bench, std::int64_t maxElements) {
+    for (std::int64_t n { 1'000 }; n <= maxElements; n *= 10) {
+        bench->Arg(n);
+    }
+    bench->Unit(benchmark::kMicrosecond);
+}
+
+static void intGrowthSizes(benchmark::internal::Benchmark* bench) {
+    growthSizes(bench, kGrowthMaxElements);
+}
+
+static void podGrowthSizes(benchmark::internal::Benchmark* bench) {
+    growthSizes(bench, kGrowthMaxElements / 10);
+}
+
+BENCHMARK_TEMPLATE(BM_VectorPushBackGrowth, int)->Apply(intGrowthSizes);
+BENCHMARK_TEMPLATE(BM_VectorPushBackGrowth, NonTrivial<int>)->Apply(intGrowthSizes);
+BENCHMARK_TEMPLATE(BM_VectorPushBackGrowth, Pod64)->Apply(podGrowthSizes);
+BENCHMARK_TEMPLATE(BM_VectorPushBackGrowth, NonTrivial<Pod64>)->Apply(podGrowthSizes);
+
+// -----------------------------------------------------------------------------
+// Growth policies: allocations and footprint. The default 1.5x policy, doubling, size-class rounding, and
+// std::vector for reference. Sizes go through push_back one at a time, so every vector grows by its policy.
+// -----------------------------------------------------------------------------
+template <typename GrowthPolicy>
+using PolicyVector = systems_dsa::vector<int, std::allocator<int>, GrowthPolicy>;
+
+using OneAndHalfVector = PolicyVector<systems_dsa::one_and_half_growth_policy>;
+using DoublingVector = PolicyVector<systems_dsa::doubling_growth_policy>;
+using SizeClassVector = PolicyVector<systems_dsa::size_class_growth_policy>;
+
+// Resident set size of the process, 0 where /proc isn't available
+static std::size_t residentBytes() {
+#if defined(__linux__)
+    std::ifstream statm { "/proc/self/statm" };
+    std::size_t totalPages {};
+    std::size_t residentPages {};
+    statm >> totalPages >> residentPages;
+    return residentPages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
+
+// Hands freed heap memory back to the OS, so a resident set delta only counts what's still live
+static void releaseFreeHeap() {
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+}
+
+// One vector grown to n elements: reallocations per vector, and how much capacity is left unused
+template <typename Vec>
+static void BM_VectorGrowthAllocations(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    // Untimed run first, for the same mmap threshold reason as BM_VectorPushBackGrowth
+    {
+        Vec warmUp {};
+        for (std::size_t i {}; i < n; ++i) {
+            warmUp.push_back(static_cast<int>(i));
+        }
+        benchmark::DoNotOptimize(warmUp.size());
+    }
+    std::size_t capacity {};
+    std::size_t allocations {};
+    for ([[maybe_unused]] auto _ : state) {
+        AllocationScope scope {};
+        Vec vec {};
+        for (std::size_t i {}; i < n; ++i) {
+            vec.push_back(static_cast<int>(i));
+        }
+        allocations = scope.count();
+        capacity = vec.capacity();
+        benchmark::DoNotOptimize(vec.size());
+    }
+    state.counters["allocs_per_vector"] = static_cast<double>(allocations);
+    state.counters["capacity_per_element"] = static_cast<double>(capacity) / static_cast<double>(n);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void growthAllocationSizes(benchmark::internal::Benchmark* bench) {
+    for (std::int64_t n { 1'000 }; n <= kGrowthMaxElements / 10; n *= 10) {
+        bench->Arg(n);
+    }
+    bench->Unit(benchmark::kMicrosecond);
+}
+
+BENCHMARK_TEMPLATE(BM_VectorGrowthAllocations, OneAndHalfVector)->Apply(growthAllocationSizes);
+BENCHMARK_TEMPLATE(BM_VectorGrowthAllocations, DoublingVector)->Apply(growthAllocationSizes);
+BENCHMARK_TEMPLATE(BM_VectorGrowthAllocations, SizeClassVector)->Apply(growthAllocationSizes);
+BENCHMARK_TEMPLATE(BM_VectorGrowthAllocations, std::vector<int>)->Apply(growthAllocationSizes);
+
+// Many live vectors with sizes drawn uniformly from [0, 2 * average]. An average of 0 keeps them all empty, which
+// shows what default construction costs. The resident set is measured once, on a trimmed heap, before the timed runs.
+#ifdef NDEBUG
+inline constexpr std::size_t kFootprintVectors { 100'000 };
+#else
+inline constexpr std::size_t kFootprintVectors { 1'000 };
+#endif
+
+template <typename Vec>
+static std::vector<Vec> buildVectors(const std::vector<std::size_t>& sizes) {
+    std::vector<Vec> vectors(sizes.size());
+    for (std::size_t v {}; v < sizes.size(); ++v) {
+        for (std::size_t i {}; i < sizes[v]; ++i) {
+            vectors[v].push_back(static_cast<int>(i));
+        }
+    }
+    return vectors;
+}
+
+template <typename Vec>
+static void BM_VectorFootprint(benchmark::State& state) {
+    const auto average { static_cast<std::size_t>(state.range(0)) };
+    std::mt19937_64 rng { kBenchSeed };
+    std::uniform_int_distribution<std::size_t> dist { 0, 2 * average };
+    std::vector<std::size_t> sizes(kFootprintVectors);
+    std::size_t elements {};
+    for (auto& size : sizes) {
+        size = dist(rng);
+        elements += size;
+    }
+
+    releaseFreeHeap();
+    const std::size_t rssBefore { residentBytes() };
+    std::size_t allocations {};
+    std::size_t capacity {};
+    std::size_t rssAfter {};
+    {
+        AllocationScope scope {};
+        const auto vectors { buildVectors<Vec>(sizes) };
+        allocations = scope.count();
+        rssAfter = residentBytes();
+        for (const auto& vec : vectors) {
+            capacity += vec.capacity();
+        }
+    }
+
+    for ([[maybe_unused]] auto _ : state) {
+        auto vectors { buildVectors<Vec>(sizes) };
+        benchmark::DoNotOptimize(vectors.data());
+    }
+
+    const auto vectorCount { static_cast<double>(kFootprintVectors) };
+    // The outer std::vector's own block counts as one allocation
+    state.counters["allocs_per_vector"] = static_cast<double>(allocations - 1) / vectorCount;
+    state.counters["rss_bytes_per_vector"] = static_cast<double>(rssAfter > rssBefore ? rssAfter - rssBefore : 0) / vectorCount;
+    state.counters["capacity_per_element"] = elements > 0 ? static_cast<double>(capacity) / static_cast<double>(elements) : 0.0;
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(elements + kFootprintVectors));
+}
+
+static void footprintAverages(benchmark::internal::Benchmark* bench) {
+    for (std::int64_t average : { 0, 1, 16, 256 }) {
+        bench->Arg(average);
+    }
+    bench->Unit(benchmark::kMicrosecond);
+}
+
+BENCHMARK_TEMPLATE(BM_VectorFootprint, OneAndHalfVector)->Apply(footprintAverages);
+BENCHMARK_TEMPLATE(BM_VectorFootprint, DoublingVector)->Apply(footprintAverages);
+BENCHMARK_TEMPLATE(BM_VectorFootprint, SizeClassVector)->Apply(footprintAverages);
+BENCHMARK_TEMPLATE(BM_VectorFootprint, std::vector<int>)->Apply(footprintAverages);
+
+// -----------------------------------------------------------------------------
+// Batched ingestion: 256K records (64K in Debug) appended to one vector in batches of 4 - 64K, with a push_back per
+// record vs one append_range per batch. Records are 32-byte trivially copyable structs. The vector is cleared, not
+// freed, between iterations, so this measures the appends rather than page faults on fresh memory.
+// -----------------------------------------------------------------------------
+#ifdef NDEBUG
+inline constexpr std::size_t kIngestRecords { 1 << 18 };
+#else
+inline constexpr std::size_t kIngestRecords { 1 << 16 };
+#endif
+
+struct Record {
+    std::uint64_t key {};
+    std::uint64_t timestamp {};
+    double value {};
+    std::uint32_t source {};
+    std::uint32_t flags {};
+};
+static_assert(sizeof(Record) == 32 && std::is_trivially_copyable_v<Record>);
+
+static std::vector<Record> makeBatch(std::size_t size) {
+    std::vector<Record> batch(size);
+    for (std::size_t i {}; i < size; ++i) {
+        batch[i].key = i;
+        batch[i].timestamp = i * 3;
+    }
+    return batch;
+}
+
+static void BM_VectorIngestPushBack(benchmark::State& state) {
+    const auto batch { makeBatch(static_cast<std::size_t>(state.range(0))) };
+    systems_dsa::vector<Record> records {};
+    for ([[maybe_unused]] auto _ : state) {
+        records.clear();
+        for (std::size_t appended {}; appended < kIngestRecords; appended += batch.size()) {
+            for (const Record& record : batch) {
+                records.push_back(record);
+            }
+        }
+        benchmark::DoNotOptimize(records.size());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kIngestRecords));
+}
+
+static void BM_VectorIngestAppendRange(benchmark::State& state) {
+    const auto batch { makeBatch(static_cast<std::size_t>(state.range(0))) };
+    systems_dsa::vector<Record> records {};
+    for ([[maybe_unused]] auto _ : state) {
+        records.clear();
+        for (std::size_t appended {}; appended < kIngestRecords; appended += batch.size()) {
+            records.append_range(batch);
+        }
+        benchmark::DoNotOptimize(records.size());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kIngestRecords));
+}
+
+static void ingestBatchSizes(benchmark::internal::Benchmark* bench) {
+    for (std::int64_t size : { 4, 64, 1'024, 65'536 }) {
+        bench->Arg(size);
+    }
+    bench->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK(BM_VectorIngestPushBack)->Apply(ingestBatchSizes);
+BENCHMARK(BM_VectorIngestAppendRange)->Apply(ingestBatchSizes);
+
+// Insert a 64-record batch in the middle of n records, then erase it again
+template <typename Vec>
+static void BM_VectorInsertEraseMiddle(benchmark::State& state) {
+    const auto n { static_cast<std::size_t>(state.range(0)) };
+    const auto base { makeBatch(n) };
+    const auto batch { makeBatch(64) };
+    Vec records {};
+    records.assign(base.begin(), base.end());
+    const auto middle { static_cast<std::ptrdiff_t>(n / 2) };
+    for ([[maybe_unused]] auto _ : state) {
+        records.insert(records.begin() + middle, batch.begin(), batch.end());
+        records.erase(records.begin() + middle, records.begin() + middle + 64);
+        benchmark::DoNotOptimize(records.size());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_VectorInsertEraseMiddle, systems_dsa::vector<Record>)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_VectorInsertEraseMiddle, std::vector<Record>)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+// -----------------------------------------------------------------------------
+// Algorithms over the contiguous iterators, systems_dsa::vector vs std::vector: a range-for sum (auto-vectorized),
+// std::sort, and std::reduce / std::sort with std::execution::par_unseq when the parallel backend (TBB) is linked.
+// Sort re-assigns the same random input every iteration, the copy is included in both.
+// -----------------------------------------------------------------------------
+template <typename Vec>
+static Vec makeRandomVector(std::size_t n) {
+    const auto values { makeRandomInts(n) };
+    Vec vec {};
+    vec.assign(values.begin(), values.end());
+    return vec;
+}
+
+template <typename Vec>
+static void BM_VectorSum(benchmark::State& state) {
+    const auto vec { makeRandomVector<Vec>(static_cast<std::size_t>(state.range(0))) };
+    for ([[maybe_unused]] auto _ : state) {
+        unsigned sum {};
+        for (const int value : vec) {
+            sum += static_cast<unsigned>(value);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Vec>
+static void BM_VectorSort(benchmark::State& state) {
+    const auto values { makeRandomInts(static_cast<std::size_t>(state.range(0))) };
+    Vec vec {};
+    for ([[maybe_unused]] auto _ : state) {
+        vec.assign(values.begin(), values.end());
+        std::sort(vec.begin(), vec.end());
+        benchmark::DoNotOptimize(vec.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_VectorSum, systems_dsa::vector<int>)->RangeMultiplier(32)->Range(1 << 10, kBenchMaxElements);
+BENCHMARK_TEMPLATE(BM_VectorSum, std::vector<int>)->RangeMultiplier(32)->Range(1 << 10, kBenchMaxElements);
+BENCHMARK_TEMPLATE(BM_VectorSort, systems_dsa::vector<int>)->RangeMultiplier(32)->Range(1 << 10, kBenchMaxElements);
+BENCHMARK_TEMPLATE(BM_VectorSort, std::vector<int>)->RangeMultiplier(32)->Range(1 << 10, kBenchMaxElements);
+
+#ifdef SYSTEMS_DSA_BENCH_PARALLEL
+template <typename Vec>
+static void BM_VectorReduceParUnseq(benchmark::State& state) {
+    const auto vec { makeRandomVector<Vec>(static_cast<std::size_t>(state.range(0))) };
+    for ([[maybe_unused]] auto _ : state) {
+        const auto sum { std::reduce(std::execution::par_unseq, vec.begin(), vec.end(), 0u,
+            [](unsigned acc, unsigned value) { return acc + value; }) };
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Vec>
+static void BM_VectorSortParUnseq(benchmark::State& state) {
+    const auto values { makeRandomInts(static_cast<std::size_t>(state.range(0))) };
+    Vec vec {};
+    for ([[maybe_unused]] auto _ : state) {
+        vec.assign(values.begin(), values.end());
+        std::sort(std::execution::par_unseq, vec.begin(), vec.end());
+        benchmark::DoNotOptimize(vec.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_VectorReduceParUnseq, systems_dsa::vector<int>)->RangeMultiplier(32)->Range(1 << 10, kBenchMaxElements);
+BENCHMARK_TEMPLATE(BM_VectorReduceParUnseq, std::vector<int>)->RangeMultiplier(32)->Range(1 << 10, kBenchMaxElements);
+BENCHMARK_TEMPLATE(BM_VectorSortParUnseq, systems_dsa::vector<int>)->RangeMultiplier(32)->Range(1 << 10, kBenchMaxElements);
+BENCHMARK_TEMPLATE(BM_VectorSortParUnseq, std::vector<int>)->RangeMultiplier(32)->Range(1 << 10, kBenchMaxElements);
+#endif
@@ -1,5 +1,12 @@
 #pragma once
+#include <algorithm>
+#include <cassert>
 #include <functional>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <ranges>
 #include <systems_dsa/vector.hpp>
 
 #ifndef NDEBUG
@@ -10,8 +17,24 @@
 
 namespace systems_dsa {
 
-template <typename T, typename Compare = std::less<T>>
+template <typename T, typename Compare, typename Allocator, std::size_t Arity>
+class indexed_binary_heap;
+
+namespace detail {
+    // The sift routines report every index an element is moved into, for heaps that track element positions. Plain
+    // binary heaps don't.
+    struct ignore_placement {
+        constexpr void operator()(std::size_t) const noexcept {}
+    };
+}
+
+// Arity is the number of children per node. 2 is the classic binary heap; 4 and 8 cut the depth pop() descends to a
+// half and a third, and with small elements a node's children share a cache line, so large pop-heavy heaps get faster
+// at the cost of a few more comparisons per level.
+template <typename T, typename Compare = std::less<T>, typename Allocator = std::allocator<T>, std::size_t Arity = 2>
 class binary_heap {
+    static_assert(Arity >= 2, "A heap node needs at least two children");
+
 public:
     // =========================
     // Member type aliases
@@ -20,19 +43,35 @@ public:
     using value_type = T;
     using const_reference = const T&;
     using comparator_type = Compare;
+    using allocator_type = Allocator;
+    static constexpr size_type arity { Arity };
     // Higher priority: the element that does NOT come before others
 
     // =========================
     // Constructors / assignment
     // =========================
-    binary_heap() {
+    binary_heap() : binary_heap(Allocator()) {}
+
+    explicit binary_heap(const Allocator& alloc) : m_data(alloc) {
         m_data.reserve(10);
     }
 
-    binary_heap(size_type n) {
+    binary_heap(size_type n, const Allocator& alloc = Allocator()) : m_data(alloc) {
         m_data.reserve(n);
     }
 
+    // Copies [first, last) in one bulk append, then orders it with a single O(n) heapify
+    template <std::input_iterator It, std::sentinel_for<It> S>
+    binary_heap(It first, S last, const Allocator& alloc = Allocator()) : m_data(alloc) {
+        m_data.append_range(std::ranges::subrange(std::move(first), std::move(last)));
+        heapify();
+        BHEAP_ASSERT_VALID();
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return m_data.get_allocator();
+    }
+
     // =========================
     // Capacity (empty, size)
     // =========================
@@ -73,97 +112,184 @@ public:
     template <typename... Args>
     void emplace(Args&&... args) {
         m_data.emplace_back(std::forward<Args>(args)...);
-        siftUp();
+        siftUp(m_data.size() - 1);
         BHEAP_ASSERT_VALID();
     }
 
-    void pop() {
-        assert(!empty());
-        std::swap(m_data[0], m_data[m_data.size() - 1]);
-        m_data.pop_back();
-
-        size_type parentIndex { 0 };
-
-        auto priorityChildOpt { findPriorityChildIndex(parentIndex) };
-        if (!priorityChildOpt.has_value()) {
-            BHEAP_ASSERT_VALID();
-            return;
+    // Appends every element of `range` in bulk. When that at least doubles the heap, the whole heap is rebuilt with
+    // an O(n) heapify, otherwise each new element is sifted up like a push.
+    template <std::ranges::input_range R>
+    void push_range(R&& range) {
+        const size_type oldSize { m_data.size() };
+        m_data.append_range(std::forward<R>(range));
+        const size_type appended { m_data.size() - oldSize };
+        if (appended >= oldSize) {
+            heapify();
+        } else {
+            for (size_type i { oldSize }; i < m_data.size(); ++i) {
+                siftUp(i);
+            }
         }
-        size_type priorityChildIndex { priorityChildOpt.value() };
-
-        // Key Invariant: Parents must not compare as "before" in ordering
-        while (m_comp(m_data[parentIndex], m_data[priorityChildIndex])) {
-            std::swap(m_data[priorityChildIndex], m_data[parentIndex]);
-
-            // Update parent index
-            parentIndex = priorityChildIndex;
+        BHEAP_ASSERT_VALID();
+    }
 
-            // Update child index
-            priorityChildOpt = findPriorityChildIndex(parentIndex);
-            if (!priorityChildOpt.has_value()) break;
-            priorityChildIndex = priorityChildOpt.value();
-        }
+    // Bottom-up, see popTop()
+    void pop() {
+        assert(!empty());
+        popTop();
+        BHEAP_ASSERT_VALID();
+    }
 
+    // Moves the top element out and pops it, for callers that consume it (top() only gives const access)
+    value_type extract_top() {
+        assert(!empty());
+        // popTop() never reads the root before overwriting it, so the moved-from value is harmless
+        value_type top { std::move(m_data[0]) };
+        popTop();
         BHEAP_ASSERT_VALID();
+        return top;
     }
 
 private:
+    // indexed_binary_heap keeps its entries in a binary_heap and drives these sift routines directly
+    template <typename, typename, typename, std::size_t>
+    friend class indexed_binary_heap;
+
     // =========================
     // Data members
     // =========================
-    systems_dsa::vector<value_type> m_data {};
+    systems_dsa::vector<value_type, Allocator> m_data;
     comparator_type m_comp;
 
     size_type getParentIndex(size_type i) const {
         assert(i > 0);
-        return (i - 1) / 2;
+        return (i - 1) / Arity;
     }
 
-    size_type getLeftChildIndex(size_type i) const {
-        return 2 * i + 1;
-    }
-
-    size_type getRightChildIndex(size_type i) const {
-        return 2 * i + 2;
+    size_type getFirstChildIndex(size_type i) const {
+        return Arity * i + 1;
     }
 
     std::optional<size_type> findPriorityChildIndex(size_type i) const {
-        size_type lChildIndex { getLeftChildIndex(i) };
-        size_type rChildIndex { getRightChildIndex(i) };
-        size_type gtPriorityChildIndex {};
+        const size_type firstChildIndex { getFirstChildIndex(i) };
 
-        // No need to check right child, if left is out of bounds, so is right child
-        if (lChildIndex >= m_data.size()) {
+        // If the first child is out of bounds, so are its siblings
+        if (firstChildIndex >= m_data.size()) {
             // No children
             return std::nullopt;
         }
 
-        if (rChildIndex >= m_data.size()) {
-            // Only has the left child (only having a right child violates the structure rule)
-            gtPriorityChildIndex = lChildIndex;
-        } else {
-            gtPriorityChildIndex = !m_comp(
-                m_data[lChildIndex], m_data[rChildIndex])
-                ? lChildIndex
-                : rChildIndex;
+        // Only the last parent can have fewer than Arity children (the last level is filled left to right)
+        const size_type endChildIndex { std::min(firstChildIndex + Arity, m_data.size()) };
+        size_type gtPriorityChildIndex { firstChildIndex };
+        for (size_type childIndex { firstChildIndex + 1 }; childIndex < endChildIndex; ++childIndex) {
+            if (m_comp(m_data[gtPriorityChildIndex], m_data[childIndex])) {
+                gtPriorityChildIndex = childIndex;
+            }
         }
 
         return gtPriorityChildIndex;
     }
 
-    void siftUp() {
-        size_type insertedIndex { m_data.size() - 1 };
+    // Moves the element at `insertedIndex` up until its parent doesn't have lower priority. Everything above it must
+    // already be ordered.
+    // Both sifts hold the moving element aside and shift the elements it passes into the hole it leaves, so each level
+    // costs one move instead of a swap's three, and the element itself is moved only twice.
+    // `placed` is called with every index an element is moved into
+    template <typename Placed = detail::ignore_placement>
+    void siftUp(size_type insertedIndex, Placed placed = {}) {
+        // Key Invariant: Parents must not compare as "before" in ordering. Most pushes stop right here, without a move.
+        if (insertedIndex == 0 || !m_comp(m_data[getParentIndex(insertedIndex)], m_data[insertedIndex])) return;
+        value_type inserted { std::move(m_data[insertedIndex]) };
+        fillHoleUpward(insertedIndex, std::move(inserted), placed);
+    }
+
+    // Shifts parents of lower priority than `value` down into the hole at `holeIndex`, then moves `value` into it
+    template <typename Placed = detail::ignore_placement>
+    void fillHoleUpward(size_type holeIndex, value_type&& value, Placed placed = {}) {
+        while (holeIndex > 0) {
+            const size_type parentIndex { getParentIndex(holeIndex) };
+            if (!m_comp(m_data[parentIndex], value)) break;
+            m_data[holeIndex] = std::move(m_data[parentIndex]);
+            placed(holeIndex);
+            holeIndex = parentIndex;
+        }
+        m_data[holeIndex] = std::move(value);
+        placed(holeIndex);
+    }
+
+    // Moves the element at `parentIndex` down until none of its children has higher priority. Both subtrees below it
+    // must already be heaps.
+    template <typename Placed = detail::ignore_placement>
+    void siftDown(size_type parentIndex, Placed placed = {}) {
+        auto priorityChildOpt { findPriorityChildIndex(parentIndex) };
+        // Key Invariant: Parents must not compare as "before" in ordering
+        if (!priorityChildOpt.has_value() || !m_comp(m_data[parentIndex], m_data[priorityChildOpt.value()])) return;
+
+        value_type parent { std::move(m_data[parentIndex]) };
+        do {
+            m_data[parentIndex] = std::move(m_data[priorityChildOpt.value()]);
+            placed(parentIndex);
+            parentIndex = priorityChildOpt.value();
+            priorityChildOpt = findPriorityChildIndex(parentIndex);
+        } while (priorityChildOpt.has_value() && m_comp(parent, m_data[priorityChildOpt.value()]));
+        m_data[parentIndex] = std::move(parent);
+        placed(parentIndex);
+    }
 
-        if (insertedIndex == 0) return;
+    // Floyd's bottom-up pop: the root's hole is first walked down to a leaf, pulling up the priority child at each
+    // level, and the former last element is then sifted up from there. That last element almost always belongs near
+    // the bottom, so this saves the comparison against it on every level on the way down.
+    template <typename Placed = detail::ignore_placement>
+    void popTop(Placed placed = {}) {
+        if (m_data.size() == 1) {
+            m_data.pop_back();
+            return;
+        }
+        value_type last { std::move(m_data[m_data.size() - 1]) };
+        m_data.pop_back();
 
-        for (
-            size_type parentIndex { getParentIndex(insertedIndex) };
-            // Key Invariant: Parents must not compare as "before" in ordering, otherwise we swap
-            m_comp(m_data[parentIndex], m_data[insertedIndex]);
-            insertedIndex = parentIndex, parentIndex = getParentIndex(insertedIndex)
-        ) {
-            std::swap(m_data[insertedIndex], m_data[parentIndex]);
-            if (parentIndex == 0) break;
+        size_type holeIndex { 0 };
+        for (auto priorityChildOpt { findPriorityChildIndex(holeIndex) }; priorityChildOpt.has_value();
+            priorityChildOpt = findPriorityChildIndex(holeIndex)) {
+            m_data[holeIndex] = std::move(m_data[priorityChildOpt.value()]);
+            placed(holeIndex);
+            holeIndex = priorityChildOpt.value();
+        }
+        fillHoleUpward(holeIndex, std::move(last), placed);
+    }
+
+    // Removes the element at `index` by moving the last element into its place and sifting that up or down
+    template <typename Placed = detail::ignore_placement>
+    void eraseAt(size_type index, Placed placed = {}) {
+        const size_type lastIndex { m_data.size() - 1 };
+        if (index != lastIndex) {
+            m_data[index] = std::move(m_data[lastIndex]);
+        }
+        m_data.pop_back();
+        if (index == lastIndex) {
+            return;
+        }
+        placed(index);
+        siftUpOrDown(index, placed);
+    }
+
+    // Restores the order after the element at `index` changed priority in either direction
+    template <typename Placed = detail::ignore_placement>
+    void siftUpOrDown(size_type index, Placed placed = {}) {
+        if (index > 0 && m_comp(m_data[getParentIndex(index)], m_data[index])) {
+            siftUp(index, placed);
+        } else {
+            siftDown(index, placed);
+        }
+    }
+
+    // Floyd's bottom-up heapify: sifts down every parent, last to first, so each one is sifted into subtrees that are
+    // already heaps. O(n), since most parents sit just above the leaves and only move a level or two.
+    void heapify() {
+        if (m_data.size() < 2) return;
+        for (size_type parentIndex { getParentIndex(m_data.size() - 1) + 1 }; parentIndex-- > 0;) {
+            siftDown(parentIndex);
         }
     }
 #ifndef NDEBUG
@@ -179,6 +305,11 @@ private:
 #endif
 };
 
+namespace pmr {
+    template <typename T, typename Compare = std::less<T>, std::size_t Arity = 2>
+    using binary_heap = systems_dsa::binary_heap<T, Compare, std::pmr::polymorphic_allocator<T>, Arity>;
+}
+
 }
 
 
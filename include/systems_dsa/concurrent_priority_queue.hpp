@@ -0,0 +1,211 @@
+#pragma once
+#include <systems_dsa/binary_heap.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+namespace systems_dsa {
+
+namespace detail {
+    // A per-thread xorshift generator for picking queues: cheap, and never shared between threads
+    inline std::uint64_t nextQueueRandom() noexcept {
+        thread_local std::uint64_t state {
+            (std::hash<std::thread::id> {}(std::this_thread::get_id()) | 1) * 0x9E3779B97F4A7C15ull
+        };
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+}
+
+// A thread-safe priority queue for many producers and consumers, built as a MultiQueue: queue_count() binary_heaps,
+// each behind its own mutex. push adds to one random heap; try_pop compares the tops of two random heaps and takes the
+// higher priority one. Threads rarely want the same heap at the same time, and when they do, they pick another pair
+// instead of waiting (try_lock).
+//
+// The ordering is relaxed: try_pop returns an element close to the top, not necessarily the top. The rank error
+// (how many elements have higher priority than the one returned) is O(queue_count()) in expectation. Elements pushed
+// by one thread aren't guaranteed to come out in order either. Use it where priorities guide work rather than
+// decide correctness, as in schedulers, best-first search or timers that may fire slightly out of order.
+// No references are handed out; try_pop moves the element out.
+template <typename T, typename Compare = std::less<T>>
+class concurrent_priority_queue {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using comparator_type = Compare;
+    using heap_type = binary_heap<T, Compare>;
+    constexpr static std::size_t defaultQueuesPerThread { 2 };
+
+private:
+    // Each queue sits on its own cache line(s), so locking one queue doesn't invalidate its neighbours
+    struct alignas(64) Queue {
+        std::mutex mutex {};
+        heap_type heap {};
+        // Mirrors heap.size(), written under the lock, so try_pop can skip empty queues without locking them
+        std::atomic<size_type> size {};
+    };
+
+    //////////////////
+    // Data Members //
+    //////////////////
+    std::unique_ptr<Queue[]> m_queues {};
+    std::size_t m_queueCount {};
+    Compare m_comp {};
+
+    // Tries this many random queues (or pairs) before blocking on one
+    constexpr static int maxLockAttempts { 8 };
+
+    std::size_t randomQueueIndex() const noexcept {
+        return static_cast<std::size_t>(detail::nextQueueRandom() % m_queueCount);
+    }
+
+    // Pops from `queue`, whose lock is held and which isn't empty
+    T popLocked(Queue& queue) {
+        T top { queue.heap.extract_top() };
+        queue.size.store(queue.heap.size(), std::memory_order_relaxed);
+        return top;
+    }
+
+    // Takes every queue's lock in turn. Returns std::nullopt only if each was empty when it was checked.
+    std::optional<T> popFromAny() {
+        const std::size_t start { randomQueueIndex() };
+        for (std::size_t offset {}; offset < m_queueCount; ++offset) {
+            Queue& queue { m_queues[(start + offset) % m_queueCount] };
+            if (queue.size.load(std::memory_order_relaxed) == 0) {
+                continue;
+            }
+            std::lock_guard lock { queue.mutex };
+            if (!queue.heap.empty()) {
+                return popLocked(queue);
+            }
+        }
+        return std::nullopt;
+    }
+
+public:
+    // `threadCount` is the number of threads expected to use the queue, and there are `queuesPerThread` heaps per
+    // thread, at least 2 in total. More queues mean less contention and a larger rank error.
+    explicit concurrent_priority_queue(std::size_t threadCount = std::thread::hardware_concurrency(),
+        std::size_t queuesPerThread = defaultQueuesPerThread) {
+        if (queuesPerThread == 0) {
+            throw std::invalid_argument("A concurrent_priority_queue needs at least 1 queue per thread");
+        }
+        m_queueCount = std::max<std::size_t>(std::max<std::size_t>(threadCount, 1) * queuesPerThread, 2);
+        m_queues = std::make_unique<Queue[]>(m_queueCount);
+    }
+
+    concurrent_priority_queue(const concurrent_priority_queue& other) = delete;
+    concurrent_priority_queue& operator=(const concurrent_priority_queue& other) = delete;
+    concurrent_priority_queue(concurrent_priority_queue&& other) = delete;
+    concurrent_priority_queue& operator=(concurrent_priority_queue&& other) = delete;
+
+    ~concurrent_priority_queue() = default;
+
+    ///////////////
+    // Modifiers //
+    ///////////////
+
+    void push(const T& value) {
+        emplace(value);
+    }
+
+    void push(T&& value) {
+        emplace(std::move(value));
+    }
+
+    // Adds to a random queue that isn't locked, or after maxLockAttempts busy ones, waits for the last one tried
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        for (int attempt { 1 };; ++attempt) {
+            Queue& queue { m_queues[randomQueueIndex()] };
+            std::unique_lock lock { queue.mutex, std::defer_lock };
+            if (attempt < maxLockAttempts) {
+                if (!lock.try_lock()) {
+                    continue;
+                }
+            } else {
+                lock.lock();
+            }
+            queue.heap.emplace(std::forward<Args>(args)...);
+            queue.size.store(queue.heap.size(), std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    // Removes and returns an element near the top: the higher priority of the tops of two random queues. If both are
+    // empty, or stay busy for maxLockAttempts pairs, falls back to taking any queue's top. Returns std::nullopt only if
+    // every queue was empty when it was checked, so it can miss elements pushed concurrently.
+    std::optional<T> try_pop() {
+        for (int attempt {}; attempt < maxLockAttempts; ++attempt) {
+            std::size_t first { randomQueueIndex() };
+            std::size_t second { randomQueueIndex() };
+            if (first == second) {
+                second = (second + 1) % m_queueCount;
+            }
+            Queue* queueA { &m_queues[first] };
+            Queue* queueB { &m_queues[second] };
+            const bool hasA { queueA->size.load(std::memory_order_relaxed) != 0 };
+            const bool hasB { queueB->size.load(std::memory_order_relaxed) != 0 };
+            if (!hasA && !hasB) {
+                break;
+            }
+            if (!hasA || !hasB) {
+                Queue& queue { hasA ? *queueA : *queueB };
+                std::unique_lock lock { queue.mutex, std::try_to_lock };
+                if (lock.owns_lock() && !queue.heap.empty()) {
+                    return popLocked(queue);
+                }
+                continue;
+            }
+
+            // try_lock on both, so two threads locking the same pair in opposite order can't deadlock
+            std::unique_lock lockA { queueA->mutex, std::try_to_lock };
+            if (!lockA.owns_lock()) {
+                continue;
+            }
+            std::unique_lock lockB { queueB->mutex, std::try_to_lock };
+            if (!lockB.owns_lock()) {
+                continue;
+            }
+            if (queueA->heap.empty() && queueB->heap.empty()) {
+                break;
+            }
+            if (queueA->heap.empty() || (!queueB->heap.empty() && m_comp(queueA->heap.top(), queueB->heap.top()))) {
+                return popLocked(*queueB);
+            }
+            return popLocked(*queueA);
+        }
+        return popFromAny();
+    }
+
+    //////////////
+    // Capacity //
+    //////////////
+
+    // Sums the queues one at a time, so it is not a snapshot while other threads push or pop
+    size_type size() const noexcept {
+        size_type total {};
+        for (std::size_t i {}; i < m_queueCount; ++i) {
+            total += m_queues[i].size.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    std::size_t queue_count() const noexcept {
+        return m_queueCount;
+    }
+};
+
+}
@@ -0,0 +1,191 @@
+#pragma once
+#include <systems_dsa/unordered_map.hpp>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+
+namespace systems_dsa {
+
+// A thread-safe map made of independently locked unordered_map shards.
+// Keys are assigned to a shard by the high bits of their mixed hash, and every operation locks only that shard:
+// readers take a shared lock, writers an exclusive one.
+// No iterators or references are handed out; values are copied out by find, or accessed in place through visit
+// while the shard lock is held.
+template <
+    typename K,
+    typename V,
+    class Hasher = std::hash<K>,
+    class KeyEqual = std::equal_to<K>,
+    class BucketPolicy = modulo_bucket_policy
+    >
+requires ValidHasher<Hasher, K> &&
+    ValidKeyEqual<KeyEqual, K> &&
+    ValidBucketPolicy<BucketPolicy>
+class concurrent_unordered_map {
+public:
+    using map_type = unordered_map<K, V, Hasher, KeyEqual, BucketPolicy>;
+    constexpr static std::size_t defaultShardCount { 64 };
+
+private:
+    // Each shard sits on its own cache line(s), so locking one shard doesn't invalidate its neighbours
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex {};
+        map_type map {};
+    };
+
+    //////////////////
+    // Data Members //
+    //////////////////
+    std::unique_ptr<Shard[]> m_shards {};
+    std::size_t m_shardCount {};
+    int m_shardBits {};
+    Hasher m_hasher;
+
+    // Every operation hashes the key once: the high bits of the mixed hash pick the shard, and the unhashed value is
+    // handed to the shard's map, which would compute the same value (it default-constructs the same Hasher)
+    std::size_t getShardIndex(std::size_t hashedKey) const {
+        if (m_shardBits == 0) return 0;
+        // High bits pick the shard, so the shard's own home bucket (low bits, or hash % bucket count) stays spread
+        return detail::mixHash(hashedKey) >> (std::numeric_limits<std::size_t>::digits - m_shardBits);
+    }
+
+    Shard& getShard(std::size_t hashedKey) {
+        return m_shards[getShardIndex(hashedKey)];
+    }
+
+    const Shard& getShard(std::size_t hashedKey) const {
+        return m_shards[getShardIndex(hashedKey)];
+    }
+
+public:
+    // `shardCount` is rounded up to a power of two
+    explicit concurrent_unordered_map(std::size_t shardCount = defaultShardCount) {
+        if (shardCount == 0) {
+            throw std::invalid_argument("A concurrent_unordered_map must have at least 1 shard");
+        }
+        m_shardCount = std::bit_ceil(shardCount);
+        m_shardBits = std::countr_zero(m_shardCount);
+        m_shards = std::make_unique<Shard[]>(m_shardCount);
+    }
+
+    concurrent_unordered_map(const concurrent_unordered_map& other) = delete;
+    concurrent_unordered_map& operator=(const concurrent_unordered_map& other) = delete;
+    concurrent_unordered_map(concurrent_unordered_map&& other) = delete;
+    concurrent_unordered_map& operator=(concurrent_unordered_map&& other) = delete;
+
+    ~concurrent_unordered_map() = default;
+
+    ///////////////
+    // Modifiers //
+    ///////////////
+
+    // Returns true if the key was inserted, false if it was already present
+    bool insert(const K& key, const V& value) {
+        const std::size_t hashedKey { m_hasher(key) };
+        Shard& shard { getShard(hashedKey) };
+        std::unique_lock lock { shard.mutex };
+        return shard.map.emplaceHashed(hashedKey, key, key, value).second;
+    }
+
+    bool insert(K&& key, V&& value) {
+        const std::size_t hashedKey { m_hasher(key) };
+        Shard& shard { getShard(hashedKey) };
+        std::unique_lock lock { shard.mutex };
+        return shard.map.emplaceHashed(hashedKey, key, std::move(key), std::move(value)).second;
+    }
+
+    std::size_t erase(const K& key) {
+        const std::size_t hashedKey { m_hasher(key) };
+        Shard& shard { getShard(hashedKey) };
+        std::unique_lock lock { shard.mutex };
+        return shard.map.eraseAtIndex(shard.map.probeForKey(key, hashedKey)) != map_type::sentinelIndex ? 1 : 0;
+    }
+
+    // Shards are cleared one at a time, so concurrent inserts into already cleared shards are kept
+    void clear() {
+        for (std::size_t i {}; i < m_shardCount; ++i) {
+            std::unique_lock lock { m_shards[i].mutex };
+            m_shards[i].map.clear();
+        }
+    }
+
+    ////////////
+    // Lookup //
+    ////////////
+
+    // Returns a copy of the value, std::nullopt if the key wasn't found
+    std::optional<V> find(const K& key) const {
+        const std::size_t hashedKey { m_hasher(key) };
+        const Shard& shard { getShard(hashedKey) };
+        std::shared_lock lock { shard.mutex };
+        const auto it { shard.map.iteratorAt(shard.map.probeForKey(key, hashedKey)) };
+        if (it == shard.map.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    bool contains(const K& key) const {
+        const std::size_t hashedKey { m_hasher(key) };
+        const Shard& shard { getShard(hashedKey) };
+        std::shared_lock lock { shard.mutex };
+        return shard.map.probeForKey(key, hashedKey) < shard.map.bucket_count();
+    }
+
+    // Calls fn(V&) with the shard exclusively locked. Returns false, without calling fn, if the key wasn't found.
+    // fn must not call back into this map.
+    template <typename F>
+    requires std::invocable<F&, V&>
+    bool visit(const K& key, F&& fn) {
+        const std::size_t hashedKey { m_hasher(key) };
+        Shard& shard { getShard(hashedKey) };
+        std::unique_lock lock { shard.mutex };
+        auto it { shard.map.iteratorAt(shard.map.probeForKey(key, hashedKey)) };
+        if (it == shard.map.end()) {
+            return false;
+        }
+        fn(it->second);
+        return true;
+    }
+
+    // Calls fn(const V&) with the shard share-locked
+    template <typename F>
+    requires std::invocable<F&, const V&>
+    bool visit(const K& key, F&& fn) const {
+        const std::size_t hashedKey { m_hasher(key) };
+        const Shard& shard { getShard(hashedKey) };
+        std::shared_lock lock { shard.mutex };
+        const auto it { shard.map.iteratorAt(shard.map.probeForKey(key, hashedKey)) };
+        if (it == shard.map.end()) {
+            return false;
+        }
+        fn(it->second);
+        return true;
+    }
+
+    //////////////
+    // Capacity //
+    //////////////
+
+    // Sums the shards one lock at a time, so it is not a snapshot while writers are active
+    std::size_t size() const {
+        std::size_t total {};
+        for (std::size_t i {}; i < m_shardCount; ++i) {
+            std::shared_lock lock { m_shards[i].mutex };
+            total += m_shards[i].map.size();
+        }
+        return total;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    std::size_t shard_count() const noexcept {
+        return m_shardCount;
+    }
+};
+
+}
@@ -0,0 +1,169 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace systems_dsa {
+    // Where the pages of a huge page mapping are placed on a NUMA machine
+    enum class numa_policy : std::uint8_t {
+        local,      // The kernel's default, each page lands on the node of the thread that first touches it
+        bind,       // Only on the nodes in `numa_nodes`
+        interleave, // Round-robin across the nodes in `numa_nodes`
+    };
+
+    struct huge_page_options {
+        constexpr static std::size_t huge_page_size { std::size_t { 2 } * 1024 * 1024 };
+
+        // Allocations of at least this many bytes are mmapped on a 2MB boundary and advised to be backed by transparent
+        // huge pages. Smaller ones go to operator new, where huge pages wouldn't be filled anyway.
+        std::size_t threshold_bytes { huge_page_size };
+        // Try an explicit MAP_HUGETLB mapping (from the pool reserved in /proc/sys/vm/nr_hugepages) first, falling back
+        // to transparent huge pages when the pool can't cover the allocation
+        bool use_hugetlb { false };
+        numa_policy numa { numa_policy::local };
+        // Bit i selects NUMA node i, for numa_policy::bind and numa_policy::interleave
+        std::uint64_t numa_nodes {};
+
+        bool operator==(const huge_page_options&) const = default;
+    };
+
+    namespace detail {
+    #if defined(__linux__)
+        // Applies the NUMA policy to a mapping that hasn't been touched yet. Best effort: on a kernel without NUMA
+        // support, or a node that's offline, the pages are placed as usual.
+        inline void applyNumaPolicy(void* mem, std::size_t bytes, const huge_page_options& options) noexcept {
+            if (options.numa == numa_policy::local) {
+                return;
+            }
+            const int mode { options.numa == numa_policy::bind ? MPOL_BIND : MPOL_INTERLEAVE };
+            const unsigned long nodeMask { options.numa_nodes };
+            // The kernel reads maxnode - 1 bits
+            constexpr unsigned long maxNode { std::numeric_limits<unsigned long>::digits + 1 };
+            syscall(SYS_mbind, mem, bytes, mode, &nodeMask, maxNode, 0);
+        }
+
+        // Maps `bytes` (a multiple of the huge page size) on a huge page boundary
+        inline void* mapHugePages(std::size_t bytes, const huge_page_options& options) {
+            constexpr std::size_t hugePage { huge_page_options::huge_page_size };
+            void* mem { MAP_FAILED };
+            if (options.use_hugetlb) {
+                mem = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            }
+            if (mem == MAP_FAILED) {
+                // Over-map by one huge page and cut an aligned block out of it, otherwise the kernel can't back the
+                // start and end of the block with huge pages
+                const std::size_t padded { bytes + hugePage };
+                void* raw { mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) };
+                if (raw == MAP_FAILED) {
+                    throw std::bad_alloc();
+                }
+                const auto start { reinterpret_cast<std::uintptr_t>(raw) };
+                const std::uintptr_t aligned { (start + hugePage - 1) & ~(hugePage - 1) };
+                if (aligned > start) {
+                    munmap(raw, aligned - start);
+                }
+                const std::size_t tail { start + padded - (aligned + bytes) };
+                if (tail > 0) {
+                    munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+                }
+                mem = reinterpret_cast<void*>(aligned);
+                // Fails harmlessly where transparent huge pages are disabled
+                madvise(mem, bytes, MADV_HUGEPAGE);
+            }
+            applyNumaPolicy(mem, bytes, options);
+            return mem;
+        }
+    #endif
+    }
+
+    // An allocator that backs large blocks with 2MB pages, so random access over a large vector, unordered_map bucket
+    // array or binary_heap misses the TLB far less often than with 4K pages. Blocks of at least `threshold_bytes` are
+    // mmapped directly, optionally bound to or interleaved across NUMA nodes; smaller ones come from operator new.
+    // On platforms other than Linux every block comes from operator new.
+    // Allocators compare equal when their options do, which is what decides how a block is freed.
+    template <typename T>
+    class huge_page_allocator {
+    public:
+        using value_type = T;
+        // Moved-to containers take the source's allocator, so move assignment can always adopt its storage
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        huge_page_allocator() noexcept = default;
+
+        explicit huge_page_allocator(const huge_page_options& options) : m_options { options } {
+            if (options.numa != numa_policy::local && options.numa_nodes == 0) {
+                throw std::invalid_argument("A bind or interleave NUMA policy needs at least one node");
+            }
+        }
+
+        // Rebinding, used by containers that allocate their own node or bucket types
+        template <typename U>
+        huge_page_allocator(const huge_page_allocator<U>& other) noexcept : m_options { other.options() } {}
+
+        T* allocate(std::size_t n) {
+            if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+                throw std::bad_array_new_length();
+            }
+            const std::size_t bytes { n * sizeof(T) };
+        #if defined(__linux__)
+            if (mapsDirectly(bytes)) {
+                return static_cast<T*>(detail::mapHugePages(mappedBytes(bytes), m_options));
+            }
+        #endif
+            if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                return static_cast<T*>(::operator new(bytes, std::align_val_t { alignof(T) }));
+            } else {
+                return static_cast<T*>(::operator new(bytes));
+            }
+        }
+
+        // `n` must be the count the block was allocated with
+        void deallocate(T* ptr, std::size_t n) noexcept {
+            const std::size_t bytes { n * sizeof(T) };
+        #if defined(__linux__)
+            if (mapsDirectly(bytes)) {
+                munmap(static_cast<void*>(ptr), mappedBytes(bytes));
+                return;
+            }
+        #endif
+            if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                ::operator delete(static_cast<void*>(ptr), bytes, std::align_val_t { alignof(T) });
+            } else {
+                ::operator delete(static_cast<void*>(ptr), bytes);
+            }
+        }
+
+        const huge_page_options& options() const noexcept {
+            return m_options;
+        }
+
+        template <typename U>
+        bool operator==(const huge_page_allocator<U>& other) const noexcept {
+            return m_options == other.options();
+        }
+
+    private:
+        huge_page_options m_options {};
+
+        bool mapsDirectly(std::size_t bytes) const noexcept {
+            return bytes >= m_options.threshold_bytes;
+        }
+
+        // Mappings are whole huge pages
+        static std::size_t mappedBytes(std::size_t bytes) noexcept {
+            constexpr std::size_t hugePage { huge_page_options::huge_page_size };
+            return (bytes + hugePage - 1) & ~(hugePage - 1);
+        }
+    };
+}
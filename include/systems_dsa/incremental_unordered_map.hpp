@@ -0,0 +1,238 @@
+#pragma once
+#include <systems_dsa/unordered_map.hpp>
+#include <algorithm>
+
+namespace systems_dsa {
+
+// An unordered_map whose growth never moves every element in one call.
+// When the active table would reach the max load factor, it becomes the draining table and a table with twice the
+// buckets (or as many, if most of the load was tombstones) takes its place. Every following insert, erase and
+// non-const find then migrates the next `migrationStep` buckets of the draining table into the active one, and lookups
+// consult both tables until the draining table is exhausted. An element is only ever in one of the two tables.
+template <
+    typename K,
+    typename V,
+    class Hasher = std::hash<K>,
+    class KeyEqual = std::equal_to<K>,
+    class BucketPolicy = modulo_bucket_policy
+    >
+requires ValidHasher<Hasher, K> &&
+    ValidKeyEqual<KeyEqual, K> &&
+    ValidBucketPolicy<BucketPolicy>
+class incremental_unordered_map {
+public:
+    using map_type = unordered_map<K, V, Hasher, KeyEqual, BucketPolicy>;
+    using value_type = std::pair<const K, V>;
+
+    // Each insert or erase adds at most one element or tombstone to the active table while `migrationStep` draining
+    // buckets are migrated. The active table starts no more than half full (see beginMigration), so the draining table
+    // is exhausted long before the active table could reach the max load factor.
+    constexpr static std::size_t migrationStep { 16 };
+    static_assert(map_type::maxLoadFactor / 2 + 1.0f / migrationStep < map_type::maxLoadFactor,
+        "A migration must finish before the active table can fill up");
+
+private:
+    //////////////////
+    // Data Members //
+    //////////////////
+    map_type m_active {};
+    map_type m_draining { 1 };
+    std::size_t m_migrateIndex {};
+    bool m_migrating { false };
+
+    // The active table becomes the draining one. Its replacement has twice the buckets, or the same number when
+    // tombstones make up most of the load: migrating only the live elements then purges them without growing.
+    // Either way the new table is at most half as loaded as the max load factor once the migration completes.
+    void beginMigration() {
+        assert(!m_migrating);
+        const std::size_t buckets { m_active.bucket_count() };
+        const bool mostlyTombstones {
+            static_cast<float>(m_active.size()) < map_type::maxLoadFactor / 2 * static_cast<float>(buckets)
+        };
+        const std::size_t newBucketCount { mostlyTombstones ? buckets : buckets * 2 };
+        m_draining = std::move(m_active);
+        m_active = map_type { newBucketCount };
+        m_migrateIndex = 0;
+        m_migrating = true;
+    }
+
+    // Moves the FILLED buckets among the next `bucketCount` draining buckets into the active table
+    void migrate(std::size_t bucketCount) {
+        if (!m_migrating) return;
+        auto& table { m_draining.m_table };
+        const std::size_t last { std::min(m_migrateIndex + bucketCount, table.size()) };
+        for (; m_migrateIndex < last; ++m_migrateIndex) {
+            if (detail::isFilled(table.ctrl[m_migrateIndex])) {
+                assert(m_active.getLoadFactor(1) < map_type::maxLoadFactor
+                    && "migrate() would make the active table rehash synchronously");
+                m_active.insert(std::move_if_noexcept(*table.buckets[m_migrateIndex].ptr()));
+                m_draining.eraseAtIndex(m_migrateIndex);
+            }
+        }
+        if (m_migrateIndex == table.size()) {
+            assert(m_draining.empty());
+            m_draining = map_type { 1 };
+            m_migrating = false;
+        }
+    }
+
+    // Called before every insert. The load is checked before anything is migrated into the active table, and a new
+    // migration only begins once the previous one is done, so neither migrating nor the insert that follows ever makes
+    // the active table rehash.
+    void growIfNeeded() {
+        if (m_migrating) {
+            migrate(migrationStep);
+        } else if (m_active.getLoadFactor(1) >= map_type::maxLoadFactor) {
+            beginMigration();
+        }
+        assert(m_active.getLoadFactor(1) < map_type::maxLoadFactor
+            && "The active table filled up before the migration finished");
+    }
+
+public:
+    incremental_unordered_map() = default;
+
+    explicit incremental_unordered_map(std::size_t n) : m_active { n } {}
+
+    incremental_unordered_map(const incremental_unordered_map& other) = delete;
+    incremental_unordered_map& operator=(const incremental_unordered_map& other) = delete;
+
+    ///////////////
+    // Modifiers //
+    ///////////////
+
+    // Returns true if the key was inserted, false if it was already present (no-op)
+    bool insert(const K& key, const V& value) {
+        growIfNeeded();
+        if (m_migrating && m_draining.contains(key)) {
+            return false;
+        }
+        return m_active.insert(key, value).second;
+    }
+
+    bool insert(K&& key, V&& value) {
+        growIfNeeded();
+        if (m_migrating && m_draining.contains(key)) {
+            return false;
+        }
+        return m_active.insert(std::move(key), std::move(value)).second;
+    }
+
+    std::size_t erase(const K& key) {
+        migrate(migrationStep);
+        if (m_migrating && m_draining.erase(key) == 1) {
+            return 1;
+        }
+        return m_active.erase(key);
+    }
+
+    void clear() {
+        m_active.clear();
+        m_draining = map_type { 1 };
+        m_migrating = false;
+        m_migrateIndex = 0;
+    }
+
+    ////////////
+    // Lookup //
+    ////////////
+
+    // Returns a pointer to the value, nullptr if the key wasn't found.
+    // Pointers are invalidated by any later non-const operation, since it may migrate the element.
+    V* find(const K& key) {
+        migrate(migrationStep);
+        return findImpl(*this, key);
+    }
+
+    const V* find(const K& key) const {
+        return findImpl(*this, key);
+    }
+
+    bool contains(const K& key) const {
+        return m_active.contains(key) || (m_migrating && m_draining.contains(key));
+    }
+
+    // Advances the migration once, like insert. A key still in the draining table is migrated ahead of its turn,
+    // otherwise a single try_emplace finds or inserts it in the active table.
+    V& operator[](const K& key) {
+        growIfNeeded();
+        if (m_migrating) {
+            auto& table { m_draining.m_table };
+            if (const std::size_t index { m_draining.probeForKey(key) }; index < table.size()) {
+                const auto migrated { m_active.insert(std::move_if_noexcept(*table.buckets[index].ptr())) };
+                assert(migrated.second);
+                m_draining.eraseAtIndex(index);
+                return migrated.first->second;
+            }
+        }
+        return m_active.try_emplace(key).first->second;
+    }
+
+    V& at(const K& key) {
+        if (V* value { find(key) }) {
+            return *value;
+        }
+        throw std::out_of_range("The key provided was not found in the hashmap\n");
+    }
+
+    const V& at(const K& key) const {
+        if (const V* value { find(key) }) {
+            return *value;
+        }
+        throw std::out_of_range("The key provided was not found in the hashmap\n");
+    }
+
+    // Calls fn(const K&, V&) for every element, in no particular order
+    template <typename F>
+    void for_each(F&& fn) {
+        for (auto& pair : m_active) {
+            fn(pair.first, pair.second);
+        }
+        if (m_migrating) {
+            for (auto& pair : m_draining) {
+                fn(pair.first, pair.second);
+            }
+        }
+    }
+
+    //////////////
+    // Capacity //
+    //////////////
+
+    std::size_t size() const noexcept {
+        return m_active.size() + (m_migrating ? m_draining.size() : 0);
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    // Bucket count of the active table
+    std::size_t bucket_count() const {
+        return m_active.bucket_count();
+    }
+
+    bool is_migrating() const noexcept {
+        return m_migrating;
+    }
+
+    float max_load_factor() const {
+        return m_active.max_load_factor();
+    }
+
+private:
+    template <typename Self>
+    static auto findImpl(Self& self, const K& key) -> decltype(&self.m_active.find(key)->second) {
+        if (auto it { self.m_active.find(key) }; it != self.m_active.end()) {
+            return &it->second;
+        }
+        if (self.m_migrating) {
+            if (auto it { self.m_draining.find(key) }; it != self.m_draining.end()) {
+                return &it->second;
+            }
+        }
+        return nullptr;
+    }
+};
+
+}
@@ -0,0 +1,277 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <systems_dsa/binary_heap.hpp>
+#include <systems_dsa/vector.hpp>
+#include <utility>
+
+#ifndef NDEBUG
+#define IHEAP_ASSERT_VALID() assertValid();
+#else
+#define IHEAP_ASSERT_VALID() (void(0))
+#endif
+
+namespace systems_dsa {
+
+// A binary_heap whose elements can be reached after they're pushed: push() returns a handle that stays valid, wherever
+// the element moves, until the element is popped or erased. Through the handle its priority can be changed or it can
+// be removed, both in O(log n), instead of pushing a duplicate and skipping the stale entry when it surfaces.
+//
+// The entries (element and slot) live in a binary_heap and are moved by its sift routines, which report every index an
+// entry lands on so the slot table always knows where each element is. Slots of removed elements are reused; each
+// carries a generation, so a handle to a removed element never aliases the element that reuses its slot.
+template <typename T, typename Compare = std::less<T>, typename Allocator = std::allocator<T>, std::size_t Arity = 2>
+class indexed_binary_heap {
+public:
+    // =========================
+    // Member type aliases
+    // =========================
+    using size_type = std::size_t;
+    using value_type = T;
+    using const_reference = const T&;
+    using comparator_type = Compare;
+    using allocator_type = Allocator;
+    static constexpr size_type arity { Arity };
+
+    class handle {
+    public:
+        handle() = default;
+
+        bool operator==(const handle&) const = default;
+
+    private:
+        friend class indexed_binary_heap;
+
+        handle(size_type slot, std::uint64_t generation) noexcept : m_slot { slot }, m_generation { generation } {}
+
+        size_type m_slot { std::numeric_limits<size_type>::max() };
+        std::uint64_t m_generation {};
+    };
+
+private:
+    struct Entry {
+        T value;
+        size_type slot;
+    };
+
+    struct EntryCompare {
+        [[no_unique_address]] Compare comp {};
+
+        bool operator()(const Entry& lhs, const Entry& rhs) const {
+            return comp(lhs.value, rhs.value);
+        }
+    };
+
+    struct Slot {
+        size_type position;
+        std::uint64_t generation;
+    };
+
+    using entry_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Entry>;
+    using slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+    using size_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<size_type>;
+
+    static constexpr size_type npos { std::numeric_limits<size_type>::max() };
+
+public:
+    // =========================
+    // Constructors
+    // =========================
+    indexed_binary_heap() : indexed_binary_heap(Allocator()) {}
+
+    explicit indexed_binary_heap(const Allocator& alloc)
+        : m_heap(entry_allocator(alloc))
+        , m_slots(slot_allocator(alloc))
+        , m_freeSlots(size_allocator(alloc))
+    {}
+
+    allocator_type get_allocator() const noexcept {
+        return allocator_type(m_heap.get_allocator());
+    }
+
+    // =========================
+    // Capacity
+    // =========================
+    bool empty() const noexcept {
+        return m_heap.empty();
+    }
+
+    size_type size() const noexcept {
+        return m_heap.size();
+    }
+
+    void reserve(size_type n) {
+        m_heap.reserve(n);
+        m_slots.reserve(n);
+    }
+
+    // =========================
+    // Element access
+    // =========================
+    const_reference top() const {
+        assert(!empty());
+        return m_heap.top().value;
+    }
+
+    handle top_handle() const {
+        assert(!empty());
+        return handleOf(m_heap.top().slot);
+    }
+
+    bool contains(handle h) const noexcept {
+        return h.m_slot < m_slots.size()
+            && m_slots[h.m_slot].generation == h.m_generation
+            && m_slots[h.m_slot].position != npos;
+    }
+
+    // Throws std::out_of_range if the handle's element was popped or erased
+    const_reference at(handle h) const {
+        if (!contains(h)) {
+            throw std::out_of_range("indexed_binary_heap::at: handle does not refer to an element in the heap");
+        }
+        return m_heap.m_data[m_slots[h.m_slot].position].value;
+    }
+
+    // =========================
+    // Modifiers
+    // =========================
+    handle push(const value_type& val) {
+        return emplace(val);
+    }
+
+    handle push(value_type&& val) {
+        return emplace(std::move(val));
+    }
+
+    template <typename... Args>
+    handle emplace(Args&&... args) {
+        const size_type slot { acquireSlot() };
+        try {
+            m_heap.m_data.push_back(Entry { T(std::forward<Args>(args)...), slot });
+        } catch (...) {
+            releaseSlot(slot);
+            throw;
+        }
+        const size_type index { m_heap.size() - 1 };
+        m_slots[slot].position = index;
+        m_heap.siftUp(index, placement());
+        IHEAP_ASSERT_VALID();
+        return handleOf(slot);
+    }
+
+    void pop() {
+        assert(!empty());
+        releaseSlot(m_heap.top().slot);
+        m_heap.popTop(placement());
+        IHEAP_ASSERT_VALID();
+    }
+
+    // Replaces the element's value, moving it up or down to its new place. Requires contains(h).
+    void update(handle h, const value_type& newValue) {
+        assign(h, newValue);
+    }
+
+    void update(handle h, value_type&& newValue) {
+        assign(h, std::move(newValue));
+    }
+
+    // Removes the element. Requires contains(h); the handle is invalid afterwards.
+    void erase(handle h) {
+        assert(contains(h) && "erase() with a handle to an element not in the heap");
+        const size_type index { m_slots[h.m_slot].position };
+        releaseSlot(h.m_slot);
+        m_heap.eraseAt(index, placement());
+        IHEAP_ASSERT_VALID();
+    }
+
+    // Invalidates every handle
+    void clear() noexcept {
+        m_heap.m_data.clear();
+        m_freeSlots.clear();
+        for (size_type slot { m_slots.size() }; slot-- > 0;) {
+            if (m_slots[slot].position != npos) {
+                m_slots[slot].position = npos;
+                ++m_slots[slot].generation;
+            }
+            m_freeSlots.push_back(slot);
+        }
+    }
+
+private:
+    // =========================
+    // Data members
+    // =========================
+    binary_heap<Entry, EntryCompare, entry_allocator, Arity> m_heap;
+    // Indexed by handle slot, where that slot's element sits in m_heap (npos if the slot is free)
+    systems_dsa::vector<Slot, slot_allocator> m_slots;
+    systems_dsa::vector<size_type, size_allocator> m_freeSlots;
+
+    auto placement() noexcept {
+        return [this](size_type index) noexcept {
+            m_slots[m_heap.m_data[index].slot].position = index;
+        };
+    }
+
+    handle handleOf(size_type slot) const noexcept {
+        return handle { slot, m_slots[slot].generation };
+    }
+
+    size_type acquireSlot() {
+        if (!m_freeSlots.empty()) {
+            const size_type slot { m_freeSlots.back() };
+            m_freeSlots.pop_back();
+            return slot;
+        }
+        // Make room for the slot in the free list now, so releasing it later can't throw
+        if (m_freeSlots.capacity() <= m_slots.size()) {
+            m_freeSlots.reserve(2 * m_slots.size() + 1);
+        }
+        m_slots.push_back(Slot { npos, 0 });
+        return m_slots.size() - 1;
+    }
+
+    void releaseSlot(size_type slot) noexcept {
+        m_slots[slot].position = npos;
+        ++m_slots[slot].generation;
+        m_freeSlots.push_back(slot);
+    }
+
+    template <typename V>
+    void assign(handle h, V&& newValue) {
+        assert(contains(h) && "update() with a handle to an element not in the heap");
+        const size_type index { m_slots[h.m_slot].position };
+        m_heap.m_data[index].value = std::forward<V>(newValue);
+        m_heap.siftUpOrDown(index, placement());
+        IHEAP_ASSERT_VALID();
+    }
+
+#ifndef NDEBUG
+    void assertValid() const {
+        m_heap.assertValid();
+        size_type liveSlots {};
+        for (size_type slot {}; slot < m_slots.size(); ++slot) {
+            const size_type position { m_slots[slot].position };
+            if (position == npos) {
+                continue;
+            }
+            ++liveSlots;
+            assert(position < m_heap.size() && m_heap.m_data[position].slot == slot
+                && "assertValid() detected a slot whose position doesn't point back at it");
+        }
+        assert(liveSlots == m_heap.size() && "assertValid() detected elements without a slot");
+        assert(liveSlots + m_freeSlots.size() == m_slots.size() && "assertValid() detected a leaked slot");
+    }
+#endif
+};
+
+namespace pmr {
+    template <typename T, typename Compare = std::less<T>, std::size_t Arity = 2>
+    using indexed_binary_heap = systems_dsa::indexed_binary_heap<T, Compare, std::pmr::polymorphic_allocator<T>, Arity>;
+}
+
+}
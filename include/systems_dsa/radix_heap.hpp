@@ -0,0 +1,240 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <systems_dsa/vector.hpp>
+
+#ifndef NDEBUG
+#define RHEAP_ASSERT_VALID() assertValid();
+#else
+#define RHEAP_ASSERT_VALID() (void(0))
+#endif
+
+namespace systems_dsa {
+
+namespace detail {
+    template <typename Key>
+    struct radix_key_traits;
+
+    template <std::unsigned_integral Key>
+        requires (!std::same_as<Key, bool>)
+    struct radix_key_traits<Key> {
+        using bits_type = Key;
+
+        static constexpr bits_type encode(Key key) noexcept {
+            return key;
+        }
+    };
+
+    // IEEE floats order like their bit patterns once the sign bit is flipped for positives and every bit is flipped
+    // for negatives
+    template <std::floating_point Key>
+        requires std::numeric_limits<Key>::is_iec559 && (sizeof(Key) == 4 || sizeof(Key) == 8)
+    struct radix_key_traits<Key> {
+        using bits_type = std::conditional_t<sizeof(Key) == 4, std::uint32_t, std::uint64_t>;
+
+        static constexpr bits_type encode(Key key) noexcept {
+            constexpr bits_type signBit { bits_type { 1 } << (std::numeric_limits<bits_type>::digits - 1) };
+            const auto bits { std::bit_cast<bits_type>(key) };
+            return (bits & signBit) ? static_cast<bits_type>(~bits) : static_cast<bits_type>(bits | signBit);
+        }
+    };
+}
+
+template <typename Key>
+concept radix_heap_key = requires { typename detail::radix_key_traits<Key>::bits_type; };
+
+// A min-heap for monotone workloads, where keys only ever grow: event queues keyed by timestamp, Dijkstra with integer
+// distances. Every pushed key must be at least the key last returned by top() (pop() reads the top too).
+//
+// Elements sit in one bucket per bit of the key: bucket i holds the keys whose highest bit differing from the last top
+// key is bit i - 1, and bucket 0 the keys equal to it. When bucket 0 runs empty, the lowest non-empty bucket becomes the
+// new top key and is redistributed into lower buckets. An element only ever moves to a lower bucket, so it is moved at
+// most once per bit of the key: push is O(1) and pop amortized O(log C), C being the key range, with no comparisons
+// between elements.
+//
+// Float and double keys are supported through an order-preserving map to unsigned integers; NaN keys are not.
+// If growing a bucket throws during top() or pop(), the heap is left as it was, provided Value's moves don't throw.
+template <radix_heap_key Key, typename Value, typename Allocator = std::allocator<std::pair<Key, Value>>>
+class radix_heap {
+    using key_traits = detail::radix_key_traits<Key>;
+    using bits_type = typename key_traits::bits_type;
+
+public:
+    // =========================
+    // Member type aliases
+    // =========================
+    using size_type = std::size_t;
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using const_reference = const value_type&;
+    using allocator_type = Allocator;
+
+private:
+    using bucket_type = systems_dsa::vector<value_type, Allocator>;
+    static constexpr size_type bucketCount { std::numeric_limits<bits_type>::digits + 1 };
+
+public:
+    // =========================
+    // Constructors
+    // =========================
+    radix_heap() : radix_heap(Allocator()) {}
+
+    explicit radix_heap(const Allocator& alloc)
+        : m_buckets { [&]<std::size_t... I>(std::index_sequence<I...>) {
+            return std::array<bucket_type, bucketCount> { ((void)I, bucket_type(alloc))... };
+        }(std::make_index_sequence<bucketCount> {}) }
+    {}
+
+    allocator_type get_allocator() const noexcept {
+        return m_buckets[0].get_allocator();
+    }
+
+    // =========================
+    // Capacity (empty, size)
+    // =========================
+    bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    size_type size() const noexcept {
+        return m_size;
+    }
+
+    // =========================
+    // Element access (top)
+    // =========================
+
+    // The element with the smallest key. Not const: when bucket 0 is empty, finding the top redistributes the lowest
+    // non-empty bucket, and raises the bound on keys that may be pushed to the top key.
+    const_reference top() {
+        assert(!empty());
+        refillTopBucket();
+        return m_buckets[0].back();
+    }
+
+    // =========================
+    // Modifiers (push, emplace, pop)
+    // =========================
+    void push(const value_type& val) {
+        emplace(val.first, val.second);
+    }
+
+    void push(value_type&& val) {
+        emplace(val.first, std::move(val.second));
+    }
+
+    // Constructs the Value from `args`. Requires `key` to be at least the last top key.
+    template <typename... Args>
+    void emplace(Key key, Args&&... args) {
+        const bits_type bits { key_traits::encode(key) };
+        assert(bits >= m_lastBits && "emplace() of a key below the last top key");
+        m_buckets[bucketIndex(bits)].emplace_back(std::piecewise_construct, std::forward_as_tuple(key),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+        ++m_size;
+        RHEAP_ASSERT_VALID();
+    }
+
+    void pop() {
+        assert(!empty());
+        refillTopBucket();
+        m_buckets[0].pop_back();
+        --m_size;
+        RHEAP_ASSERT_VALID();
+    }
+
+    // Also resets the bound on pushed keys, so any key may be pushed afterwards
+    void clear() noexcept {
+        for (bucket_type& bucket : m_buckets) {
+            bucket.clear();
+        }
+        m_size = 0;
+        m_lastBits = 0;
+    }
+
+private:
+    // =========================
+    // Data members
+    // =========================
+    std::array<bucket_type, bucketCount> m_buckets;
+    size_type m_size {};
+    // The encoded last top key, the lower bound of every key in the heap
+    bits_type m_lastBits {};
+
+    size_type bucketIndex(bits_type bits) const noexcept {
+        return static_cast<size_type>(std::bit_width(static_cast<bits_type>(bits ^ m_lastBits)));
+    }
+
+    // If bucket 0 is empty, makes the smallest key in the lowest non-empty bucket the new last top key and moves that
+    // bucket's elements down to the buckets their keys now map to. All of them land below it, at least one in bucket 0.
+    void refillTopBucket() {
+        if (!m_buckets[0].empty()) {
+            return;
+        }
+        size_type source { 1 };
+        while (m_buckets[source].empty()) {
+            ++source;
+        }
+        bucket_type& bucket { m_buckets[source] };
+
+        bits_type minBits { std::numeric_limits<bits_type>::max() };
+        for (const value_type& entry : bucket) {
+            minBits = std::min(minBits, key_traits::encode(entry.first));
+        }
+        const bits_type previousBits { m_lastBits };
+        m_lastBits = minBits;
+
+        size_type moved {};
+        try {
+            for (; moved < bucket.size(); ++moved) {
+                value_type& entry { bucket[moved] };
+                m_buckets[bucketIndex(key_traits::encode(entry.first))].push_back(std::move(entry));
+            }
+        } catch (...) {
+            // Every bucket below `source` was empty, so what they hold now is exactly the elements already moved out.
+            // Move them back into the slots they left and restore the previous top key.
+            size_type slot {};
+            for (size_type i {}; i < source; ++i) {
+                for (value_type& entry : m_buckets[i]) {
+                    bucket[slot++] = std::move(entry);
+                }
+                m_buckets[i].clear();
+            }
+            m_lastBits = previousBits;
+            throw;
+        }
+        bucket.clear();
+    }
+
+#ifndef NDEBUG
+    void assertValid() const {
+        size_type count {};
+        for (size_type i {}; i < bucketCount; ++i) {
+            for (const value_type& entry : m_buckets[i]) {
+                const bits_type bits { key_traits::encode(entry.first) };
+                assert(bits >= m_lastBits && "assertValid() detected a key below the last top key");
+                assert(bucketIndex(bits) == i && "assertValid() detected an element in the wrong bucket");
+            }
+            count += m_buckets[i].size();
+        }
+        assert(count == m_size && "assertValid() detected a size mismatch");
+    }
+#endif
+};
+
+namespace pmr {
+    template <radix_heap_key Key, typename Value>
+    using radix_heap = systems_dsa::radix_heap<Key, Value, std::pmr::polymorphic_allocator<std::pair<Key, Value>>>;
+}
+
+}
@@ -0,0 +1,579 @@
+#pragma once
+#include <systems_dsa/vector.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#ifndef NDEBUG
+#define SVEC_ASSERT_VALID() assertValid();
+#else
+#define SVEC_ASSERT_VALID() (void(0))
+#endif
+
+namespace systems_dsa {
+    // A vector that keeps up to N elements in storage inside the object, and only allocates from `Allocator` once it
+    // grows past N. Growth past N follows `GrowthPolicy`, and reallocation relocates elements the same way vector
+    // does (detail::relocateElements), trivially relocatable ones with a single memcpy.
+    // Moving a small_vector whose elements are inline moves them one by one, so unlike vector, a move invalidates
+    // pointers into the source.
+    template <typename T, std::size_t N, typename Allocator = std::allocator<T>,
+        typename GrowthPolicy = one_and_half_growth_policy>
+    requires ValidGrowthPolicy<GrowthPolicy>
+    class small_vector {
+        static_assert(N > 0, "A small_vector needs room for at least one inline element, use vector otherwise");
+        static_assert(std::is_same_v<typename std::allocator_traits<Allocator>::value_type, T>,
+            "Allocator::value_type must match the small_vector's value_type");
+        using alloc_traits = std::allocator_traits<Allocator>;
+    public:
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using allocator_type = Allocator;
+        using growth_policy = GrowthPolicy;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        constexpr static size_type inline_capacity { N };
+
+    // ---------------------
+    // Constructors / Destructor
+    // ---------------------
+        // Default constructor, starts on the inline storage
+        small_vector() : small_vector(Allocator()) {}
+
+        explicit small_vector(const Allocator& alloc) noexcept : m_alloc { alloc } {}
+
+        // Constructor with size, reserves `n` elements without constructing any. Only allocates if n > N.
+        explicit small_vector(size_type n, const Allocator& alloc = Allocator()) : m_alloc { alloc } {
+            reserve(n);
+            SVEC_ASSERT_VALID();
+        }
+
+        small_vector(std::initializer_list<value_type> list, const Allocator& alloc = Allocator()) : m_alloc { alloc } {
+            reserve(list.size());
+            appendFrom<false>(list.begin(), list.size());
+            SVEC_ASSERT_VALID();
+        }
+
+        // Copy constructor
+        small_vector(const small_vector& other)
+            : small_vector(other, alloc_traits::select_on_container_copy_construction(other.m_alloc)) {}
+
+        small_vector(const small_vector& other, const Allocator& alloc) : m_alloc { alloc } {
+            reserve(other.size());
+            appendFrom<false>(other.m_data, other.size());
+            SVEC_ASSERT_VALID();
+        }
+
+        // Copy assignment
+        small_vector& operator=(const small_vector& other) {
+            if (&other == this) {
+                return *this;
+            }
+
+            releaseStorage();
+            if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+                m_alloc = other.m_alloc;
+            }
+            reserve(other.size());
+            appendFrom<false>(other.m_data, other.size());
+            SVEC_ASSERT_VALID();
+            return *this;
+        }
+
+        // Move constructor, takes over a heap block, inline elements are relocated into this one's inline storage
+        small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+            : m_alloc { std::move(other.m_alloc) } {
+            takeFrom(other);
+            SVEC_ASSERT_VALID();
+        }
+
+        // Only takes over a heap block if `alloc` can free it, otherwise the elements are moved one by one
+        small_vector(small_vector&& other, const Allocator& alloc) : m_alloc { alloc } {
+            if (other.is_inline() || m_alloc == other.m_alloc) {
+                takeFrom(other);
+            } else {
+                moveFrom(other);
+            }
+            SVEC_ASSERT_VALID();
+        }
+
+        // Move assignment
+        small_vector& operator=(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>
+            && (alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value)) {
+            if (&other == this) {
+                return *this;
+            }
+
+            releaseStorage();
+            if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+                m_alloc = std::move(other.m_alloc);
+                takeFrom(other);
+            } else if (other.is_inline() || m_alloc == other.m_alloc) {
+                takeFrom(other);
+            } else {
+                // A heap block from another allocator can't be adopted
+                moveFrom(other);
+            }
+            SVEC_ASSERT_VALID();
+            return *this;
+        }
+
+        // Destructor
+        ~small_vector() {
+            releaseStorage();
+        }
+
+        allocator_type get_allocator() const noexcept {
+            return m_alloc;
+        }
+
+    // ---------------------
+    // Size & Capacity
+    // ---------------------
+        size_type size() const {
+            return m_size;
+        }
+        size_type capacity() const {
+            return m_capacity;
+        }
+        bool empty() const {
+            return m_size == 0;
+        }
+        // Whether the elements are in the inline storage, i.e. nothing is allocated
+        bool is_inline() const noexcept {
+            return m_data == inlineData();
+        }
+
+        // Allocates exactly `newCapacity`, does nothing if the capacity is already at least that
+        void reserve(size_type newCapacity) {
+            if (newCapacity <= m_capacity) {
+                return;
+            }
+            reallocate(newCapacity);
+            SVEC_ASSERT_VALID();
+        }
+
+        void resize(size_type newSize) {
+            if (newSize < m_size) {
+                destroyData(m_data + newSize, m_size - newSize);
+                m_size = newSize;
+            } else if (newSize > m_size) {
+                // Reallocating to exactly newSize if it doesn't fit
+                reserve(newSize);
+                for (size_type i { m_size }; i < newSize; ++i) {
+                    alloc_traits::construct(m_alloc, m_data + i);
+                    ++m_size;
+                }
+            }
+            SVEC_ASSERT_VALID();
+        }
+
+        // Moves the elements back inline once they fit there again. Otherwise, like vector's, it's a suggestion that's
+        // only taken when more than half of the heap block is unused.
+        void shrink_to_fit() {
+            if (is_inline()) {
+                return;
+            }
+            if (m_size <= N) {
+                T* heapData { m_data };
+                const size_type heapCapacity { m_capacity };
+                detail::relocateElements(m_alloc, heapData, m_size, inlineData());
+                m_data = inlineData();
+                m_capacity = N;
+                alloc_traits::deallocate(m_alloc, heapData, heapCapacity);
+            } else if (m_capacity > m_size * 2) {
+                reallocate(m_size);
+            }
+            SVEC_ASSERT_VALID();
+        }
+
+    // ---------------------
+    // Element Access
+    // ---------------------
+
+        // operator[]
+        const_reference operator[](size_type index) const {
+            return m_data[index];
+        }
+        reference operator[](size_type index) {
+            return m_data[index];
+        }
+
+        // at()
+        const_reference at(size_type index) const {
+            if (index < m_size) {
+                return m_data[index];
+            }
+            throw std::out_of_range("Small vector index out of bounds\n");
+        }
+        reference at(size_type index) {
+            if (index < m_size) {
+                return m_data[index];
+            }
+            throw std::out_of_range("Small vector index out of bounds\n");
+        }
+
+        // front()
+        const_reference front() const {
+            return m_data[0];
+        }
+        reference front() {
+            return m_data[0];
+        }
+
+        // back()
+        const_reference back() const {
+            return m_data[m_size - 1];
+        }
+        reference back() {
+            return m_data[m_size - 1];
+        }
+
+        // data(), inline storage or the heap block
+        T* data() noexcept {
+            return m_data;
+        }
+        const T* data() const noexcept {
+            return m_data;
+        }
+
+    // ---------------------
+    // Pushing & popping
+    // ---------------------
+        void push_back(const value_type& value) {
+            emplace_back(value);
+        }
+
+        void push_back(value_type&& value) {
+            emplace_back(std::move(value));
+        }
+
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
+            if (m_size == m_capacity) {
+                T& element { detail::emplaceGrowing<GrowthPolicy>(m_alloc, m_data, m_size, m_capacity, blockReleaser(),
+                    std::forward<Args>(args)...) };
+                SVEC_ASSERT_VALID();
+                return element;
+            }
+            alloc_traits::construct(m_alloc, m_data + m_size, std::forward<Args>(args)...);
+            ++m_size;
+            SVEC_ASSERT_VALID();
+            return m_data[m_size - 1];
+        }
+
+        void pop_back() noexcept(std::is_nothrow_destructible_v<T>) {
+            destroyData(m_data + m_size - 1, 1);
+            --m_size;
+            SVEC_ASSERT_VALID();
+        }
+
+        // Keeps the capacity, including a heap block
+        void clear() {
+            destroyData(m_data, m_size);
+            m_size = 0;
+        }
+
+    // ---------------------
+    // Bulk modifiers
+    // ---------------------
+        // Same as vector's: with a known length, capacity grows at most once (the first spill included), otherwise it's
+        // an emplace_back per element
+        template <std::ranges::input_range R>
+        void append_range(R&& range) {
+            if constexpr (std::ranges::forward_range<R> || std::ranges::sized_range<R>) {
+                const auto count { static_cast<size_type>(std::ranges::distance(range)) };
+                detail::appendElements<GrowthPolicy>(m_alloc, m_data, m_size, m_capacity, blockReleaser(),
+                    std::ranges::begin(range), count);
+            } else {
+                for (auto&& element : range) {
+                    emplace_back(std::forward<decltype(element)>(element));
+                }
+            }
+            SVEC_ASSERT_VALID();
+        }
+
+        // Replaces the contents with `range`. Storage is reused if it's big enough, a heap block included, otherwise
+        // it's replaced by a heap block of exactly the new size.
+        template <std::ranges::input_range R>
+        void assign_range(R&& range) {
+            clear();
+            if constexpr (std::ranges::forward_range<R> || std::ranges::sized_range<R>) {
+                const auto count { static_cast<size_type>(std::ranges::distance(range)) };
+                reserve(count);
+                detail::constructElements(m_alloc, m_data, std::ranges::begin(range), count);
+                m_size = count;
+            } else {
+                append_range(std::forward<R>(range));
+            }
+            SVEC_ASSERT_VALID();
+        }
+
+        template <std::input_iterator It, std::sentinel_for<It> S>
+        void assign(It first, S last) {
+            assign_range(std::ranges::subrange(std::move(first), std::move(last)));
+        }
+
+        void assign(std::initializer_list<value_type> list) {
+            assign_range(list);
+        }
+
+        // Like std::vector's, `value` must not be an element of this small_vector
+        void assign(size_type count, const value_type& value) {
+            clear();
+            reserve(count);
+            for (; m_size < count; ++m_size) {
+                alloc_traits::construct(m_alloc, m_data + m_size, value);
+            }
+            SVEC_ASSERT_VALID();
+        }
+
+        // Inserts `range` before `pos` and returns an iterator to the first inserted element, the same way vector's
+        // does (detail::insertElements): a spill to the heap moves trivially relocatable elements straight into their
+        // places in the new block.
+        template <std::ranges::input_range R>
+        iterator insert_range(const_iterator pos, R&& range) {
+            const auto index { static_cast<size_type>(pos - m_data) };
+            assert(index <= m_size && "Insert position is not in this small_vector");
+            const size_type oldSize { m_size };
+            if constexpr (std::ranges::forward_range<R> || std::ranges::sized_range<R>) {
+                const auto count { static_cast<size_type>(std::ranges::distance(range)) };
+                detail::insertElements<GrowthPolicy>(m_alloc, m_data, m_size, m_capacity, blockReleaser(), index,
+                    std::ranges::begin(range), count);
+            } else {
+                try {
+                    for (auto&& element : range) {
+                        emplace_back(std::forward<decltype(element)>(element));
+                    }
+                } catch (...) {
+                    destroyData(m_data + oldSize, m_size - oldSize);
+                    m_size = oldSize;
+                    throw;
+                }
+                std::rotate(m_data + index, m_data + oldSize, m_data + m_size);
+            }
+            SVEC_ASSERT_VALID();
+            return m_data + index;
+        }
+
+        template <std::input_iterator It, std::sentinel_for<It> S>
+        iterator insert(const_iterator pos, It first, S last) {
+            return insert_range(pos, std::ranges::subrange(std::move(first), std::move(last)));
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<value_type> list) {
+            return insert_range(pos, list);
+        }
+
+        // Erases [first, last) and returns an iterator to the element that followed them. Keeps the capacity, like
+        // clear(). Trivially relocatable elements after the range are shifted down with one memmove, others are
+        // move-assigned down.
+        iterator erase(const_iterator first, const_iterator last) {
+            const auto from { static_cast<size_type>(first - m_data) };
+            const auto to { static_cast<size_type>(last - m_data) };
+            assert(from <= to && to <= m_size && "Erase range is not in this small_vector");
+            if (from == to) {
+                return m_data + from;
+            }
+            detail::eraseElements(m_alloc, m_data, m_size, from, to);
+            SVEC_ASSERT_VALID();
+            return m_data + from;
+        }
+
+        iterator erase(const_iterator pos) {
+            return erase(pos, pos + 1);
+        }
+
+        // Like resize, but new elements are default-initialized instead of value-initialized, so trivial types are
+        // left uninitialized for the caller to overwrite. Allocators with their own construct() still value-initialize.
+        void resize_for_overwrite(size_type newSize) {
+            if (newSize <= m_size) {
+                resize(newSize);
+                return;
+            }
+            reserve(newSize);
+            if constexpr (detail::plainConstruct<T, Allocator>) {
+                std::uninitialized_default_construct(m_data + m_size, m_data + newSize);
+                m_size = newSize;
+            } else {
+                for (; m_size < newSize; ++m_size) {
+                    alloc_traits::construct(m_alloc, m_data + m_size);
+                }
+            }
+            SVEC_ASSERT_VALID();
+        }
+
+        // Swaps heap blocks in O(1). Inline elements are relocated through a temporary, so like a move, swapping
+        // invalidates pointers into inline storage, and if relocating throws, the elements of both are valid but
+        // unspecified. Allocators are swapped if they propagate on swap, otherwise they must be equal.
+        void swap(small_vector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+            if (&other == this) {
+                return;
+            }
+            if constexpr (!alloc_traits::propagate_on_container_swap::value) {
+                assert(m_alloc == other.m_alloc && "swap() of small_vectors whose unequal allocators don't propagate");
+            }
+            small_vector temp { m_alloc };
+            temp.takeFrom(*this);
+            if constexpr (alloc_traits::propagate_on_container_swap::value) {
+                m_alloc = other.m_alloc;
+                other.m_alloc = temp.m_alloc;
+            }
+            takeFrom(other);
+            other.takeFrom(temp);
+            SVEC_ASSERT_VALID();
+        }
+
+        friend void swap(small_vector& lhs, small_vector& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+            lhs.swap(rhs);
+        }
+
+    // ---------------------
+    // Iteration
+    // ---------------------
+        iterator begin() {
+            return m_data;
+        }
+        const_iterator begin() const {
+            return m_data;
+        }
+
+        iterator end() {
+            return m_data + m_size;
+        }
+        const_iterator end() const {
+            return m_data + m_size;
+        }
+
+        const_iterator cbegin() const noexcept {
+            return begin();
+        }
+        const_iterator cend() const noexcept {
+            return end();
+        }
+
+    private:
+        size_type m_capacity { N };
+        size_type m_size {};
+        T* m_data { inlineData() };
+        [[no_unique_address]] Allocator m_alloc;
+        alignas(T) std::byte m_inline[N * sizeof(T)];
+
+        constexpr static bool copiesBitwise { detail::copiesBitwise<T, Allocator> };
+
+        T* inlineData() noexcept {
+            return reinterpret_cast<T*>(m_inline);
+        }
+        const T* inlineData() const noexcept {
+            return reinterpret_cast<const T*>(m_inline);
+        }
+
+        // Moves the elements to a heap block of exactly `capacity`, freeing the old one if it was on the heap
+        void reallocate(size_type capacity) {
+            assert(capacity > N && capacity >= m_size);
+            detail::reallocateElements(m_alloc, m_data, m_size, m_capacity, blockReleaser(), capacity);
+        }
+
+        // Frees a block for the growth steps in detail, see detail::reallocateElements. The inline storage is kept.
+        auto blockReleaser() noexcept {
+            return [this](T* data, size_type capacity) noexcept {
+                if (data != inlineData()) {
+                    alloc_traits::deallocate(m_alloc, data, capacity);
+                }
+            };
+        }
+
+        // Destroys the elements and frees a heap block, leaving this empty on its inline storage
+        void releaseStorage() noexcept {
+            destroyData(m_data, m_size);
+            if (!is_inline()) {
+                alloc_traits::deallocate(m_alloc, m_data, m_capacity);
+            }
+            m_data = inlineData();
+            m_capacity = N;
+            m_size = 0;
+        }
+
+        // Takes over other's heap block, or relocates its inline elements into ours. This must be empty and inline,
+        // and m_alloc must be able to free other's block. Leaves other empty and inline.
+        void takeFrom(small_vector& other) {
+            assert(is_inline() && m_size == 0);
+            if (other.is_inline()) {
+                detail::relocateElements(m_alloc, other.m_data, other.m_size, inlineData());
+                m_size = std::exchange(other.m_size, 0);
+            } else {
+                m_data = std::exchange(other.m_data, other.inlineData());
+                m_capacity = std::exchange(other.m_capacity, N);
+                m_size = std::exchange(other.m_size, 0);
+            }
+        }
+
+        // Moves other's elements one by one into storage from m_alloc
+        void moveFrom(small_vector& other) {
+            assert(is_inline() && m_size == 0);
+            reserve(other.size());
+            appendFrom<true>(other.m_data, other.size());
+            other.clear();
+        }
+
+        // Appends `count` elements of `src` into storage that has room for them. Each one is copied, or moved if `Move`,
+        // unless T is trivially copyable, then they're all copied in one memcpy.
+        // If a copy throws, the storage is released, since this runs in constructors whose destructor won't.
+        template <bool Move>
+        void appendFrom(std::conditional_t<Move, T*, const T*> src, size_type count) {
+            assert(m_size + count <= m_capacity);
+            if constexpr (copiesBitwise) {
+                if (count > 0) {
+                    std::memcpy(static_cast<void*>(m_data + m_size), static_cast<const void*>(src), count * sizeof(T));
+                }
+                m_size += count;
+            } else {
+                try {
+                    for (size_type i {}; i < count; ++i) {
+                        if constexpr (Move) {
+                            alloc_traits::construct(m_alloc, m_data + m_size, std::move(src[i]));
+                        } else {
+                            alloc_traits::construct(m_alloc, m_data + m_size, src[i]);
+                        }
+                        ++m_size;
+                    }
+                } catch (...) {
+                    releaseStorage();
+                    throw;
+                }
+            }
+        }
+
+        void destroyData(T* data, size_type size) noexcept(std::is_nothrow_destructible_v<T>) {
+            detail::destroyElements(m_alloc, data, size);
+        }
+
+    #ifndef NDEBUG
+        void assertValid() {
+            assert(m_capacity >= m_size);
+            assert(m_capacity >= N);
+            // A heap block is only ever allocated for more than N elements
+            assert(is_inline() == (m_capacity == N));
+        }
+    #endif
+    };
+
+    namespace pmr {
+        template <typename T, std::size_t N, typename GrowthPolicy = one_and_half_growth_policy>
+        using small_vector = systems_dsa::small_vector<T, N, std::pmr::polymorphic_allocator<T>, GrowthPolicy>;
+    }
+}
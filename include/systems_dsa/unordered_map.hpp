@@ -1,7 +1,36 @@
 #pragma once
 #include <systems_dsa/vector.hpp>
+#include <algorithm>
+#include <bit>
+#include <cmath>
 #include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
 #include <new>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SYSTEMS_DSA_HM_SSE2 1
+#endif
+
+// Opt-in instrumentation (CMake: -DSYSTEMS_DSA_HM_STATS=ON). Every translation unit of a program must agree on it.
+#ifdef SYSTEMS_DSA_HM_STATS
+#include <array>
+#include <atomic>
+#include <chrono>
+#endif
 
 // "DONE" Checklist
 // TODO: spec cleanup
@@ -15,14 +44,255 @@ namespace systems_dsa {
 #define HM_ASSERT_VALID() ((void)0)
 #endif
 
+#ifdef SYSTEMS_DSA_HM_STATS
+#define HM_RECORD_PROBE(hit, length) m_counters.recordProbe(hit, length)
+#else
+#define HM_RECORD_PROBE(hit, length) ((void)0)
+#endif
+
+namespace detail {
+    // One control byte per bucket, stored apart from the payload so probing only touches payloads on a tag match.
+    // FILLED buckets hold a 7-bit tag of the hash (0..127); OPEN and TOMBSTONE have the high bit set.
+    using ctrl_t = std::int8_t;
+    inline constexpr ctrl_t ctrlOpen { -128 };
+    inline constexpr ctrl_t ctrlTombstone { -2 };
+
+    inline bool isFilled(ctrl_t ctrl) noexcept {
+        return ctrl >= 0;
+    }
+
+    // A window of `width` consecutive control bytes, compared all at once.
+    // Every match returns a bitmask where bit i corresponds to the i-th bucket of the window.
+    class Group {
+    public:
+        constexpr static std::size_t width { 16 };
+
+        explicit Group(const ctrl_t* pos) noexcept {
+#ifdef SYSTEMS_DSA_HM_SSE2
+            m_ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+#else
+            std::memcpy(m_ctrl, pos, width);
+#endif
+        }
+
+        std::uint32_t match(ctrl_t tag) const noexcept {
+#ifdef SYSTEMS_DSA_HM_SSE2
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), m_ctrl)));
+#else
+            std::uint32_t mask {};
+            for (std::size_t i {}; i < width; ++i) {
+                mask |= static_cast<std::uint32_t>(m_ctrl[i] == tag) << i;
+            }
+            return mask;
+#endif
+        }
+
+        std::uint32_t matchOpen() const noexcept {
+            return match(ctrlOpen);
+        }
+
+        // OPEN or TOMBSTONE, i.e. every bucket available for insertion
+        std::uint32_t matchFree() const noexcept {
+#ifdef SYSTEMS_DSA_HM_SSE2
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(m_ctrl));
+#else
+            std::uint32_t mask {};
+            for (std::size_t i {}; i < width; ++i) {
+                mask |= static_cast<std::uint32_t>(!isFilled(m_ctrl[i])) << i;
+            }
+            return mask;
+#endif
+        }
+
+    private:
+#ifdef SYSTEMS_DSA_HM_SSE2
+        __m128i m_ctrl;
+#else
+        ctrl_t m_ctrl[width];
+#endif
+    };
+
+    inline void prefetch(const void* addr) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(addr);
+#elif defined(SYSTEMS_DSA_HM_SSE2)
+        _mm_prefetch(static_cast<const char*>(addr), _MM_HINT_T0);
+#endif
+    }
+
+#ifdef SYSTEMS_DSA_HM_STATS
+    // Counters recorded as the map is used, the rest of unordered_map_stats is computed when it's requested
+    struct HashMapCounters {
+        constexpr static std::size_t histogramBins { 32 };
+        std::array<std::uint64_t, histogramBins> hitProbes {};
+        std::array<std::uint64_t, histogramBins> missProbes {};
+        std::uint64_t rehashCount {};
+        std::chrono::nanoseconds rehashTime {};
+
+        // Lookups run under shared locks in concurrent_unordered_map, so the histograms are bumped atomically
+        void recordProbe(bool hit, std::size_t length) noexcept {
+            auto& histogram { hit ? hitProbes : missProbes };
+            const std::size_t bin { std::min(length, histogramBins) - 1 };
+            std::atomic_ref<std::uint64_t> { histogram[bin] }.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+#endif
+
+    // Finalizer applied before masking, so identity hashes (std::hash<int>) and hashes that only vary in their high
+    // bits still spread over the low bits a power-of-two mask keeps
+    inline std::size_t mixHash(std::size_t hashedKey) noexcept {
+        std::uint64_t x { hashedKey };
+        x ^= x >> 32;
+        x *= 0xd6e8feb86659fd93ull;
+        x ^= x >> 32;
+        return static_cast<std::size_t>(x);
+    }
+}
+
+//////////////////////
+// Bucket policies  //
+//////////////////////
+
+// A bucket policy decides which bucket counts the table may use, and maps a hash to its home bucket.
+
+// Any bucket count, home bucket is hash % bucket count
+struct modulo_bucket_policy {
+    static std::size_t bucket_count(std::size_t requested) noexcept {
+        return requested;
+    }
+    static std::size_t index(std::size_t hashedKey, std::size_t bucketCount) noexcept {
+        return hashedKey % bucketCount;
+    }
+};
+
+// Bucket counts are rounded up to a power of two, so the home bucket is a mask of the mixed hash instead of a division
+struct power_of_two_bucket_policy {
+    static std::size_t bucket_count(std::size_t requested) noexcept {
+        return std::bit_ceil(requested);
+    }
+    static std::size_t index(std::size_t hashedKey, std::size_t bucketCount) noexcept {
+        assert(std::has_single_bit(bucketCount) && "bucketCount is not a power of two");
+        return detail::mixHash(hashedKey) & (bucketCount - 1);
+    }
+};
+
+//////////////////////
+// Probe policies   //
+//////////////////////
+
+// A probe policy decides how collisions are laid out in the table.
+
+// Linear probing a Group at a time, erase leaves a TOMBSTONE behind
+struct linear_probe_policy {
+    constexpr static bool robin_hood { false };
+};
+
+// Robin Hood probing: an insert takes the bucket of the first element closer to its home bucket than the new one
+// would be, so every run stays ordered by home bucket and displacements stay short and even.
+// Erase shifts the rest of the run one bucket back instead of leaving a TOMBSTONE, so none are ever created.
+struct robin_hood_probe_policy {
+    constexpr static bool robin_hood { true };
+};
+
+//////////////////////////
+// Hash cache policies  //
+//////////////////////////
+
+// A hash cache policy decides, per key type, whether each bucket also stores its element's full hash.
+// With it, rehash reuses the stored hashes instead of calling the hasher again, and lookups only call the key equality
+// once the full hash matches. It costs a std::size_t per bucket.
+
+struct cache_hash_policy {
+    template <typename K>
+    constexpr static bool cache_hash { true };
+};
+
+struct no_hash_cache_policy {
+    template <typename K>
+    constexpr static bool cache_hash { false };
+};
+
+// Caches the hash of keys that aren't trivially copyable (strings, containers, composites holding them), where hashing
+// and comparing keys cost far more than the extra word per bucket
+struct auto_hash_cache_policy {
+    template <typename K>
+    constexpr static bool cache_hash { !std::is_trivially_copyable_v<K> };
+};
+
+#ifdef SYSTEMS_DSA_HM_STATS
+// Snapshot returned by unordered_map::stats()
+struct unordered_map_stats {
+    constexpr static std::size_t histogramBins { detail::HashMapCounters::histogramBins };
+
+    // Lookups by probe length, in buckets from the home bucket to the key (hits) or to the first OPEN bucket (misses).
+    // Bin i counts probes of length i + 1, the last bin also counts every longer probe.
+    std::array<std::uint64_t, histogramBins> hit_probes {};
+    std::array<std::uint64_t, histogramBins> miss_probes {};
+
+    // Distance of each element from its home bucket
+    std::size_t max_displacement {};
+    double mean_displacement {};
+
+    double load_factor {};
+    double tombstone_ratio {};
+
+    std::uint64_t rehash_count {};
+    std::chrono::nanoseconds rehash_time {};
+
+    // Pearson's chi-squared of elements per home bucket against an even spread. A good hasher lands near the degrees
+    // of freedom (bucket count - 1); home_chi_squared_z is the distance from there in standard deviations, so more
+    // than a few units above 0 flags a hasher that clusters keys.
+    double home_chi_squared {};
+    double home_chi_squared_z {};
+};
+#endif
+
 template <typename H, typename K>
 concept ValidHasher =
     std::regular_invocable<H, const K&> &&
         std::convertible_to<std::invoke_result_t<H, const K&>, std::size_t>;
 
-template <typename Eq, typename K>
+// `KeyLike` is what lookups are called with, compared against stored keys
+template <typename Eq, typename K, typename KeyLike = K>
 concept ValidKeyEqual =
-    std::predicate<Eq, const K&, const K&>;
+    std::predicate<Eq, const K&, const KeyLike&>;
+
+// Heterogeneous lookup: when both the hasher and the key equality declare `is_transparent`, lookups accept any
+// `KeyLike` they can hash and compare against K, without constructing a K. Equal keys must hash equally across types.
+template <typename Hasher, typename KeyEqual, typename K, typename KeyLike>
+concept TransparentLookup =
+    requires {
+        typename Hasher::is_transparent;
+        typename KeyEqual::is_transparent;
+    } &&
+    ValidHasher<Hasher, KeyLike> &&
+    ValidKeyEqual<KeyEqual, K, KeyLike>;
+
+// Transparent hasher for string keys. std::string, std::string_view and const char* all hash as a std::string_view,
+// so paired with std::equal_to<> lookups never materialize a std::string.
+struct string_hash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view str) const noexcept {
+        return std::hash<std::string_view> {}(str);
+    }
+};
+
+template <typename P>
+concept ValidBucketPolicy = requires(std::size_t n) {
+    { P::bucket_count(n) } -> std::convertible_to<std::size_t>;
+    { P::index(n, n) } -> std::convertible_to<std::size_t>;
+};
+
+template <typename P>
+concept ValidProbePolicy = requires {
+    { P::robin_hood } -> std::convertible_to<bool>;
+};
+
+template <typename P, typename K>
+concept ValidHashCachePolicy = requires {
+    { P::template cache_hash<K> } -> std::convertible_to<bool>;
+};
 
 
 // Forward declaration
@@ -30,17 +300,55 @@ template <
     typename K,
     typename V,
     class Hasher = std::hash<K>,
-    class KeyEqual = std::equal_to<K>
+    class KeyEqual = std::equal_to<K>,
+    class BucketPolicy = modulo_bucket_policy,
+    class ProbePolicy = linear_probe_policy,
+    class HashCachePolicy = auto_hash_cache_policy,
+    class Allocator = std::allocator<std::pair<const K, V>>
     >
 requires ValidHasher<Hasher, K> &&
-    ValidKeyEqual<KeyEqual, K>
+    ValidKeyEqual<KeyEqual, K> &&
+    ValidBucketPolicy<BucketPolicy> &&
+    ValidProbePolicy<ProbePolicy> &&
+    ValidHashCachePolicy<HashCachePolicy, K>
 class unordered_map;
 
+// Forward declaration, befriended by unordered_map so it can drain a table bucket by bucket
+template <typename K, typename V, class Hasher, class KeyEqual, class BucketPolicy>
+requires ValidHasher<Hasher, K> &&
+    ValidKeyEqual<KeyEqual, K> &&
+    ValidBucketPolicy<BucketPolicy>
+class incremental_unordered_map;
+
+// Forward declaration, befriended by unordered_map so it can write and probe the raw table
+template <
+    typename K,
+    typename V,
+    class Hasher = std::hash<K>,
+    class KeyEqual = std::equal_to<K>,
+    class BucketPolicy = modulo_bucket_policy,
+    class ProbePolicy = linear_probe_policy,
+    class HashCachePolicy = auto_hash_cache_policy
+    >
+requires ValidHasher<Hasher, K> &&
+    ValidKeyEqual<KeyEqual, K> &&
+    ValidBucketPolicy<BucketPolicy> &&
+    ValidProbePolicy<ProbePolicy> &&
+    ValidHashCachePolicy<HashCachePolicy, K>
+class unordered_map_snapshot;
+
+// Forward declaration, befriended by unordered_map so its shards can reuse the hash that picked the shard
+template <typename K, typename V, class Hasher, class KeyEqual, class BucketPolicy>
+requires ValidHasher<Hasher, K> &&
+    ValidKeyEqual<KeyEqual, K> &&
+    ValidBucketPolicy<BucketPolicy>
+class concurrent_unordered_map;
+
 #ifndef NDEBUG
 // Forward declaration
-template <class K, class V, class Hash, class KeyEq>
+template <class K, class V, class Hash, class KeyEq, class Policy, class Probe, class HashCache, class Alloc>
 std::ostream& operator<<(std::ostream& out,
-                         const unordered_map<K, V, Hash, KeyEq>& hashMap);
+                         const unordered_map<K, V, Hash, KeyEq, Policy, Probe, HashCache, Alloc>& hashMap);
 #endif
 
 // Start of class
@@ -48,21 +356,35 @@ template <
     typename K,
     typename V,
     class Hasher,
-    class KeyEqual
+    class KeyEqual,
+    class BucketPolicy,
+    class ProbePolicy,
+    class HashCachePolicy,
+    class Allocator
     >
 requires ValidHasher<Hasher, K> &&
-    ValidKeyEqual<KeyEqual, K>
+    ValidKeyEqual<KeyEqual, K> &&
+    ValidBucketPolicy<BucketPolicy> &&
+    ValidProbePolicy<ProbePolicy> &&
+    ValidHashCachePolicy<HashCachePolicy, K>
 class unordered_map {
-    enum class State : uint8_t {
-        OPEN,
-        FILLED,
-        TOMBSTONE,
-    };
+    using ctrl_t = detail::ctrl_t;
+    using Group = detail::Group;
     using value_type = std::pair<const K, V>;
+    // The control bytes, buckets and displacements are each allocated through a rebound copy of the allocator
+    template <typename T>
+    using rebound_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+    using alloc_traits = std::allocator_traits<Allocator>;
+    constexpr static bool cachesHash { HashCachePolicy::template cache_hash<K> };
+    struct NoHash {};
     struct Bucket {
         // Data
-        State state = State::OPEN;
         alignas(value_type) std::byte storage[sizeof(value_type)]; // Uninitialized memory
+        // Full hash of the element, only meaningful while the bucket is FILLED
+        [[no_unique_address]] std::conditional_t<cachesHash, std::size_t, NoHash> hash;
+
+        // User-provided, so value-initialization in vector::resize leaves storage untouched instead of zeroing it
+        Bucket() noexcept {}
 
         // Member functions
         value_type* ptr() noexcept {
@@ -72,22 +394,41 @@ class unordered_map {
             return std::launder(reinterpret_cast<const value_type*>(storage));
         }
         const K& key() noexcept {
-            assert(state == State::FILLED);
             return ptr()->first;
         }
         V& val() noexcept {
-            assert(state == State::FILLED);
             return ptr()->second;
         }
         const K& key() const noexcept {
-            assert(state == State::FILLED);
             return ptr()->first;
         }
         const V& val() const noexcept {
-            assert(state == State::FILLED);
             return ptr()->second;
         }
     };
+    struct NoDisplacements {
+        explicit NoDisplacements(const Allocator&) noexcept {}
+    };
+    using Displacements = std::conditional_t<ProbePolicy::robin_hood,
+        vector<std::uint32_t, rebound_allocator<std::uint32_t>>, NoDisplacements>;
+    struct Table {
+        // ctrl holds bucket count + Group::width - 1 bytes, the tail mirrors the head so a Group can be
+        // loaded at any index without wrapping
+        vector<ctrl_t, rebound_allocator<ctrl_t>> ctrl;
+        vector<Bucket, rebound_allocator<Bucket>> buckets;
+        // Robin Hood only: distance of each FILLED bucket from its element's home bucket
+        [[no_unique_address]] Displacements dist;
+
+        explicit Table(const Allocator& alloc)
+            : ctrl { rebound_allocator<ctrl_t>(alloc) }
+            , buckets { rebound_allocator<Bucket>(alloc) }
+            , dist { Displacements(alloc) }
+        {}
+
+        std::size_t size() const noexcept {
+            return buckets.size();
+        }
+    };
     template <bool isConst>
     class iterator_impl;
 public:
@@ -97,155 +438,479 @@ private:
     //////////////////
     // Data Members //
     //////////////////
-    vector<Bucket> m_buckets {};
+    Table m_table;
     std::size_t m_tombstones {};
     std::size_t m_filled {};
     Hasher m_hasher;
     KeyEqual m_eq;
+#ifdef SYSTEMS_DSA_HM_STATS
+    mutable detail::HashMapCounters m_counters {};
+#endif
     constexpr static float maxLoadFactor { 0.7f };
-    constexpr static std::size_t sentinelIndex { std::numeric_limits<std::size_t>::max() }; // TODO: Refactor to using m_buckets.size()
+    constexpr static std::size_t sentinelIndex { std::numeric_limits<std::size_t>::max() }; // TODO: Refactor to using m_table.size()
 
     // Member functions
     double getLoadFactor(std::size_t additions = 0) const {
-        assert(!m_buckets.empty());
-        return static_cast<double>(m_tombstones + m_filled + additions) / static_cast<double>(m_buckets.size());
+        assert(m_table.size() > 0);
+        return static_cast<double>(m_tombstones + m_filled + additions) / static_cast<double>(m_table.size());
+    }
+
+    // `count` is rounded to a bucket count the policy allows
+    static Table makeTable(std::size_t count, const Allocator& alloc) {
+        count = BucketPolicy::bucket_count(count);
+        Table table { alloc };
+        table.buckets.resize(count);
+        table.ctrl.resize(count + Group::width - 1);
+        for (std::size_t i {}; i < table.ctrl.size(); ++i) {
+            table.ctrl[i] = detail::ctrlOpen;
+        }
+        if constexpr (ProbePolicy::robin_hood) {
+            table.dist.resize(count);
+        }
+        return table;
+    }
+
+    // Elements are constructed and destroyed through the allocator, so a pmr map passes its resource on to pmr keys
+    // and values
+    template <typename... Args>
+    static void constructElement(Table& table, std::size_t index, Args&&... args) {
+        Allocator alloc(table.buckets.get_allocator());
+        alloc_traits::construct(alloc, reinterpret_cast<value_type*>(table.buckets[index].storage),
+            std::forward<Args>(args)...);
+    }
+
+    static void destroyElement(Table& table, std::size_t index) noexcept {
+        Allocator alloc(table.buckets.get_allocator());
+        alloc_traits::destroy(alloc, table.buckets[index].ptr());
+    }
+
+    // Writes the control byte for `index`, along with its mirrors in the cloned tail
+    static void setCtrl(Table& table, std::size_t index, ctrl_t ctrl) noexcept {
+        const std::size_t bucketSize { table.size() };
+        assert(index < bucketSize);
+        table.ctrl[index] = ctrl;
+        for (std::size_t i { index + bucketSize }; i < table.ctrl.size(); i += bucketSize) {
+            table.ctrl[i] = ctrl;
+        }
+    }
+
+    // 7-bit tag stored in the control byte. The multiply spreads identity hashes (std::hash<int>) over the tag bits,
+    // which would otherwise all be zero for small keys.
+    static ctrl_t getTag(std::size_t hashedKey) noexcept {
+        return static_cast<ctrl_t>((static_cast<std::uint64_t>(hashedKey) * 0x9E3779B97F4A7C15ull) >> 57);
+    }
+
+    std::size_t getKeyIndex(std::size_t hashedKey, std::size_t bucketSize) const noexcept {
+        assert(bucketSize > 0);
+        return BucketPolicy::index(hashedKey, bucketSize);
+    }
+
+    static std::size_t wrapIndex(std::size_t index, std::size_t bucketSize) noexcept {
+        // Only tables smaller than a Group can wrap more than once
+        return index < bucketSize ? index : index % bucketSize;
+    }
+
+    static std::size_t prevIndex(std::size_t index, std::size_t bucketSize) noexcept {
+        return index == 0 ? bucketSize - 1 : index - 1;
+    }
+
+    static void setHash(Bucket& bucket, [[maybe_unused]] std::size_t hashedKey) noexcept {
+        if constexpr (cachesHash) {
+            bucket.hash = hashedKey;
+        }
+    }
+
+    // Hash of the element in a FILLED bucket, only computed when it isn't cached
+    std::size_t bucketHash(const Bucket& bucket) const {
+        if constexpr (cachesHash) {
+            return bucket.hash;
+        } else {
+            return m_hasher(bucket.key());
+        }
     }
 
-    std::size_t getKeyIndex(const K& key, const vector<Bucket>* bucketOverride = nullptr) const {
-        const auto& buckets { bucketOverride ? *bucketOverride : m_buckets };
-        std::size_t hashedKey { m_hasher(key) };
-        assert(buckets.size() > 0);
+    // With a hash cache, keys are only compared once their full hashes match
+    template <typename KeyLike>
+    bool keyMatches(const Bucket& bucket, const KeyLike& key, [[maybe_unused]] std::size_t hashedKey) const {
+        if constexpr (cachesHash) {
+            if (bucket.hash != hashedKey) {
+                return false;
+            }
+        }
+        return m_eq(bucket.key(), key);
+    }
 
-        return hashedKey % buckets.size();
+    // Probes accept K, or any KeyLike a transparent hasher and key equality accept
+    template <typename KeyLike>
+    std::size_t probeForKey(const KeyLike& key) const {
+        return probeForKey(key, m_hasher(key));
     }
 
-    std::size_t probeForKey(const K& key) const {
-        std::size_t index { getKeyIndex(key) };
-        const auto& buckets { m_buckets };
-        const std::size_t bucketSize { buckets.size() };
+    // Linear probing, a Group at a time. Every bucket in the window whose tag matches is compared, and probing stops
+    // at the first window holding an OPEN bucket.
+    template <typename KeyLike>
+    std::size_t probeForKey(const KeyLike& key, std::size_t hashedKey) const {
+        return probeForKey(key, hashedKey, getKeyIndex(hashedKey, m_table.size()));
+    }
+
+    template <typename KeyLike>
+    std::size_t probeForKey(const KeyLike& key, std::size_t hashedKey, std::size_t index) const {
+        const std::size_t bucketSize { m_table.size() };
         assert(bucketSize > 0 && "bucketSize not greater than 0 in probe");
+        const ctrl_t tag { getTag(hashedKey) };
 
-        bool failure = false;
-        for (std::size_t iterations {}; iterations < bucketSize; ++iterations, index = (index + 1) % bucketSize) {
+        // Robin Hood tables use the same probe: an element is never separated from its home bucket by an OPEN one.
+        // Stopping at the first OPEN Group beats reading displacements one bucket at a time.
+        for (std::size_t probed {}; probed < bucketSize; probed += Group::width) {
             assert(index < bucketSize && "Index in probe not less than bucketSize");
-            auto& bucket = buckets[index];
-            State state = bucket.state;
-            if (state == State::OPEN) {
+            const Group group { &m_table.ctrl[index] };
+            for (std::uint32_t match { group.match(tag) }; match != 0; match &= match - 1) {
+                const std::size_t candidate { wrapIndex(index + std::countr_zero(match), bucketSize) };
+                if (keyMatches(m_table.buckets[candidate], key, hashedKey)) {
+                    // Found key
+                    HM_RECORD_PROBE(true, probed + std::countr_zero(match) + 1);
+                    return candidate;
+                }
+            }
+            if (const std::uint32_t open { group.matchOpen() }; open != 0) {
                 // We stop probing on OPEN buckets
-                failure = true;
-                break;
-            } else if (state == State::FILLED && m_eq(bucket.key(), key)) {
-                // Found key
-                break;
+                HM_RECORD_PROBE(false, probed + std::countr_zero(open) + 1);
+                return sentinelIndex;
             }
+            index = wrapIndex(index + Group::width, bucketSize);
         }
-        return failure ? sentinelIndex : index;
+        HM_RECORD_PROBE(false, bucketSize);
+        return sentinelIndex;
     }
 
-    std::pair<std::size_t, bool> probeForInsert(const K& key, const vector<Bucket>* bucketOverride = nullptr) {
-        std::size_t index { getKeyIndex(key, bucketOverride) };
-        // Probing for insertion, probing stops on an OPEN or TOMBSTONE bucket
+    template <typename KeyLike>
+    std::pair<std::size_t, bool> probeForInsert(const KeyLike& key, std::size_t hashedKey) const {
+        return probeForInsert(key, hashedKey, getKeyIndex(hashedKey, m_table.size()));
+    }
 
-        const auto& buckets { bucketOverride ? *bucketOverride : m_buckets};
-        const std::size_t bucketSize { buckets.size() };
+    template <typename KeyLike>
+    std::pair<std::size_t, bool> probeForInsert(const KeyLike& key, std::size_t hashedKey, std::size_t index) const {
+        // Probing for insertion, probing stops on an OPEN bucket
+        const std::size_t bucketSize { m_table.size() };
         assert(bucketSize > 0 && "bucketSize not greater than 0 in probe");
+        const ctrl_t tag { getTag(hashedKey) };
+
+        if constexpr (ProbePolicy::robin_hood) {
+            // Returns the bucket the key belongs in, which placeRobinHood frees up by shifting the rest of the run
+            for (std::size_t displacement {}; displacement < bucketSize; ++displacement) {
+                const ctrl_t ctrl { m_table.ctrl[index] };
+                if (!detail::isFilled(ctrl) || m_table.dist[index] < displacement) {
+                    return { index, true };
+                }
+                if (ctrl == tag && keyMatches(m_table.buckets[index], key, hashedKey)) {
+                    // Key already exists, no op
+                    return { index, false };
+                }
+                index = wrapIndex(index + 1, bucketSize);
+            }
+            assert(false && "Unreachable code reached in probeForInsert, no free bucket found");
+            return { sentinelIndex, false };
+        }
 
-        bool failure = false;
-        std::size_t tombstoneIndex { sentinelIndex };
-        std::size_t iterations {};
-        for (; iterations < bucketSize; ++iterations, index = (index + 1) % bucketSize) {
-            assert(index < bucketSize && "Index in probe not less than bucketSize");
-            auto& bucket = buckets[index];
-            State state = bucket.state;
-            if (state == State::TOMBSTONE && tombstoneIndex == sentinelIndex) {
-                // We found a bucket suitable for insertion
+        std::size_t freeIndex { sentinelIndex };
+        for (std::size_t probed {}; probed < bucketSize; probed += Group::width) {
+            const Group group { &m_table.ctrl[index] };
+            for (std::uint32_t match { group.match(tag) }; match != 0; match &= match - 1) {
+                const std::size_t candidate { wrapIndex(index + std::countr_zero(match), bucketSize) };
+                if (keyMatches(m_table.buckets[candidate], key, hashedKey)) {
+                    // Key already exists, no op
+                    return { candidate, false };
+                }
+            }
+            const std::uint32_t free { group.matchFree() };
+            if (freeIndex == sentinelIndex && free != 0) {
+                // The first OPEN or TOMBSTONE bucket in probe order is where we insert
                 // We continue until an open bucket to ensure there's no duplicate keys
-                tombstoneIndex = index;
-            } else if (state == State::OPEN) {
+                freeIndex = wrapIndex(index + std::countr_zero(free), bucketSize);
+            }
+            if (group.matchOpen() != 0) {
                 // We always stop probing on an OPEN bucket
                 break;
-            } else if (state == State::FILLED && m_eq(bucket.key(), key)) {
-                // Key already exists, no op
-                failure = true;
-                break;
+            }
+            index = wrapIndex(index + Group::width, bucketSize);
+        }
+
+        return { freeIndex, freeIndex != sentinelIndex };
+    }
+
+    // Places an element known to be absent into the first free bucket of its probe sequence, used by rehash
+    template <typename vt>
+    void insertUnique(Table& table, std::size_t hashedKey, vt&& pair) {
+        const std::size_t bucketSize { table.size() };
+        std::size_t index { getKeyIndex(hashedKey, bucketSize) };
+        if constexpr (ProbePolicy::robin_hood) {
+            const std::size_t home { index };
+            for (std::uint32_t displacement {}; detail::isFilled(table.ctrl[index]) && table.dist[index] >= displacement; ++displacement) {
+                index = wrapIndex(index + 1, bucketSize);
+            }
+            placeRobinHood(table, index, home, hashedKey, std::forward<vt>(pair));
+            return;
+        }
+        for (std::size_t probed {}; probed < bucketSize; probed += Group::width) {
+            const std::uint32_t free { Group { &table.ctrl[index] }.matchFree() };
+            if (free != 0) {
+                const std::size_t freeIndex { wrapIndex(index + std::countr_zero(free), bucketSize) };
+                constructElement(table, freeIndex, std::forward<vt>(pair));
+                setHash(table.buckets[freeIndex], hashedKey);
+                setCtrl(table, freeIndex, getTag(hashedKey));
+                return;
+            }
+            index = wrapIndex(index + Group::width, bucketSize);
+        }
+        assert(false && "Unreachable code reached in insertUnique, no free bucket found");
+    }
+
+    // Robin Hood placement at `index`, the bucket probeForInsert returned for an element whose home bucket is `home`.
+    // The elements from `index` up to the next OPEN bucket each move one bucket forward, back to front, then `pair` is
+    // constructed in the freed bucket.
+    // If that construction throws, or relocating an element that isn't nothrow movable does, the shifted elements move
+    // back into their buckets and the table is left as it was. Only if moving one back throws too are the elements
+    // still out of place dropped.
+    template <typename... Args>
+    void placeRobinHood(Table& table, std::size_t index, std::size_t home, std::size_t hashedKey, Args&&... args) {
+        const std::size_t bucketSize { table.size() };
+        std::size_t open { index };
+        while (detail::isFilled(table.ctrl[open])) {
+            open = wrapIndex(open + 1, bucketSize);
+        }
+        std::size_t hole { open };
+        try {
+            while (hole != index) {
+                const std::size_t from { prevIndex(hole, bucketSize) };
+                relocateBucket(table, from, hole, table.dist[from] + 1);
+                hole = from;
+            }
+            constructElement(table, index, std::forward<Args>(args)...);
+        } catch (...) {
+            // `hole` is OPEN, and every element after it up to `open` was moved one bucket forward
+            try {
+                for (; hole != open; hole = wrapIndex(hole + 1, bucketSize)) {
+                    const std::size_t next { wrapIndex(hole + 1, bucketSize) };
+                    relocateBucket(table, next, hole, table.dist[next] - 1);
+                }
+            } catch (...) {
+                const std::size_t dropped { dropDisplacedRun(table, wrapIndex(hole + 1, bucketSize)) };
+                if (&table == &m_table) {
+                    m_filled -= dropped;
+                }
+            }
+            throw;
+        }
+        setHash(table.buckets[index], hashedKey);
+        setCtrl(table, index, getTag(hashedKey));
+        table.dist[index] = static_cast<std::uint32_t>(index >= home ? index - home : index + bucketSize - home);
+    }
+
+    // Backward-shift deletion: destroys the element in `hole`, then the following elements move one bucket back until
+    // an OPEN bucket or an element already in its home bucket.
+    // Elements that aren't nothrow movable are copied. If a copy throws, the shifted elements move forward again and
+    // the erased element is restored from a copy taken before anything changed, so the erase has no effect. Only if
+    // that throws too are the elements still out of place dropped, along with the erased one.
+    void eraseShiftingBackward(std::size_t hole) {
+        const std::size_t bucketSize { m_table.size() };
+        std::size_t next { wrapIndex(hole + 1, bucketSize) };
+        const auto shifts = [&] {
+            return detail::isFilled(m_table.ctrl[next]) && m_table.dist[next] > 0;
+        };
+        if constexpr (std::is_nothrow_move_constructible_v<value_type>) {
+            destroyElement(m_table, hole);
+            setCtrl(m_table, hole, detail::ctrlOpen);
+            for (; shifts(); hole = next, next = wrapIndex(next + 1, bucketSize)) {
+                relocateBucket(m_table, next, hole, m_table.dist[next] - 1);
+            }
+        } else {
+            if (!shifts()) {
+                destroyElement(m_table, hole);
+                setCtrl(m_table, hole, detail::ctrlOpen);
+                return;
+            }
+            const std::size_t erasedIndex { hole };
+            value_type erased(std::move_if_noexcept(*m_table.buckets[hole].ptr()));
+            const auto erasedHash { m_table.buckets[hole].hash };
+            const ctrl_t erasedCtrl { m_table.ctrl[hole] };
+            const std::uint32_t erasedDist { m_table.dist[hole] };
+            destroyElement(m_table, hole);
+            setCtrl(m_table, hole, detail::ctrlOpen);
+            try {
+                for (; shifts(); hole = next, next = wrapIndex(next + 1, bucketSize)) {
+                    relocateBucket(m_table, next, hole, m_table.dist[next] - 1);
+                }
+            } catch (...) {
+                // `hole` is OPEN, and every element from `erasedIndex` up to it was moved one bucket back
+                try {
+                    for (; hole != erasedIndex; hole = prevIndex(hole, bucketSize)) {
+                        const std::size_t prev { prevIndex(hole, bucketSize) };
+                        relocateBucket(m_table, prev, hole, m_table.dist[prev] + 1);
+                    }
+                    constructElement(m_table, erasedIndex, std::move_if_noexcept(erased));
+                    m_table.buckets[erasedIndex].hash = erasedHash;
+                    setCtrl(m_table, erasedIndex, erasedCtrl);
+                    m_table.dist[erasedIndex] = erasedDist;
+                } catch (...) {
+                    // eraseAtIndex doesn't get to count the erased element out, so it's counted here
+                    m_filled -= dropDisplacedRun(m_table, wrapIndex(hole + 1, bucketSize)) + 1;
+                }
+                throw;
             }
         }
+    }
+
+    // Moves the element in the FILLED bucket `from` into the OPEN bucket `to`, displaced `dist` buckets from its home
+    // bucket, and leaves `from` OPEN
+    static void relocateBucket(Table& table, std::size_t from, std::size_t to, std::uint32_t dist) {
+        constructElement(table, to, std::move_if_noexcept(*table.buckets[from].ptr()));
+        table.buckets[to].hash = table.buckets[from].hash;
+        setCtrl(table, to, table.ctrl[from]);
+        table.dist[to] = dist;
+        destroyElement(table, from);
+        setCtrl(table, from, detail::ctrlOpen);
+    }
 
-        if (tombstoneIndex != sentinelIndex) {
-            // Provide the first found tombstone for insertion if found
-            index = tombstoneIndex;
+    // A shift that throws, and then throws again while being undone, leaves an OPEN bucket in front of elements past
+    // their home bucket, which lookups would no longer reach. Those elements are destroyed to restore the Robin Hood
+    // invariant. Returns how many were.
+    static std::size_t dropDisplacedRun(Table& table, std::size_t index) noexcept {
+        std::size_t dropped {};
+        while (detail::isFilled(table.ctrl[index]) && table.dist[index] > 0) {
+            destroyElement(table, index);
+            setCtrl(table, index, detail::ctrlOpen);
+            ++dropped;
+            index = wrapIndex(index + 1, table.size());
         }
+        return dropped;
+    }
 
-        return std::make_pair(
-            iterations < bucketSize ? index : sentinelIndex,
-            !failure
-            );
+    // Number of keys whose home buckets are prefetched together by the batched lookups
+    constexpr static std::size_t batchWidth { 16 };
+
+    // Hashes a batch of keys and prefetches each home Group and bucket up front, then runs probeForKey on each.
+    // The misses of the whole batch overlap instead of forming one serial chain per key.
+    template <typename OnResult>
+    void probeForKeys(std::span<const K> keys, OnResult&& onResult) const {
+        const std::size_t bucketSize { m_table.size() };
+        std::size_t hashedKeys[batchWidth];
+        std::size_t indices[batchWidth];
+        for (std::size_t first {}; first < keys.size(); first += batchWidth) {
+            const std::size_t count { std::min(batchWidth, keys.size() - first) };
+            for (std::size_t i {}; i < count; ++i) {
+                hashedKeys[i] = m_hasher(keys[first + i]);
+                indices[i] = getKeyIndex(hashedKeys[i], bucketSize);
+                detail::prefetch(&m_table.ctrl[indices[i]]);
+                detail::prefetch(&m_table.buckets[indices[i]]);
+            }
+            for (std::size_t i {}; i < count; ++i) {
+                onResult(first + i, probeForKey(keys[first + i], hashedKeys[i], indices[i]));
+            }
+        }
     }
 
     std::size_t probeForFilled(std::optional<std::size_t> startingIndex = std::nullopt) const {
-        for (std::size_t i { startingIndex.value_or(0) }; i < m_buckets.size(); ++i) {
-            if (m_buckets[i].state == State::FILLED) {
+        for (std::size_t i { startingIndex.value_or(0) }; i < m_table.size(); ++i) {
+            if (detail::isFilled(m_table.ctrl[i])) {
                 return i;
             }
         }
-        return m_buckets.size(); // end() index
+        return m_table.size(); // end() index
     }
 
     template <typename vt>
-    std::pair<iterator, bool> insert_impl(vt&& pair, vector<Bucket>* bucketOverride = nullptr) {
-        // Rehash if necessary
-        if (bucketOverride == nullptr && getLoadFactor(1) >= 0.70f) {
-            rehash(m_buckets.size() * 2);
-
-        }
-        // Take the reference AFTER a potential rehash
-        vector<Bucket>& buckets { bucketOverride ? *bucketOverride : m_buckets };
-        std::pair<std::size_t, bool> probeReturn { probeForInsert(pair.first, bucketOverride) };
-
-        if (probeReturn.second) {
-            // We only insert if probing for a suitable bucket was successful
-            auto& bucket = buckets[probeReturn.first];
-            State state = bucket.state;
-            if (state != State::OPEN && state != State::TOMBSTONE) {
-                std::cerr << "state is: " << static_cast<int>(state) << '\n';
-                assert(false && "Unreachable code reached in insert State was FILLED");
+    std::pair<iterator, bool> insert_impl(vt&& pair) {
+        return emplace_impl(pair.first, std::forward<vt>(pair));
+    }
+
+    // Probes for `key`, and only if it's absent constructs a value_type from `args` in the bucket found.
+    // `key` and `args` may refer into an element of this map, as in m.insert(k, m.at(other)). Rehashing and Robin Hood
+    // displacement move elements out from under them, so when either is about to happen the element is built first and
+    // moved in afterwards. If the rehash then throws, rvalue `args` have been moved from.
+    template <typename KeyLike, typename... Args>
+    std::pair<iterator, bool> emplace_impl(const KeyLike& key, Args&&... args) {
+        return emplaceHashed(m_hasher(key), key, std::forward<Args>(args)...);
+    }
+
+    // emplace_impl for callers that already hashed `key`
+    template <typename KeyLike, typename... Args>
+    std::pair<iterator, bool> emplaceHashed(std::size_t hashedKey, const KeyLike& key, Args&&... args) {
+        std::size_t home { getKeyIndex(hashedKey, m_table.size()) };
+        std::pair<std::size_t, bool> probeReturn { probeForInsert(key, hashedKey, home) };
+        if (!probeReturn.second) {
+            HM_ASSERT_VALID();
+            return { iterator{ probeReturn.first, this }, false };
+        }
+
+        // Rehash only once the key is known to be absent
+        const bool rehashing { getLoadFactor(1) >= maxLoadFactor };
+        bool displacing { false };
+        if constexpr (ProbePolicy::robin_hood) {
+            displacing = !rehashing && detail::isFilled(m_table.ctrl[probeReturn.first]);
+        }
+        if (rehashing || displacing) {
+            value_type element(std::forward<Args>(args)...);
+            if (rehashing) {
+                rehash(m_table.size() * 2);
+                home = getKeyIndex(hashedKey, m_table.size());
+                probeReturn = probeForInsert(element.first, hashedKey, home);
+            }
+            return insertAbsent(probeReturn.first, home, hashedKey, std::move(element));
+        }
+        return insertAbsent(probeReturn.first, home, hashedKey, std::forward<Args>(args)...);
+    }
+
+    // Constructs the element of a key probeForInsert found absent, in the bucket it returned
+    template <typename... Args>
+    std::pair<iterator, bool> insertAbsent(std::size_t index, std::size_t home, std::size_t hashedKey,
+        Args&&... args) {
+        if constexpr (ProbePolicy::robin_hood) {
+            placeRobinHood(m_table, index, home, hashedKey, std::forward<Args>(args)...);
+        } else {
+            const ctrl_t ctrl { m_table.ctrl[index] };
+            if (detail::isFilled(ctrl)) {
+                std::cerr << "ctrl is: " << static_cast<int>(ctrl) << '\n';
+                assert(false && "Unreachable code reached in insert, bucket was FILLED");
                 return { end(), false };
             }
             // Placement-new
+            constructElement(m_table, index, std::forward<Args>(args)...);
+            setHash(m_table.buckets[index], hashedKey);
 
-            new (bucket.storage) value_type(std::forward<vt>(pair));
-
-            if (state == State::TOMBSTONE) {
+            if (ctrl == detail::ctrlTombstone) {
                 --m_tombstones;
             }
-            bucket.state = State::FILLED;
-            if (bucketOverride == nullptr) {
-                ++m_filled;
-            }
+            setCtrl(m_table, index, getTag(hashedKey));
         }
+        ++m_filled;
 
         HM_ASSERT_VALID();
-        return { iterator{ probeReturn.first, this }, probeReturn.second };
+        return { iterator{ index, this }, true };
     }
 
-    std::size_t eraseAtIndex(std::size_t index, bool clear = false) noexcept {
+    // Robin Hood erasure relocates the rest of the run, which may throw unless elements are nothrow movable
+    std::size_t eraseAtIndex(std::size_t index, bool clear = false)
+        noexcept(!ProbePolicy::robin_hood || std::is_nothrow_move_constructible_v<value_type>) {
         std::size_t erasedIndex { sentinelIndex };
-        if (index < m_buckets.size()) {
-            auto& bucket { m_buckets[index] };
-            if (bucket.state == State::FILLED) {
-                bucket.ptr()->~value_type();
+        if (index < m_table.size()) {
+            const ctrl_t ctrl { m_table.ctrl[index] };
+            if (detail::isFilled(ctrl)) {
                 if (clear) {
                     // If we're clearing all elements, we set the state to OPEN
-                    bucket.state = State::OPEN;
+                    destroyElement(m_table, index);
+                    setCtrl(m_table, index, detail::ctrlOpen);
+                } else if constexpr (ProbePolicy::robin_hood) {
+                    eraseShiftingBackward(index);
                 } else {
-                    bucket.state = State::TOMBSTONE;
+                    destroyElement(m_table, index);
+                    setCtrl(m_table, index, detail::ctrlTombstone);
                     ++m_tombstones;
                 }
 
                 --m_filled;
                 erasedIndex = index;
-            } else if (bucket.state == State::TOMBSTONE && clear) {
-                bucket.state = State::OPEN;
+            } else if (ctrl == detail::ctrlTombstone && clear) {
+                setCtrl(m_table, index, detail::ctrlOpen);
                 --m_tombstones;
             }
         }
@@ -255,70 +920,342 @@ private:
         return erasedIndex;
     }
 
-    void destroyElements(vector<Bucket>* bucketOverride = nullptr) {
-        auto& buckets { bucketOverride ? *bucketOverride : m_buckets };
-        for (std::size_t i {}; i < buckets.size(); ++i) {
-            Bucket& bucket { buckets[i] };
-            if (bucket.state == State::FILLED) {
-                bucket.ptr()->~value_type();
-                bucket.state = State::OPEN;
-                if (!bucketOverride) {
+    void destroyElements(Table* tableOverride = nullptr) {
+        if (!tableOverride && m_filled == 0) {
+            // Nothing to destroy, skip scanning the control bytes of a drained table
+            return;
+        }
+        auto& table { tableOverride ? *tableOverride : m_table };
+        for (std::size_t i {}; i < table.size(); ++i) {
+            if (detail::isFilled(table.ctrl[i])) {
+                destroyElement(table, i);
+                setCtrl(table, i, detail::ctrlOpen);
+                if (!tableOverride) {
                     --m_filled;
                 }
             }
         }
     }
 
+    // Whether the arguments a K is constructed from can be probed with directly: a single K, or a transparent KeyLike
+    template <typename... KArgs>
+    constexpr static bool probesAsKey { sizeof...(KArgs) == 1 &&
+        (... && (std::same_as<std::remove_cvref_t<KArgs>, K> ||
+            TransparentLookup<Hasher, KeyEqual, K, std::remove_cvref_t<KArgs>>)) };
+
+    template <typename M>
+    static std::pair<iterator, bool> assignIfPresent(std::pair<iterator, bool> result, M&& obj) {
+        if (!result.second) {
+            result.first->second = std::forward<M>(obj);
+        }
+        return result;
+    }
+
+    iterator iteratorAt(std::size_t index) {
+        return index < m_table.size() ? iterator { index, this } : end();
+    }
+
+    const_iterator iteratorAt(std::size_t index) const {
+        return index < m_table.size() ? const_iterator { index, this } : end();
+    }
+
+    template <typename Self, typename KeyLike>
+    static auto& atImpl(Self& self, const KeyLike& key) {
+        const std::size_t index { self.probeForKey(key) };
+        if (index >= self.m_table.size()) {
+            throw std::out_of_range("The key provided was not found in the hashmap\n");
+        }
+        return self.m_table.buckets[index].val();
+    }
+
+    // Smallest bucket count that holds `count` elements without reaching the max load factor, so inserting them
+    // never triggers a rehash
+    static std::size_t bucketsFor(std::size_t count) noexcept {
+        std::size_t buckets { static_cast<std::size_t>(static_cast<double>(count) / maxLoadFactor) + 1 };
+        while (static_cast<double>(count) / static_cast<double>(buckets) >= maxLoadFactor) {
+            ++buckets;
+        }
+        return buckets;
+    }
+
+    // Element count of [first, last) when it can be known without consuming it, 0 otherwise
+    template <typename It, typename S>
+    static std::size_t knownDistance(const It& first, const S& last) {
+        if constexpr (std::sized_sentinel_for<S, It> || std::forward_iterator<It>) {
+            return static_cast<std::size_t>(std::ranges::distance(first, last));
+        } else {
+            return 0;
+        }
+    }
+
+    // Elements whose `first` can be probed with directly are emplaced as they are, anything else is converted first
+    template <typename Ref>
+    void insertElement(Ref&& element) {
+        if constexpr (requires { requires probesAsKey<decltype(element.first)>; }) {
+            emplace_impl(element.first, std::forward<Ref>(element));
+        } else {
+            insert_impl(value_type(std::forward<Ref>(element)));
+        }
+    }
+
+    // Sizes the table once for everything in [first, last), then inserts without any intermediate rehash
+    template <typename It, typename S>
+    void insertRange(It first, S last) {
+        reserve(m_filled + m_tombstones + knownDistance(first, last));
+        for (; first != last; ++first) {
+            insertElement(*first);
+        }
+    }
+
+    // The parallel build writes elements from worker threads, so constructing and destroying them must be unable to
+    // throw or need cleanup. Robin Hood placement shifts runs across partitions, so it always builds serially.
+    constexpr static bool parallelBuildable { std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>
+        && !ProbePolicy::robin_hood };
+
+    // Runs fn(0) .. fn(threads - 1), fn(0) on the calling thread, and rethrows the first exception once all have joined
+    template <typename F>
+    static void parallelFor(std::size_t threads, F&& fn) {
+        vector<std::exception_ptr> errors {};
+        errors.resize(threads);
+        {
+            vector<std::jthread> workers {};
+            for (std::size_t t { 1 }; t < threads; ++t) {
+                workers.emplace_back([&fn, &errors, t] {
+                    try {
+                        fn(t);
+                    } catch (...) {
+                        errors[t] = std::current_exception();
+                    }
+                });
+            }
+            try {
+                fn(0);
+            } catch (...) {
+                errors[0] = std::current_exception();
+            }
+        } // workers join here
+        for (std::size_t t {}; t < threads; ++t) {
+            if (errors[t]) {
+                std::rethrow_exception(errors[t]);
+            }
+        }
+    }
+
+    // Bulk build into an empty, pre-sized table. The buckets are split into `threads` contiguous partitions, and every
+    // element goes to the partition holding its home bucket; equal keys share a home bucket, so also a partition.
+    // Each thread places its elements by linear probing that never leaves its partition. An element whose run
+    // reaches the end of the partition is deferred, and the deferred ones are placed serially once all threads join.
+    template <typename R>
+    void parallelBuild(R&& range, std::size_t threads) {
+        assert(m_filled == 0 && m_tombstones == 0);
+        const std::size_t count { static_cast<std::size_t>(std::ranges::size(range)) };
+        const auto first { std::ranges::begin(range) };
+        const std::size_t bucketSize { m_table.size() };
+        threads = std::min(threads, bucketSize);
+
+        vector<std::size_t> hashes {};
+        vector<std::size_t> homes {};
+        hashes.resize(count);
+        homes.resize(count);
+        auto partitionOf = [&](std::size_t home) { return home * threads / bucketSize; };
+
+        try {
+            // 1. Hash every element, a contiguous slice of the input per thread
+            parallelFor(threads, [&](std::size_t t) {
+                for (std::size_t i { count * t / threads }; i < count * (t + 1) / threads; ++i) {
+                    const value_type element(first[i]);
+                    hashes[i] = m_hasher(element.first);
+                    homes[i] = getKeyIndex(hashes[i], bucketSize);
+                }
+            });
+
+            // 2. Group the input indices by partition, keeping input order within each so the first of equal keys wins
+            vector<std::size_t> offsets {};
+            offsets.resize(threads + 1);
+            for (std::size_t i {}; i < count; ++i) {
+                ++offsets[partitionOf(homes[i]) + 1];
+            }
+            for (std::size_t t {}; t < threads; ++t) {
+                offsets[t + 1] += offsets[t];
+            }
+            vector<std::size_t> order {};
+            order.resize(count);
+            {
+                vector<std::size_t> cursor {};
+                cursor.resize(threads);
+                for (std::size_t t {}; t < threads; ++t) {
+                    cursor[t] = offsets[t];
+                }
+                for (std::size_t i {}; i < count; ++i) {
+                    order[cursor[partitionOf(homes[i])]++] = i;
+                }
+            }
+
+            // 3. Place each partition's elements. Only control bytes inside the partition are read, the mirrored tail is
+            // written by partition 0 but never read until every thread has joined.
+            vector<std::size_t> placed {};
+            vector<std::size_t> deferred {};
+            placed.resize(threads);
+            deferred.resize(threads);
+            parallelFor(threads, [&](std::size_t t) {
+                const std::size_t end { bucketSize * (t + 1) / threads };
+                for (std::size_t k { offsets[t] }; k < offsets[t + 1]; ++k) {
+                    const std::size_t i { order[k] };
+                    const value_type element(first[i]);
+                    const ctrl_t tag { getTag(hashes[i]) };
+                    std::size_t index { homes[i] };
+                    for (; index < end; ++index) {
+                        const ctrl_t ctrl { m_table.ctrl[index] };
+                        if (!detail::isFilled(ctrl)) {
+                            // Trivially copyable elements take no allocator, so they're copied in directly
+                            new (m_table.buckets[index].storage) value_type(element);
+                            setHash(m_table.buckets[index], hashes[i]);
+                            setCtrl(m_table, index, tag);
+                            ++placed[t];
+                            break;
+                        }
+                        if (ctrl == tag && keyMatches(m_table.buckets[index], element.first, hashes[i])) {
+                            break; // Duplicate key, the earlier element stays
+                        }
+                    }
+                    if (index == end) {
+                        // Slots before k have been read already, so the deferred indices are compacted into them
+                        order[offsets[t] + deferred[t]++] = i;
+                    }
+                }
+            });
+            for (std::size_t t {}; t < threads; ++t) {
+                m_filled += placed[t];
+            }
+
+            // 4. Deferred elements wrap into the next partition, placed with the regular insert path
+            for (std::size_t t {}; t < threads; ++t) {
+                for (std::size_t k { offsets[t] }; k < offsets[t] + deferred[t]; ++k) {
+                    insertElement(value_type(first[order[k]]));
+                }
+            }
+        } catch (...) {
+            // Elements are trivially destructible, dropping the control bytes is enough
+            m_table = makeTable(bucketSize, get_allocator());
+            m_filled = 0;
+            throw;
+        }
+        HM_ASSERT_VALID();
+    }
+
 public:
+    using allocator_type = Allocator;
+
     // Default constructor
-    unordered_map() {
-        m_buckets.resize(10);
-        for (std::size_t i {}; i < 10; ++i) {
-            assert(m_buckets[i].state == State::OPEN && "Default initialized bucket(s) were not OPEN");
-        }
-        assert(m_buckets.size() > 0 && "Default construction was not successful");
+    unordered_map() : unordered_map(Allocator()) {}
+
+    explicit unordered_map(const Allocator& alloc) : m_table { makeTable(10, alloc) } {
+        assert(m_table.size() > 0 && "Default construction was not successful");
         HM_ASSERT_VALID();
     }
 
     // Constructor with size
-    explicit unordered_map(std::size_t n) {
+    explicit unordered_map(std::size_t n, const Allocator& alloc = Allocator()) : m_table { alloc } {
         if (n == 0) {
             throw std::invalid_argument("A unordered_map must be initialized with a value of at least 1");
         }
-        m_buckets.resize(n);
-        for (std::size_t i {}; i < n; ++i) {
-            assert(m_buckets[i].state == State::OPEN && "Default initialized bucket(s) were not OPEN");
-        }
+        m_table = makeTable(n, alloc);
         HM_ASSERT_VALID();
     }
 
+    // Range constructor, the table is sized once when the number of elements can be known up front
+    template <std::input_iterator It, std::sentinel_for<It> S>
+    requires std::constructible_from<value_type, std::iter_reference_t<It>>
+    unordered_map(It first, S last, const Allocator& alloc = Allocator())
+        : m_table { makeTable(std::max<std::size_t>(bucketsFor(knownDistance(first, last)), 10), alloc) } {
+        insertRange(std::move(first), std::move(last));
+        HM_ASSERT_VALID();
+    }
+
+    unordered_map(std::initializer_list<value_type> list, const Allocator& alloc = Allocator())
+        : unordered_map(list.begin(), list.end(), alloc) {}
+
     // Copy constructor
     unordered_map(const unordered_map& other) = delete;
 
     // Move constructor
-    // TODO: Define proper move-constructor
-    unordered_map(unordered_map&& other) noexcept = default;
+    // The moved-from map holds no buckets, it may only be assigned to or destroyed
+    unordered_map(unordered_map&& other) noexcept
+        : m_table { std::move(other.m_table) }
+        , m_tombstones { std::exchange(other.m_tombstones, 0) }
+        , m_filled { std::exchange(other.m_filled, 0) }
+        , m_hasher { std::move(other.m_hasher) }
+        , m_eq { std::move(other.m_eq) }
+#ifdef SYSTEMS_DSA_HM_STATS
+        , m_counters { std::exchange(other.m_counters, {}) }
+#endif
+    {}
 
     // Copy assignment operator
     unordered_map& operator=(const unordered_map& other) = delete;
 
     // Move assignment operator
-    // TODO: Define proper move assignment operator
-    unordered_map& operator=(unordered_map&& other) noexcept = default;
+    // If the allocator doesn't propagate and compares unequal, other's elements are moved into a table from this
+    // map's allocator instead
+    unordered_map& operator=(unordered_map&& other) noexcept(alloc_traits::propagate_on_container_move_assignment::value
+        || alloc_traits::is_always_equal::value) {
+        if (&other == this) {
+            return *this;
+        }
+        destroyElements();
+        if constexpr (!alloc_traits::propagate_on_container_move_assignment::value
+            && !alloc_traits::is_always_equal::value) {
+            if (get_allocator() != other.get_allocator()) {
+                Table newTable { makeTable(other.bucket_count(), get_allocator()) };
+                try {
+                    for (std::size_t i {}; i < other.m_table.size(); ++i) {
+                        if (detail::isFilled(other.m_table.ctrl[i])) {
+                            auto& bucket { other.m_table.buckets[i] };
+                            insertUnique(newTable, other.bucketHash(bucket), std::move(*bucket.ptr()));
+                        }
+                    }
+                } catch (...) {
+                    destroyElements(&newTable);
+                    throw;
+                }
+                m_table = std::move(newTable);
+                m_filled = other.m_filled;
+                m_tombstones = 0;
+                m_hasher = std::move(other.m_hasher);
+                m_eq = std::move(other.m_eq);
+                other.clear();
+                HM_ASSERT_VALID();
+                return *this;
+            }
+        }
+        m_table = std::move(other.m_table);
+        m_tombstones = std::exchange(other.m_tombstones, 0);
+        m_filled = std::exchange(other.m_filled, 0);
+        m_hasher = std::move(other.m_hasher);
+        m_eq = std::move(other.m_eq);
+#ifdef SYSTEMS_DSA_HM_STATS
+        m_counters = std::exchange(other.m_counters, {});
+#endif
+        return *this;
+    }
 
     ~unordered_map() {
         destroyElements();
     };
 
+    allocator_type get_allocator() const noexcept {
+        return allocator_type(m_table.buckets.get_allocator());
+    }
+
     ///////////////
     // Modifiers //
     ///////////////
 
     std::pair<iterator, bool> insert(K&& first, V&& second) {
-        return insert_impl(value_type{std::move(first), std::move(second)});
+        return emplace_impl(first, std::move(first), std::move(second));
     }
     std::pair<iterator, bool> insert(const K& first, const V& second) {
-        return insert_impl(value_type{ first, second });
+        return emplace_impl(first, first, second);
     }
 
     std::pair<iterator, bool> insert(const value_type& pair) {
@@ -329,36 +1266,136 @@ public:
         return insert_impl(std::move(pair));
     }
 
-    // TODO: Implement piecewise-style emplacement
+    // Rehashes at most once, up front, when the number of elements can be known without consuming them.
+    // Keys already present, or repeated in the input, keep their first value.
+    template <std::input_iterator It, std::sentinel_for<It> S>
+    requires std::constructible_from<value_type, std::iter_reference_t<It>>
+    void insert(It first, S last) {
+        insertRange(std::move(first), std::move(last));
+    }
+
+    template <std::ranges::input_range R>
+    requires std::constructible_from<value_type, std::ranges::range_reference_t<R>>
+    void insert_range(R&& range) {
+        insertRange(std::ranges::begin(range), std::ranges::end(range));
+    }
+
+    // Builds in parallel on up to `threads` threads when the map is empty, the range is random access and sized, and
+    // K and V are trivially copyable with the linear probe policy. Otherwise the same as insert_range(range).
+    template <std::ranges::input_range R>
+    requires std::constructible_from<value_type, std::ranges::range_reference_t<R>>
+    void insert_range(R&& range, std::size_t threads) {
+        if constexpr (parallelBuildable && std::ranges::random_access_range<R> && std::ranges::sized_range<R>) {
+            if (threads > 1 && m_filled == 0 && m_tombstones == 0) {
+                reserve(static_cast<std::size_t>(std::ranges::size(range)));
+                parallelBuild(range, threads);
+                return;
+            }
+        }
+        insert_range(std::forward<R>(range));
+    }
+
+    // The element is constructed in its bucket. A K is only built up front if `key` can't be probed with directly.
     template <typename KArg, typename VArg>
     requires std::constructible_from<K, KArg&&> &&
         std::constructible_from<V, VArg&&>
-    void emplace(KArg&& key, VArg&& value) {
-        insert_impl(value_type(
-            std::forward<KArg>(key),
-            std::forward<VArg>(value)
-            ));
+    std::pair<iterator, bool> emplace(KArg&& key, VArg&& value) {
+        if constexpr (probesAsKey<KArg>) {
+            return emplace_impl(key, std::forward<KArg>(key), std::forward<VArg>(value));
+        } else {
+            K builtKey(std::forward<KArg>(key));
+            return emplace_impl(builtKey, std::move(builtKey), std::forward<VArg>(value));
+        }
     }
 
-    std::size_t erase(const K& key) {
-        // Returns the number of elements erased (0 or 1)
-        std::size_t erasedIndex { eraseAtIndex(probeForKey(key)) };
-        if (erasedIndex != sentinelIndex) {
-            return 1;
+    template <typename... KArgs, typename... VArgs>
+    requires std::constructible_from<K, KArgs&&...> &&
+        std::constructible_from<V, VArgs&&...>
+    std::pair<iterator, bool> emplace(std::piecewise_construct_t,
+        std::tuple<KArgs...> keyArgs, std::tuple<VArgs...> valueArgs) {
+        if constexpr (probesAsKey<KArgs...>) {
+            const auto& key { std::get<0>(keyArgs) };
+            return emplace_impl(key, std::piecewise_construct, std::move(keyArgs), std::move(valueArgs));
+        } else {
+            K builtKey { std::make_from_tuple<K>(std::move(keyArgs)) };
+            return emplace_impl(builtKey, std::piecewise_construct,
+                std::forward_as_tuple(std::move(builtKey)), std::move(valueArgs));
         }
-        return 0;
+    }
+
+    // Inserts { key, V(args...) } if the key is absent, otherwise no op: args aren't touched and nothing is constructed
+    template <typename... Args>
+    requires std::constructible_from<V, Args&&...>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+        return emplace_impl(key, std::piecewise_construct,
+            std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    template <typename... Args>
+    requires std::constructible_from<V, Args&&...>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+        return emplace_impl(key, std::piecewise_construct,
+            std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    // Heterogeneous: the K is constructed from `key` only if it's inserted
+    template <typename KeyLike, typename... Args>
+    requires TransparentLookup<Hasher, KeyEqual, K, std::remove_cvref_t<KeyLike>> &&
+        std::constructible_from<K, KeyLike&&> &&
+        std::constructible_from<V, Args&&...>
+    std::pair<iterator, bool> try_emplace(KeyLike&& key, Args&&... args) {
+        return emplace_impl(key, std::piecewise_construct,
+            std::forward_as_tuple(std::forward<KeyLike>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    // Assigns `obj` to the value if the key is present, otherwise inserts { key, V(obj) }. Probes once either way.
+    // `obj` is forwarded twice, but try_emplace leaves its arguments untouched unless it inserts.
+    template <typename M>
+    requires std::assignable_from<V&, M&&> && std::constructible_from<V, M&&>
+    std::pair<iterator, bool> insert_or_assign(const K& key, M&& obj) {
+        return assignIfPresent(try_emplace(key, std::forward<M>(obj)), std::forward<M>(obj));
+    }
+
+    template <typename M>
+    requires std::assignable_from<V&, M&&> && std::constructible_from<V, M&&>
+    std::pair<iterator, bool> insert_or_assign(K&& key, M&& obj) {
+        return assignIfPresent(try_emplace(std::move(key), std::forward<M>(obj)), std::forward<M>(obj));
+    }
+
+    template <typename KeyLike, typename M>
+    requires TransparentLookup<Hasher, KeyEqual, K, std::remove_cvref_t<KeyLike>> &&
+        std::constructible_from<K, KeyLike&&> &&
+        std::assignable_from<V&, M&&> && std::constructible_from<V, M&&>
+    std::pair<iterator, bool> insert_or_assign(KeyLike&& key, M&& obj) {
+        return assignIfPresent(try_emplace(std::forward<KeyLike>(key), std::forward<M>(obj)), std::forward<M>(obj));
+    }
+
+    // Returns the number of elements erased (0 or 1)
+    std::size_t erase(const K& key) {
+        return eraseAtIndex(probeForKey(key)) != sentinelIndex ? 1 : 0;
+    }
+
+    template <typename KeyLike>
+    requires TransparentLookup<Hasher, KeyEqual, K, KeyLike> &&
+        (!std::convertible_to<const KeyLike&, const_iterator>)
+    std::size_t erase(const KeyLike& key) {
+        return eraseAtIndex(probeForKey(key)) != sentinelIndex ? 1 : 0;
     }
 
     iterator erase(iterator pos) {
         // Iterator must be valid and dereferenceable
         std::size_t erasedIndex { eraseAtIndex(pos.m_currentIndex) };
 
+        if constexpr (ProbePolicy::robin_hood) {
+            // Backward shifting may have moved the next element into the erased bucket
+            return { probeForFilled(erasedIndex), this };
+        }
         std::size_t nextFilledIndex { probeForFilled(erasedIndex + 1) };
         return { nextFilledIndex, this };
     }
 
     void clear() {
-        for (std::size_t i {}; i < m_buckets.size(); ++i) {
+        for (std::size_t i {}; i < m_table.size(); ++i) {
             eraseAtIndex(i, true);
         }
         assert(m_tombstones == 0 && m_filled == 0);
@@ -369,24 +1406,60 @@ public:
     // Lookup //
     ////////////
 
+    // Every lookup also has a heterogeneous overload, available when Hasher and KeyEqual are transparent
+
     iterator find(const K& key) {
-        std::size_t index { probeForKey(key) };
-        if (index >= m_buckets.size()) {
-            return end();
-        }
-        return { index, this };
+        return iteratorAt(probeForKey(key));
     }
 
     const_iterator find(const K& key) const {
-        std::size_t index { probeForKey(key) };
-        if (index >= m_buckets.size()) {
-            return end();
-        }
-        return { index, this };
+        return iteratorAt(probeForKey(key));
+    }
+
+    template <typename KeyLike>
+    requires TransparentLookup<Hasher, KeyEqual, K, KeyLike>
+    iterator find(const KeyLike& key) {
+        return iteratorAt(probeForKey(key));
+    }
+
+    template <typename KeyLike>
+    requires TransparentLookup<Hasher, KeyEqual, K, KeyLike>
+    const_iterator find(const KeyLike& key) const {
+        return iteratorAt(probeForKey(key));
     }
 
     bool contains(const K& key) const {
-        return probeForKey(key) < m_buckets.size();
+        return probeForKey(key) < m_table.size();
+    }
+
+    template <typename KeyLike>
+    requires TransparentLookup<Hasher, KeyEqual, K, KeyLike>
+    bool contains(const KeyLike& key) const {
+        return probeForKey(key) < m_table.size();
+    }
+
+    // Batched lookups: results[i] receives the result for keys[i]. Equivalent to calling find/contains per key,
+    // but hashing and memory accesses are pipelined across keys.
+    // Requires: results.size() >= keys.size()
+    void find_batch(std::span<const K> keys, std::span<iterator> results) {
+        assert(results.size() >= keys.size() && "find_batch results span is smaller than keys");
+        probeForKeys(keys, [&](std::size_t i, std::size_t index) {
+            results[i] = index < m_table.size() ? iterator { index, this } : end();
+        });
+    }
+
+    void find_batch(std::span<const K> keys, std::span<const_iterator> results) const {
+        assert(results.size() >= keys.size() && "find_batch results span is smaller than keys");
+        probeForKeys(keys, [&](std::size_t i, std::size_t index) {
+            results[i] = index < m_table.size() ? const_iterator { index, this } : end();
+        });
+    }
+
+    void contains_batch(std::span<const K> keys, std::span<bool> results) const {
+        assert(results.size() >= keys.size() && "contains_batch results span is smaller than keys");
+        probeForKeys(keys, [&](std::size_t i, std::size_t index) {
+            results[i] = index < m_table.size();
+        });
     }
 
     std::size_t size() const noexcept {
@@ -394,28 +1467,38 @@ public:
     }
 
     V& operator[](const K& key) {
-        auto it { find(key) };
-        if (it == end()) {
-            auto insertReturn { insert_impl(value_type(key, {})) };
-            return insertReturn.first->second;
-        }
-        return it->second;
+        return try_emplace(key).first->second;
+    }
+
+    V& operator[](K&& key) {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    template <typename KeyLike>
+    requires TransparentLookup<Hasher, KeyEqual, K, std::remove_cvref_t<KeyLike>> &&
+        std::constructible_from<K, KeyLike&&>
+    V& operator[](KeyLike&& key) {
+        return try_emplace(std::forward<KeyLike>(key)).first->second;
     }
 
     V& at(const K& key) {
-        auto it { find(key) };
-        if (it == end()) {
-            throw std::out_of_range("The key provided was not found in the hashmap\n");
-        }
-        return it->second;
+        return atImpl(*this, key);
     }
 
     const V& at(const K& key) const {
-        auto it { find(key) };
-        if (it == end()) {
-            throw std::out_of_range("The key provided was not found in the hashmap\n");
-        }
-        return it->second;
+        return atImpl(*this, key);
+    }
+
+    template <typename KeyLike>
+    requires TransparentLookup<Hasher, KeyEqual, K, KeyLike>
+    V& at(const KeyLike& key) {
+        return atImpl(*this, key);
+    }
+
+    template <typename KeyLike>
+    requires TransparentLookup<Hasher, KeyEqual, K, KeyLike>
+    const V& at(const KeyLike& key) const {
+        return atImpl(*this, key);
     }
 
     bool empty() const noexcept {
@@ -423,7 +1506,14 @@ public:
     }
 
     std::size_t bucket_count() const {
-        return m_buckets.size();
+        return m_table.size();
+    }
+
+    // Index of the bucket holding `key`, or of its home bucket if the key is absent
+    std::size_t bucket(const K& key) const {
+        const std::size_t hashedKey { m_hasher(key) };
+        const std::size_t index { probeForKey(key, hashedKey) };
+        return index < m_table.size() ? index : getKeyIndex(hashedKey, m_table.size());
     }
 
     /////////////
@@ -436,36 +1526,38 @@ public:
     void rehash(std::size_t count) {
         if (count <= bucket_count()) return;
         std::size_t oldFilled [[maybe_unused]] { m_filled };
-        std::cout << "m_filled pre rehash: " << m_filled << '\n';
-        vector<Bucket> newBuckets {};
-        newBuckets.resize(count);
+#ifdef SYSTEMS_DSA_HM_STATS
+        const auto rehashStart { std::chrono::steady_clock::now() };
+#endif
+        Table newTable { makeTable(count, get_allocator()) };
         try {
-            for (std::size_t i{}; i < m_buckets.size(); ++i) {
-                auto& oldBucket { m_buckets[i] };
-                if (oldBucket.state == State::FILLED) {
-                    insert_impl(std::move_if_noexcept(*oldBucket.ptr()), &newBuckets);
+            for (std::size_t i{}; i < m_table.size(); ++i) {
+                if (detail::isFilled(m_table.ctrl[i])) {
+                    auto& oldBucket { m_table.buckets[i] };
+                    insertUnique(newTable, bucketHash(oldBucket), std::move_if_noexcept(*oldBucket.ptr()));
                 }
             }
         } catch (...) {
-            destroyElements(&newBuckets);
+            destroyElements(&newTable);
             throw;
         }
 
-
-        auto oldBuckets { std::move(m_buckets) };
-        m_buckets = std::move(newBuckets);
+        auto oldTable { std::move(m_table) };
+        m_table = std::move(newTable);
         m_tombstones = 0;
 
-        destroyElements(&oldBuckets);
-        std::cout << "m_filled post rehash: " << m_filled << '\n';
+        destroyElements(&oldTable);
+#ifdef SYSTEMS_DSA_HM_STATS
+        ++m_counters.rehashCount;
+        m_counters.rehashTime += std::chrono::steady_clock::now() - rehashStart;
+#endif
         assert(oldFilled == m_filled);
         HM_ASSERT_VALID();
     }
 
     void reserve(std::size_t count) {
         // This ensures that rehashing isn't necessary to hold `count` elements
-        if (count <= bucket_count()) return; // No op
-        rehash(std::ceil(count / max_load_factor()));
+        rehash(bucketsFor(count));
     }
 
     float load_factor() const {
@@ -476,6 +1568,56 @@ public:
         return maxLoadFactor;
     }
 
+#ifdef SYSTEMS_DSA_HM_STATS
+    ////////////////
+    // Statistics //
+    ////////////////
+
+    // O(n): walks the table and rehashes every key. Not safe to call concurrently with lookups.
+    unordered_map_stats stats() const {
+        unordered_map_stats result {};
+        result.hit_probes = m_counters.hitProbes;
+        result.miss_probes = m_counters.missProbes;
+        result.rehash_count = m_counters.rehashCount;
+        result.rehash_time = m_counters.rehashTime;
+        result.load_factor = getLoadFactor();
+        result.tombstone_ratio = static_cast<double>(m_tombstones) / static_cast<double>(m_table.size());
+
+        const std::size_t bucketSize { m_table.size() };
+        vector<std::size_t> homeCounts {};
+        homeCounts.resize(bucketSize);
+        std::size_t totalDisplacement {};
+        for (std::size_t i {}; i < bucketSize; ++i) {
+            if (!detail::isFilled(m_table.ctrl[i])) continue;
+            const std::size_t home { getKeyIndex(bucketHash(m_table.buckets[i]), bucketSize) };
+            const std::size_t displacement { i >= home ? i - home : i + bucketSize - home };
+            result.max_displacement = std::max(result.max_displacement, displacement);
+            totalDisplacement += displacement;
+            ++homeCounts[home];
+        }
+        if (m_filled == 0) {
+            return result;
+        }
+        result.mean_displacement = static_cast<double>(totalDisplacement) / static_cast<double>(m_filled);
+
+        const double expected { static_cast<double>(m_filled) / static_cast<double>(bucketSize) };
+        for (std::size_t i {}; i < bucketSize; ++i) {
+            const double diff { static_cast<double>(homeCounts[i]) - expected };
+            result.home_chi_squared += diff * diff / expected;
+        }
+        if (bucketSize > 1) {
+            const double dof { static_cast<double>(bucketSize - 1) };
+            result.home_chi_squared_z = (result.home_chi_squared - dof) / std::sqrt(2.0 * dof);
+        }
+        return result;
+    }
+
+    // Clears the probe histograms and rehash counters
+    void reset_stats() noexcept {
+        m_counters = {};
+    }
+#endif
+
 private:
     ///////////////
     // Iterators //
@@ -508,17 +1650,17 @@ private:
 
         reference operator*() const {
             assert(m_owner && "m_owner is a nullptr");
-            assert(m_currentIndex != m_owner->m_buckets.size() && "Attempted to dereference an end iterator");
-            bucket_type& bucket { m_owner->m_buckets[m_currentIndex] };
-            assert(bucket.state == State::FILLED && "Attempted to dereference a non-FILLED iterator");
+            assert(m_currentIndex != m_owner->m_table.size() && "Attempted to dereference an end iterator");
+            assert(detail::isFilled(m_owner->m_table.ctrl[m_currentIndex]) && "Attempted to dereference a non-FILLED iterator");
+            bucket_type& bucket { m_owner->m_table.buckets[m_currentIndex] };
             return *bucket.ptr();
         }
 
         pointer operator->() const {
             assert(m_owner && "m_owner is a nullptr");
-            assert(m_currentIndex != m_owner->m_buckets.size() && "Attempted to dereference an end iterator");
-            bucket_type& bucket { m_owner->m_buckets[m_currentIndex] };
-            assert(bucket.state == State::FILLED && "Attempted to dereference a non-FILLED iterator");
+            assert(m_currentIndex != m_owner->m_table.size() && "Attempted to dereference an end iterator");
+            assert(detail::isFilled(m_owner->m_table.ctrl[m_currentIndex]) && "Attempted to dereference a non-FILLED iterator");
+            bucket_type& bucket { m_owner->m_table.buckets[m_currentIndex] };
             return bucket.ptr();
         }
 
@@ -549,6 +1691,10 @@ private:
         friend class unordered_map;
     };
 
+    friend class incremental_unordered_map<K, V, Hasher, KeyEqual, BucketPolicy>;
+    friend class unordered_map_snapshot<K, V, Hasher, KeyEqual, BucketPolicy, ProbePolicy, HashCachePolicy>;
+    friend class concurrent_unordered_map<K, V, Hasher, KeyEqual, BucketPolicy>;
+
 public:
     iterator begin() {
         return { probeForFilled(), this };
@@ -559,11 +1705,11 @@ public:
     }
 
     iterator end() {
-        return { m_buckets.size(), this };
+        return { m_table.size(), this };
     }
 
     const_iterator end() const {
-        return { m_buckets.size(), this };
+        return { m_table.size(), this };
     }
 
     const_iterator cbegin() const {
@@ -571,7 +1717,7 @@ public:
     }
 
     const_iterator cend() const {
-        return { m_buckets.size(), this };
+        return { m_table.size(), this };
     }
 
 #ifndef NDEBUG
@@ -579,33 +1725,46 @@ private:
     // This function checks numerous invariants of our unordered_map, to assert that it is in a valid state.
     // We do this regardless of runtime overhead, in debug builds only.
     void assertValid() const {
+#ifdef SYSTEMS_DSA_HM_STATS
+        // The lookups below aren't the caller's, keep them out of the probe histograms
+        const detail::HashMapCounters counters { m_counters };
+#endif
         std::size_t tombstones {};
         std::size_t filled {};
         std::size_t open {};
-        for (std::size_t i {}; i < m_buckets.size(); ++i) {
-            const auto& bucket { m_buckets[i] };
-            switch (bucket.state) {
-            case State::OPEN:
-                ++open;
-                break;
-            case State::FILLED:
+        for (std::size_t i {}; i < m_table.size(); ++i) {
+            const ctrl_t ctrl { m_table.ctrl[i] };
+            if (detail::isFilled(ctrl)) {
                 ++filled;
-                break;
-            case State::TOMBSTONE:
-                ++tombstones;
-                break;
-            default:
-                assert(false && "Unreachable code reached in assert valid switch statement - bucket.state default case");
-            }
-            if (bucket.state == State::FILLED) {
+                const auto& bucket { m_table.buckets[i] };
+                assert(ctrl == getTag(m_hasher(bucket.key())) && "Control byte tag does not match the key's hash");
+                assert(bucketHash(bucket) == m_hasher(bucket.key()) && "Cached hash does not match the key's hash");
+                if constexpr (ProbePolicy::robin_hood) {
+                    const std::size_t home { getKeyIndex(m_hasher(bucket.key()), m_table.size()) };
+                    assert(m_table.dist[i] == (i + m_table.size() - home) % m_table.size() && "Stored displacement has drifted");
+                    const std::size_t prev { prevIndex(i, m_table.size()) };
+                    assert((m_table.dist[i] == 0 || (detail::isFilled(m_table.ctrl[prev]) && m_table.dist[prev] + 1 >= m_table.dist[i]))
+                        && "Run is not ordered by home bucket");
+                }
                 const auto& foundIterator { find(bucket.key()) };
                 assert(foundIterator != end() && "end iterator returned when attempting to find valid key");
                 if (!(&foundIterator->second == &bucket.val())) {
                     assert(false && "valFound did not equal expected value");
                 }
+            } else if (ctrl == detail::ctrlOpen) {
+                ++open;
+            } else if (ctrl == detail::ctrlTombstone) {
+                ++tombstones;
+            } else {
+                assert(false && "Unreachable code reached in assert valid - invalid control byte");
             }
         }
+        assert(m_table.ctrl.size() == m_table.size() + Group::width - 1 && "Control bytes are not sized to the bucket count");
+        for (std::size_t i { m_table.size() }; i < m_table.ctrl.size(); ++i) {
+            assert(m_table.ctrl[i] == m_table.ctrl[i % m_table.size()] && "Cloned control bytes have drifted");
+        }
         assert(tombstones == m_tombstones && "Tombstone count has drifted");
+        assert((!ProbePolicy::robin_hood || tombstones == 0) && "Robin Hood probing created a tombstone");
         if (filled != m_filled) {
             std::cerr << "filled: " << filled << '\n';
             std::cerr << "m_filled: " << m_filled << '\n';
@@ -613,28 +1772,31 @@ private:
             assert(filled == m_filled && "Filled count has drifted");
         }
 
-        assert(open == m_buckets.size() - m_filled - m_tombstones && "Open count has drifted");
+        assert(open == m_table.size() - m_filled - m_tombstones && "Open count has drifted");
         assert(open > 0 && "Open count was not greater than zero");
-        assert(getLoadFactor() == static_cast<double>(filled + tombstones) / m_buckets.size() && "Load factor calculation is incorrect");
+        assert(getLoadFactor() == static_cast<double>(filled + tombstones) / m_table.size() && "Load factor calculation is incorrect");
         assert(getLoadFactor() < maxLoadFactor && "Load factor has exceeded allowed maximum");
+#ifdef SYSTEMS_DSA_HM_STATS
+        m_counters = counters;
+#endif
     }
 
 public:
-    template <class K2, class V2, class H2, class E2>
-    friend std::ostream& operator<< (std::ostream&, const unordered_map<K2, V2, H2, E2>&);
+    template <class K2, class V2, class H2, class E2, class P2, class R2, class C2, class A2>
+    friend std::ostream& operator<< (std::ostream&, const unordered_map<K2, V2, H2, E2, P2, R2, C2, A2>&);
 #endif
 };
 
 #ifndef NDEBUG
-template <class K, class V, class Hash, class KeyEq>
+template <class K, class V, class Hash, class KeyEq, class Policy, class Probe, class HashCache, class Alloc>
 std::ostream& operator<< (std::ostream& out,
-    const unordered_map<K, V, Hash, KeyEq>& hashMap) {
+    const unordered_map<K, V, Hash, KeyEq, Policy, Probe, HashCache, Alloc>& hashMap) {
     out << "[";
-    for (std::size_t i {}; i < hashMap.m_buckets.size(); ++i) {
+    for (std::size_t i {}; i < hashMap.m_table.size(); ++i) {
         if (i) out << ", ";
         out << i << ": ";
-        const auto& bucket { hashMap.m_buckets[i] };
-        if (bucket.state == unordered_map<K, V, Hash, KeyEq>::State::FILLED) {
+        const auto& bucket { hashMap.m_table.buckets[i] };
+        if (detail::isFilled(hashMap.m_table.ctrl[i])) {
             out << "{ " << bucket.key() << ", " << bucket.val() << " }";
         } else {
             out << "empty";
@@ -645,4 +1807,18 @@ std::ostream& operator<< (std::ostream& out,
     return out;
 }
 #endif
+
+namespace pmr {
+    template <
+        typename K,
+        typename V,
+        class Hasher = std::hash<K>,
+        class KeyEqual = std::equal_to<K>,
+        class BucketPolicy = modulo_bucket_policy,
+        class ProbePolicy = linear_probe_policy,
+        class HashCachePolicy = auto_hash_cache_policy
+        >
+    using unordered_map = systems_dsa::unordered_map<K, V, Hasher, KeyEqual, BucketPolicy, ProbePolicy, HashCachePolicy,
+        std::pmr::polymorphic_allocator<std::pair<const K, V>>>;
+}
 }
\ No newline at end of file
@@ -0,0 +1,376 @@
+#pragma once
+#include <systems_dsa/unordered_map.hpp>
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace systems_dsa {
+
+namespace detail {
+    // Fixed-size prefix of a snapshot file. The control bytes start at `ctrlOffset`, the bucket array at
+    // `bucketsOffset`, both exactly as they are laid out in memory by the unordered_map that was written.
+    // The hash cache policy is recorded through `hashOffset`.
+    struct SnapshotHeader {
+        constexpr static std::uint64_t currentMagic { 0x3150414D48534453ull }; // "SDSHMAP1", little endian
+        constexpr static std::uint32_t currentVersion { 2 };
+        // No cached hash in the buckets
+        constexpr static std::uint64_t noHashOffset { std::numeric_limits<std::uint64_t>::max() };
+
+        std::uint64_t magic {};
+        std::uint32_t version {};
+        std::uint32_t groupWidth {};
+        std::uint32_t bucketPolicy {};
+        std::uint32_t robinHood {};
+        std::uint64_t keySize {};
+        std::uint64_t valueSize {};
+        std::uint64_t elementSize {};
+        std::uint64_t bucketStride {};
+        std::uint64_t hashOffset {};
+        std::uint64_t bucketCount {};
+        std::uint64_t size {};
+        std::uint64_t ctrlOffset {};
+        std::uint64_t bucketsOffset {};
+        std::uint64_t fileSize {};
+    };
+
+    // Tells the library's bucket policies apart in a snapshot header. User-defined policies all record 0, so they're
+    // only checked against the bucket count.
+    template <class BucketPolicy>
+    constexpr std::uint32_t snapshotBucketPolicy { 0 };
+    template <>
+    constexpr std::uint32_t snapshotBucketPolicy<modulo_bucket_policy> { 1 };
+    template <>
+    constexpr std::uint32_t snapshotBucketPolicy<power_of_two_bucket_policy> { 2 };
+}
+
+// A read-only unordered_map loaded straight from a file written by `write`.
+// The file mirrors the control bytes and bucket array of the map, so `open` maps it and is done: no element is read,
+// hashed or copied, and pages are only faulted in as lookups touch them.
+// Keys and values must be trivially copyable, and the file is only readable by a build with the same Hasher, policies,
+// type layouts and endianness. Hasher must give the same hashes in every process, which std::hash
+// does for integers but isn't required to for anything else.
+template <
+    typename K,
+    typename V,
+    class Hasher,
+    class KeyEqual,
+    class BucketPolicy,
+    class ProbePolicy,
+    class HashCachePolicy
+    >
+requires ValidHasher<Hasher, K> &&
+    ValidKeyEqual<KeyEqual, K> &&
+    ValidBucketPolicy<BucketPolicy> &&
+    ValidProbePolicy<ProbePolicy> &&
+    ValidHashCachePolicy<HashCachePolicy, K>
+class unordered_map_snapshot {
+    static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>,
+        "unordered_map_snapshot requires trivially copyable keys and values");
+
+    using ctrl_t = detail::ctrl_t;
+    using Group = detail::Group;
+    using Header = detail::SnapshotHeader;
+    using map_type = unordered_map<K, V, Hasher, KeyEqual, BucketPolicy, ProbePolicy, HashCachePolicy>;
+    using Bucket = typename map_type::Bucket;
+
+public:
+    using value_type = std::pair<const K, V>;
+
+private:
+    //////////////////
+    // Data Members //
+    //////////////////
+    const std::byte* m_data { nullptr };
+    std::size_t m_fileSize {};
+    const ctrl_t* m_ctrl { nullptr };
+    const std::byte* m_buckets { nullptr };
+    std::size_t m_bucketCount {};
+    std::size_t m_size {};
+    Hasher m_hasher;
+    KeyEqual m_eq;
+
+    // Owns the mapping from here on, the layout is only read once the header has been validated
+    unordered_map_snapshot(const std::byte* data, std::size_t fileSize) : m_data { data }, m_fileSize { fileSize } {}
+
+    void unmap() noexcept {
+        if (m_data) {
+            ::munmap(const_cast<std::byte*>(m_data), m_fileSize);
+            m_data = nullptr;
+        }
+    }
+
+    // The mapped bytes are a copy of live value_type objects, so they're used as such
+    const value_type& element(std::size_t index) const noexcept {
+        return *std::launder(reinterpret_cast<const value_type*>(m_buckets + index * sizeof(Bucket)));
+    }
+
+    std::size_t cachedHash(std::size_t index) const noexcept {
+        std::size_t hash {};
+        std::memcpy(&hash, m_buckets + index * sizeof(Bucket) + bucketHashOffset(), sizeof(hash));
+        return hash;
+    }
+
+    // Same probe as unordered_map::probeForKey: a Group at a time, stopping at the first window holding an OPEN bucket
+    std::size_t probeForKey(const K& key) const {
+        const std::size_t hashedKey { m_hasher(key) };
+        const ctrl_t tag { map_type::getTag(hashedKey) };
+        std::size_t index { BucketPolicy::index(hashedKey, m_bucketCount) };
+        for (std::size_t probed {}; probed < m_bucketCount; probed += Group::width) {
+            const Group group { m_ctrl + index };
+            for (std::uint32_t match { group.match(tag) }; match != 0; match &= match - 1) {
+                const std::size_t candidate { map_type::wrapIndex(index + std::countr_zero(match), m_bucketCount) };
+                if constexpr (map_type::cachesHash) {
+                    if (cachedHash(candidate) != hashedKey) {
+                        continue;
+                    }
+                }
+                if (m_eq(element(candidate).first, key)) {
+                    return candidate;
+                }
+            }
+            if (group.matchOpen() != 0) {
+                return m_bucketCount;
+            }
+            index = map_type::wrapIndex(index + Group::width, m_bucketCount);
+        }
+        return m_bucketCount;
+    }
+
+    static void throwErrno(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    static std::size_t alignUp(std::size_t offset, std::size_t alignment) noexcept {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    static std::uint64_t bucketHashOffset() noexcept {
+        if constexpr (map_type::cachesHash) {
+            return offsetof(Bucket, hash);
+        } else {
+            return Header::noHashOffset;
+        }
+    }
+
+public:
+    unordered_map_snapshot(const unordered_map_snapshot& other) = delete;
+    unordered_map_snapshot& operator=(const unordered_map_snapshot& other) = delete;
+
+    unordered_map_snapshot(unordered_map_snapshot&& other) noexcept
+        : m_data { std::exchange(other.m_data, nullptr) }
+        , m_fileSize { std::exchange(other.m_fileSize, 0) }
+        , m_ctrl { other.m_ctrl }
+        , m_buckets { other.m_buckets }
+        , m_bucketCount { std::exchange(other.m_bucketCount, 0) }
+        , m_size { std::exchange(other.m_size, 0) }
+        , m_hasher { std::move(other.m_hasher) }
+        , m_eq { std::move(other.m_eq) }
+    {}
+
+    unordered_map_snapshot& operator=(unordered_map_snapshot&& other) noexcept {
+        if (&other == this) {
+            return *this;
+        }
+        unmap();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_fileSize = std::exchange(other.m_fileSize, 0);
+        m_ctrl = other.m_ctrl;
+        m_buckets = other.m_buckets;
+        m_bucketCount = std::exchange(other.m_bucketCount, 0);
+        m_size = std::exchange(other.m_size, 0);
+        m_hasher = std::move(other.m_hasher);
+        m_eq = std::move(other.m_eq);
+        return *this;
+    }
+
+    ~unordered_map_snapshot() {
+        unmap();
+    }
+
+    ///////////////////////
+    // Writing / Loading //
+    ///////////////////////
+
+    // Writes the control bytes and buckets of `hashMap` to `path`, replacing the file.
+    // Only the key, value and cached hash of FILLED buckets are written, every other byte (padding and buckets that
+    // aren't FILLED) is zero, so the same map always produces the same file. Padding inside K or V themselves is
+    // copied as is.
+    template <class Allocator>
+    static void write(const unordered_map<K, V, Hasher, KeyEqual, BucketPolicy, ProbePolicy, HashCachePolicy, Allocator>& hashMap,
+        const std::filesystem::path& path) {
+        const auto& table { hashMap.m_table };
+
+        Header header {};
+        header.magic = Header::currentMagic;
+        header.version = Header::currentVersion;
+        header.groupWidth = Group::width;
+        header.bucketPolicy = detail::snapshotBucketPolicy<BucketPolicy>;
+        header.robinHood = ProbePolicy::robin_hood ? 1 : 0;
+        header.keySize = sizeof(K);
+        header.valueSize = sizeof(V);
+        header.elementSize = sizeof(value_type);
+        header.bucketStride = sizeof(Bucket);
+        header.hashOffset = bucketHashOffset();
+        header.bucketCount = table.size();
+        header.size = hashMap.size();
+        header.ctrlOffset = sizeof(Header);
+        // Mappings are page aligned, so aligning the offset aligns every bucket in memory too
+        header.bucketsOffset = alignUp(header.ctrlOffset + table.ctrl.size(), std::max<std::size_t>(alignof(Bucket), 64));
+        header.fileSize = header.bucketsOffset + table.size() * sizeof(Bucket);
+
+        std::ofstream out { path, std::ios::binary | std::ios::trunc };
+        if (!out) {
+            throw std::runtime_error("Could not open " + path.string() + " for writing");
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        out.write(reinterpret_cast<const char*>(&table.ctrl[0]), static_cast<std::streamsize>(table.ctrl.size()));
+        for (std::size_t i { header.ctrlOffset + table.ctrl.size() }; i < header.bucketsOffset; ++i) {
+            out.put('\0');
+        }
+
+        // Staged a chunk of buckets at a time into a zeroed buffer, copying only the fields of each FILLED bucket
+        constexpr std::size_t chunkBuckets { std::max<std::size_t>(1, (64 * 1024) / sizeof(Bucket)) };
+        vector<std::byte> chunk {};
+        chunk.resize(chunkBuckets * sizeof(Bucket));
+        for (std::size_t first {}; first < table.size(); first += chunkBuckets) {
+            const std::size_t count { std::min(chunkBuckets, table.size() - first) };
+            std::memset(&chunk[0], 0, count * sizeof(Bucket));
+            for (std::size_t i {}; i < count; ++i) {
+                if (!detail::isFilled(table.ctrl[first + i])) {
+                    continue;
+                }
+                const auto& bucket { table.buckets[first + i] };
+                const value_type& element { *bucket.ptr() };
+                // Each field lands at the same offset in the chunk as in the bucket
+                const auto copyField = [&](const void* field, std::size_t size) {
+                    const auto offset { static_cast<const std::byte*>(field) - reinterpret_cast<const std::byte*>(&bucket) };
+                    std::memcpy(&chunk[i * sizeof(Bucket) + static_cast<std::size_t>(offset)], field, size);
+                };
+                copyField(&element.first, sizeof(K));
+                copyField(&element.second, sizeof(V));
+                if constexpr (map_type::cachesHash) {
+                    copyField(&bucket.hash, sizeof(bucket.hash));
+                }
+            }
+            out.write(reinterpret_cast<const char*>(&chunk[0]), static_cast<std::streamsize>(count * sizeof(Bucket)));
+        }
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("Failed writing snapshot to " + path.string());
+        }
+    }
+
+    // Maps the snapshot at `path` read-only. Throws std::system_error if it can't be mapped, and std::runtime_error if
+    // it wasn't written for this K, V, policies and build, or its header is corrupt.
+    static unordered_map_snapshot open(const std::filesystem::path& path) {
+        const int fd { ::open(path.c_str(), O_RDONLY | O_CLOEXEC) };
+        if (fd < 0) {
+            throwErrno("open snapshot");
+        }
+        struct stat status {};
+        if (::fstat(fd, &status) != 0) {
+            ::close(fd);
+            throwErrno("stat snapshot");
+        }
+        const auto fileSize { static_cast<std::size_t>(status.st_size) };
+        if (fileSize < sizeof(Header)) {
+            ::close(fd);
+            throw std::runtime_error(path.string() + " is too small to be a snapshot");
+        }
+        void* mapped { ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0) };
+        // The mapping holds its own reference to the file
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            throwErrno("mmap snapshot");
+        }
+
+        unordered_map_snapshot snapshot { static_cast<const std::byte*>(mapped), fileSize };
+        Header header {};
+        std::memcpy(&header, mapped, sizeof(Header));
+        if (header.magic != Header::currentMagic || header.version != Header::currentVersion) {
+            throw std::runtime_error(path.string() + " is not a snapshot of this version");
+        }
+        if (header.groupWidth != Group::width || header.keySize != sizeof(K) || header.valueSize != sizeof(V)
+            || header.elementSize != sizeof(value_type) || header.bucketStride != sizeof(Bucket)) {
+            throw std::runtime_error(path.string() + " was written for a different key/value layout");
+        }
+        // An exact hashOffset also keeps the cached hash inside the bucket
+        if (header.bucketPolicy != detail::snapshotBucketPolicy<BucketPolicy>
+            || header.robinHood != (ProbePolicy::robin_hood ? 1u : 0u) || header.hashOffset != bucketHashOffset()) {
+            throw std::runtime_error(path.string() + " was written for different bucket, probe or hash cache policies");
+        }
+        // Every offset is checked against the file size before anything is added to it or multiplied, so none of the
+        // bounds can wrap around
+        if (header.fileSize != fileSize || header.ctrlOffset < sizeof(Header) || header.bucketsOffset > fileSize
+            || header.ctrlOffset > header.bucketsOffset || header.bucketCount == 0
+            || header.bucketCount > (fileSize - header.bucketsOffset) / header.bucketStride
+            || header.bucketCount + Group::width - 1 > header.bucketsOffset - header.ctrlOffset
+            || header.bucketsOffset % alignof(Bucket) != 0 || header.size > header.bucketCount
+            || BucketPolicy::bucket_count(header.bucketCount) != header.bucketCount) {
+            throw std::runtime_error(path.string() + " is truncated or corrupt");
+        }
+        snapshot.m_ctrl = reinterpret_cast<const ctrl_t*>(snapshot.m_data + header.ctrlOffset);
+        snapshot.m_buckets = snapshot.m_data + header.bucketsOffset;
+        snapshot.m_bucketCount = header.bucketCount;
+        snapshot.m_size = header.size;
+        return snapshot;
+    }
+
+    ////////////
+    // Lookup //
+    ////////////
+
+    // Returns a pointer to the element, nullptr if the key wasn't found
+    const value_type* find(const K& key) const {
+        const std::size_t index { probeForKey(key) };
+        return index < m_bucketCount ? &element(index) : nullptr;
+    }
+
+    bool contains(const K& key) const {
+        return probeForKey(key) < m_bucketCount;
+    }
+
+    const V& at(const K& key) const {
+        const std::size_t index { probeForKey(key) };
+        if (index >= m_bucketCount) {
+            throw std::out_of_range("The key provided was not found in the snapshot\n");
+        }
+        return element(index).second;
+    }
+
+    // Calls fn(const K&, const V&) for every element, in bucket order
+    template <typename F>
+    void for_each(F&& fn) const {
+        for (std::size_t i {}; i < m_bucketCount; ++i) {
+            if (detail::isFilled(m_ctrl[i])) {
+                fn(element(i).first, element(i).second);
+            }
+        }
+    }
+
+    //////////////
+    // Capacity //
+    //////////////
+
+    std::size_t size() const noexcept {
+        return m_size;
+    }
+
+    bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    std::size_t bucket_count() const noexcept {
+        return m_bucketCount;
+    }
+};
+
+}
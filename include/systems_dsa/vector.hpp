@@ -1,8 +1,18 @@
 #pragma once
+#include <algorithm>
+#include <bit>
 #include <cassert>
+#include <compare>
+#include <concepts>
+#include <cstring>
+#include <initializer_list>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
 #include <type_traits>
-#include <optional>
+#include <ranges>
+#include <utility>
 
 #ifndef NDEBUG
 #define VEC_ASSERT_VALID() assertValid();
@@ -13,54 +23,348 @@
 // TODO: Test move and copy semantics of the container
 
 namespace systems_dsa {
+    // Whether a T can be moved to new storage with memcpy, without running its move constructor and the moved-from
+    // object's destructor. True for trivially copyable types. Specialize it to opt in types that are only
+    // trivially relocatable, e.g. ones that own a heap pointer like std::unique_ptr.
     template <typename T>
+    struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+    template <typename T>
+    inline constexpr bool is_trivially_relocatable_v { is_trivially_relocatable<T>::value };
+
+    namespace detail {
+        template <typename Allocator>
+        inline constexpr bool isPolymorphicAllocator { false };
+
+        template <typename T>
+        inline constexpr bool isPolymorphicAllocator<std::pmr::polymorphic_allocator<T>> { true };
+
+        // memcpy bypasses the allocator's construct() and destroy(), so the bitwise paths are only taken when those
+        // would be plain placement-new and ~T(): the allocator doesn't define them, or it's a polymorphic_allocator
+        // and T doesn't take allocators
+        template <typename T, typename Allocator>
+        inline constexpr bool plainConstruct {
+            (!requires (Allocator& alloc, T* ptr) { alloc.construct(ptr, std::move(*ptr)); }
+                && !requires (Allocator& alloc, T* ptr) { alloc.destroy(ptr); })
+            || (isPolymorphicAllocator<Allocator> && !std::uses_allocator_v<T, Allocator>) };
+
+        // Relocation memcpys the elements over and frees the old block without destroying them
+        template <typename T, typename Allocator>
+        inline constexpr bool relocatesBitwise { is_trivially_relocatable_v<T> && plainConstruct<T, Allocator> };
+
+        // Copies (and moves, which leave the source intact) memcpy the elements
+        template <typename T, typename Allocator>
+        inline constexpr bool copiesBitwise { std::is_trivially_copyable_v<T> && plainConstruct<T, Allocator> };
+
+        // Destruction can be skipped only if neither T nor the allocator does anything on destroy
+        template <typename T, typename Allocator>
+        inline constexpr bool trivialDestroy { std::is_trivially_destructible_v<T>
+            && !requires (Allocator& alloc, T* ptr) { alloc.destroy(ptr); } };
+
+        // Destroys `count` elements in reverse order
+        template <typename T, typename Allocator>
+        void destroyElements(Allocator& alloc, T* data, std::size_t count) noexcept(std::is_nothrow_destructible_v<T>) {
+            if constexpr (!trivialDestroy<T, Allocator>) {
+                for (std::size_t i { count }; i > 0; --i) {
+                    std::allocator_traits<Allocator>::destroy(alloc, data + (i - 1));
+                }
+            }
+        }
+
+        // Moves `count` elements from `src` into the uninitialized `dst` and ends their lifetime in `src`, shared by
+        // every container that reallocates contiguous storage. Trivially relocatable elements go over in one memcpy,
+        // the rest are moved (or copied, if moving could throw) one by one. If that throws, the elements constructed
+        // in `dst` are destroyed and `src` is left as it was.
+        template <typename T, typename Allocator>
+        void relocateElements(Allocator& alloc, T* src, std::size_t count, T* dst) {
+            if constexpr (relocatesBitwise<T, Allocator>) {
+                if (count > 0) {
+                    std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), count * sizeof(T));
+                }
+            } else {
+                std::size_t i {};
+                try {
+                    for (; i < count; ++i) {
+                        std::allocator_traits<Allocator>::construct(alloc, dst + i, std::move_if_noexcept(src[i]));
+                    }
+                } catch (...) {
+                    destroyElements(alloc, dst, i);
+                    throw;
+                }
+                destroyElements(alloc, src, count);
+            }
+        }
+
+        // Constructs `count` elements in the uninitialized `dst` from `first`, shared by the bulk modifiers of every
+        // contiguous container. Trivially copyable elements from a contiguous range of T are copied with one memcpy.
+        // If one throws, the ones already constructed are destroyed.
+        template <typename T, typename Allocator, typename It>
+        void constructElements(Allocator& alloc, T* dst, It first, std::size_t count) {
+            if constexpr (copiesBitwise<T, Allocator> && std::contiguous_iterator<It>
+                && std::same_as<std::iter_value_t<It>, T>) {
+                if (count > 0) {
+                    std::memcpy(static_cast<void*>(dst), static_cast<const void*>(std::to_address(first)), count * sizeof(T));
+                }
+            } else {
+                std::size_t i {};
+                try {
+                    for (; i < count; ++i, ++first) {
+                        std::allocator_traits<Allocator>::construct(alloc, dst + i, *first);
+                    }
+                } catch (...) {
+                    destroyElements(alloc, dst, i);
+                    throw;
+                }
+            }
+        }
+
+        // The steps below grow and shift the elements of vector and small_vector. They take the container's allocator
+        // and its block, size and capacity, which are updated in place. `release(block, capacity)` frees a block the
+        // container is done with: vector deallocates it, small_vector only if it isn't the inline storage.
+
+        // Moves the elements to a new block of exactly `newCapacity`. If relocating throws, nothing changes.
+        template <typename T, typename Allocator, typename Release>
+        void reallocateElements(Allocator& alloc, T*& data, std::size_t size, std::size_t& capacity, Release release,
+            std::size_t newCapacity) {
+            T* newData { std::allocator_traits<Allocator>::allocate(alloc, newCapacity) };
+            try {
+                relocateElements(alloc, data, size, newData);
+            } catch (...) {
+                std::allocator_traits<Allocator>::deallocate(alloc, newData, newCapacity);
+                throw;
+            }
+            release(data, capacity);
+            data = newData;
+            capacity = newCapacity;
+        }
+
+        // Makes room for `count` more elements, growing by the growth policy at most once
+        template <typename GrowthPolicy, typename T, typename Allocator, typename Release>
+        void growFor(Allocator& alloc, T*& data, std::size_t size, std::size_t& capacity, Release release,
+            std::size_t count) {
+            if (size + count > capacity) {
+                reallocateElements(alloc, data, size, capacity, release,
+                    GrowthPolicy::grow(capacity, size + count, sizeof(T)));
+            }
+        }
+
+        // Appends an element to a full block. It's constructed in the new block before the old elements are relocated,
+        // so `args` may refer to one of them, as in v.push_back(v.back()). If either step throws, nothing changes.
+        template <typename GrowthPolicy, typename T, typename Allocator, typename Release, typename... Args>
+        T& emplaceGrowing(Allocator& alloc, T*& data, std::size_t& size, std::size_t& capacity, Release release,
+            Args&&... args) {
+            using alloc_traits = std::allocator_traits<Allocator>;
+            assert(size == capacity);
+            const std::size_t newCapacity { GrowthPolicy::grow(capacity, size + 1, sizeof(T)) };
+            assert(newCapacity > size && "The growth policy returned less than the required capacity");
+            T* newData { alloc_traits::allocate(alloc, newCapacity) };
+            try {
+                alloc_traits::construct(alloc, newData + size, std::forward<Args>(args)...);
+            } catch (...) {
+                alloc_traits::deallocate(alloc, newData, newCapacity);
+                throw;
+            }
+            try {
+                relocateElements(alloc, data, size, newData);
+            } catch (...) {
+                alloc_traits::destroy(alloc, newData + size);
+                alloc_traits::deallocate(alloc, newData, newCapacity);
+                throw;
+            }
+            release(data, capacity);
+            data = newData;
+            capacity = newCapacity;
+            return data[size++];
+        }
+
+        // Constructs `count` elements from `first` at the end, growing at most once
+        template <typename GrowthPolicy, typename T, typename Allocator, typename Release, typename It>
+        void appendElements(Allocator& alloc, T*& data, std::size_t& size, std::size_t& capacity, Release release,
+            It first, std::size_t count) {
+            growFor<GrowthPolicy>(alloc, data, size, capacity, release, count);
+            constructElements(alloc, data + size, first, count);
+            size += count;
+        }
+
+        // Relocates the elements from `index` on `count` places up, leaving [index, index + count) uninitialized and
+        // `size` unchanged. If that needs a bigger block, both halves are relocated straight into their places in it.
+        template <typename GrowthPolicy, typename T, typename Allocator, typename Release>
+        requires relocatesBitwise<T, Allocator>
+        void openGap(Allocator& alloc, T*& data, std::size_t size, std::size_t& capacity, Release release,
+            std::size_t index, std::size_t count) {
+            const std::size_t tail { size - index };
+            if (size + count > capacity) {
+                const std::size_t newCapacity { GrowthPolicy::grow(capacity, size + count, sizeof(T)) };
+                T* newData { std::allocator_traits<Allocator>::allocate(alloc, newCapacity) };
+                if (index > 0) {
+                    std::memcpy(static_cast<void*>(newData), static_cast<const void*>(data), index * sizeof(T));
+                }
+                if (tail > 0) {
+                    std::memcpy(static_cast<void*>(newData + index + count), static_cast<const void*>(data + index),
+                        tail * sizeof(T));
+                }
+                release(data, capacity);
+                data = newData;
+                capacity = newCapacity;
+            } else if (tail > 0) {
+                std::memmove(static_cast<void*>(data + index + count), static_cast<const void*>(data + index),
+                    tail * sizeof(T));
+            }
+        }
+
+        // Undoes openGap, the gap must be uninitialized again. A bigger block it moved to is kept.
+        template <typename T>
+        void closeGap(T* data, std::size_t size, std::size_t index, std::size_t count) noexcept {
+            const std::size_t tail { size - index };
+            if (tail > 0) {
+                std::memmove(static_cast<void*>(data + index), static_cast<const void*>(data + index + count),
+                    tail * sizeof(T));
+            }
+        }
+
+        // Constructs `count` elements from `first` before `index`, growing at most once. Trivially relocatable
+        // elements after `index` are shifted with one memmove (straight into their place in the new block if it
+        // reallocates), others are appended then rotated into place.
+        template <typename GrowthPolicy, typename T, typename Allocator, typename Release, typename It>
+        void insertElements(Allocator& alloc, T*& data, std::size_t& size, std::size_t& capacity, Release release,
+            std::size_t index, It first, std::size_t count) {
+            if constexpr (relocatesBitwise<T, Allocator>) {
+                openGap<GrowthPolicy>(alloc, data, size, capacity, release, index, count);
+                try {
+                    constructElements(alloc, data + index, first, count);
+                } catch (...) {
+                    closeGap(data, size, index, count);
+                    throw;
+                }
+                size += count;
+            } else {
+                appendElements<GrowthPolicy>(alloc, data, size, capacity, release, first, count);
+                std::rotate(data + index, data + size - count, data + size);
+            }
+        }
+
+        // Erases [from, to). Trivially relocatable elements after it are shifted down with one memmove, others are
+        // move-assigned down.
+        template <typename T, typename Allocator>
+        void eraseElements(Allocator& alloc, T* data, std::size_t& size, std::size_t from, std::size_t to) {
+            const std::size_t erased { to - from };
+            const std::size_t tail { size - to };
+            if constexpr (relocatesBitwise<T, Allocator>) {
+                destroyElements(alloc, data + from, erased);
+                if (tail > 0) {
+                    std::memmove(static_cast<void*>(data + from), static_cast<const void*>(data + to), tail * sizeof(T));
+                }
+            } else {
+                std::move(data + to, data + size, data + from);
+                destroyElements(alloc, data + from + tail, erased);
+            }
+            size -= erased;
+        }
+    }
+
+    // ---------------------
+    // Growth Policies
+    // ---------------------
+    // A growth policy picks the new capacity when a push finds the vector full. grow() is given the current capacity,
+    // the capacity that's required, and sizeof(T), and must return at least `required`.
+    // reserve(), resize() and the sized constructor don't consult it, they allocate exactly what they're asked for.
+
+    // Grows by half of the current capacity. Freed blocks can eventually be reused by later growth of the same vector.
+    struct one_and_half_growth_policy {
+        constexpr static std::size_t min_capacity { 4 };
+
+        static std::size_t grow(std::size_t capacity, std::size_t required, std::size_t) noexcept {
+            return std::max({ capacity + capacity / 2, required, min_capacity });
+        }
+    };
+
+    // Doubles the capacity: fewer reallocations than 1.5x, up to twice the memory in use
+    struct doubling_growth_policy {
+        constexpr static std::size_t min_capacity { 4 };
+
+        static std::size_t grow(std::size_t capacity, std::size_t required, std::size_t) noexcept {
+            return std::max({ capacity * 2, required, min_capacity });
+        }
+    };
+
+    // Grows by 1.5x, then rounds the block up to the next malloc size class (16 byte steps up to 128 bytes, then four
+    // classes per power of two, like jemalloc and tcmalloc), so the slack the allocator would round in anyway is used
+    // as capacity instead of being wasted.
+    struct size_class_growth_policy {
+        static std::size_t size_class(std::size_t bytes) noexcept {
+            if (bytes <= 128) {
+                return (bytes + 15) & ~std::size_t { 15 };
+            }
+            const std::size_t step { std::bit_floor(bytes - 1) >> 2 };
+            return (bytes + step - 1) & ~(step - 1);
+        }
+
+        static std::size_t grow(std::size_t capacity, std::size_t required, std::size_t elementSize) noexcept {
+            const std::size_t bytes { std::max(capacity + capacity / 2, required) * elementSize };
+            return size_class(bytes) / elementSize;
+        }
+    };
+
+    template <typename P>
+    concept ValidGrowthPolicy = requires(std::size_t n) {
+        { P::grow(n, n, n) } -> std::convertible_to<std::size_t>;
+    };
+
+    // Storage is obtained through `Allocator`, with std::allocator_traits semantics, so any standard allocator
+    // (including std::pmr::polymorphic_allocator) can place the elements.
+    // `GrowthPolicy` picks the capacity a full vector grows to, see the growth policies above.
+    template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = one_and_half_growth_policy>
+    requires ValidGrowthPolicy<GrowthPolicy>
     class vector {
+        static_assert(std::is_same_v<typename std::allocator_traits<Allocator>::value_type, T>,
+            "Allocator::value_type must match the vector's value_type");
+        using alloc_traits = std::allocator_traits<Allocator>;
     private:
         template <bool IsConst>
         class iterator_impl;
     public:
         using reference = T&;
-        using const_reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
         using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
         using value_type = T;
-        using const_iterator = iterator_impl<true>&;
+        using allocator_type = Allocator;
+        using growth_policy = GrowthPolicy;
+        using const_iterator = iterator_impl<true>;
         using iterator = iterator_impl<false>;
 
 
     // ---------------------
     // Constructors / Destructor
     // ---------------------
-        // Default constructor
-        vector() {
-            allocate(5);
-            VEC_ASSERT_VALID();
-        };
+        // Default constructor, allocates nothing until the first element is added
+        vector() : vector(Allocator()) {}
 
-        // Constructor with size
-        explicit vector(size_type n) : m_capacity { n }  {
-            allocate(n);
+        explicit vector(const Allocator& alloc) noexcept : m_alloc { alloc } {}
+
+        // Constructor with size, reserves exactly `n` elements without constructing any
+        explicit vector(size_type n, const Allocator& alloc = Allocator()) : m_alloc { alloc } {
+            allocateEmpty(n);
             VEC_ASSERT_VALID();
         }
 
-        vector(std::initializer_list<value_type> list) {
-            allocate(list.size());
+        vector(std::initializer_list<value_type> list, const Allocator& alloc = Allocator()) : m_alloc { alloc } {
+            allocateEmpty(list.size());
             for (auto element : list) {
                 push_back(std::move_if_noexcept(element));
             }
         }
 
         // Copy constructor
-        vector(const vector& other) {
-            allocate(other.capacity());
-            assert(m_capacity == other.capacity());
-            try {
-                for (size_type i {}; i < other.size(); ++i) {
-                    push_back(other.m_data[i]);
-                }
-                assert(m_size == other.size());
-            } catch (...) {
-                throw;
-            }
+        vector(const vector& other)
+            : vector(other, alloc_traits::select_on_container_copy_construction(other.m_alloc)) {}
+
+        vector(const vector& other, const Allocator& alloc) : m_alloc { alloc } {
+            allocateEmpty(other.size());
+            appendFrom<false>(other.m_data, other.size());
+            assert(m_size == other.size());
             VEC_ASSERT_VALID();
         }
 
@@ -71,41 +375,59 @@ namespace systems_dsa {
             }
 
             destroyData(m_data, m_size);
-            deallocate(m_data);
-            allocate(other.capacity());
-            assert(m_capacity == other.capacity());
-            for (size_type i {}; i < other.size(); ++i) {
-                push_back(other.m_data[i]);
+            deallocate(m_data, m_capacity);
+            m_data = nullptr;
+            m_size = 0;
+            m_capacity = 0;
+            if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+                m_alloc = other.m_alloc;
             }
+            allocateEmpty(other.size());
+            appendFrom<false>(other.m_data, other.size());
             assert(m_size == other.size());
             VEC_ASSERT_VALID();
             return *this;
         }
 
         // Move constructor
-        vector(vector&& other) noexcept {
-            m_data = other.m_data;
-            m_capacity = other.capacity();
-            m_size = other.size();
-            other.m_data = nullptr;
-            other.m_size = 0;
+        vector(vector&& other) noexcept : m_alloc { std::move(other.m_alloc) } {
+            steal(other);
+            VEC_ASSERT_VALID();
+        }
+
+        // Only steals the storage if `alloc` can free it, otherwise the elements are moved one by one
+        vector(vector&& other, const Allocator& alloc) : m_alloc { alloc } {
+            if (m_alloc == other.m_alloc) {
+                steal(other);
+            } else {
+                allocateEmpty(other.size());
+                appendFrom<true>(other.m_data, other.size());
+            }
             VEC_ASSERT_VALID();
         }
 
         // Move assignment
-        vector& operator=(vector&& other) noexcept {
+        vector& operator=(vector&& other) noexcept(alloc_traits::propagate_on_container_move_assignment::value
+            || alloc_traits::is_always_equal::value) {
             if (&other == this) {
                 return *this;
             }
 
             destroyData(m_data, m_size);
-            deallocate(m_data);
-            m_data = other.m_data;
-            other.m_data = nullptr;
-            m_capacity = other.capacity();
-            m_size = other.size();
-            other.m_size = 0;
-            other.m_capacity = 0;
+            deallocate(m_data, m_capacity);
+            m_data = nullptr;
+            m_size = 0;
+            m_capacity = 0;
+            if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+                m_alloc = std::move(other.m_alloc);
+                steal(other);
+            } else if (m_alloc == other.m_alloc) {
+                steal(other);
+            } else {
+                // Storage from another allocator can't be adopted
+                allocateEmpty(other.size());
+                appendFrom<true>(other.m_data, other.size());
+            }
             VEC_ASSERT_VALID();
             return *this;
         }
@@ -113,10 +435,14 @@ namespace systems_dsa {
         // Destructor
         ~vector() {
             destroyData(m_data, m_size);
-            deallocate(m_data);
+            deallocate(m_data, m_capacity);
             m_size = 0;
             m_capacity = 0;
         }
+
+        allocator_type get_allocator() const noexcept {
+            return m_alloc;
+        }
     // ---------------------
     // Size & Capacity
     // ---------------------
@@ -130,9 +456,9 @@ namespace systems_dsa {
             return m_size == 0;
         }
 
+        // Allocates exactly `newCapacity`, does nothing if the capacity is already at least that
         constexpr void reserve(size_type newCapacity) {
             if (newCapacity <= m_capacity) {
-                std::cerr << "Cannot reserve less than or equal to current capacity.\n";
                 return;
             }
             allocate(newCapacity);
@@ -147,11 +473,13 @@ namespace systems_dsa {
                 destroyData(m_data + newSize, m_size - newSize); // Resize down to newSize elements
                 m_size = newSize;
             } else {
-                // Increase size
+                // Increase size, reallocating to exactly newSize if it doesn't fit
                 size_type oldSize { m_size };
-                allocate(getExpandedCapacity(newSize));
+                if (newSize > m_capacity) {
+                    allocate(newSize);
+                }
                 for (size_type i { oldSize }; i < newSize; ++i) {
-                    new (m_data + i) T();
+                    alloc_traits::construct(m_alloc, m_data + i);
                 }
                 m_size = newSize;
             }
@@ -166,7 +494,6 @@ namespace systems_dsa {
 
             // shrink_to_fit is a suggestion, we're trying to avoid waste here
             if (m_capacity > m_size * 2) {
-                delete m_data;
                 allocate(m_size);
             }
             VEC_ASSERT_VALID();
@@ -214,6 +541,14 @@ namespace systems_dsa {
             return m_data[m_size - 1];
         }
 
+        // data(), the elements are contiguous. Null while nothing has been allocated.
+        T* data() noexcept {
+            return m_data;
+        }
+        const T* data() const noexcept {
+            return m_data;
+        }
+
     // ---------------------
     // Pushing & popping
     // ---------------------
@@ -227,21 +562,21 @@ namespace systems_dsa {
 
         template <typename... Args>
         reference emplace_back(Args&&... args) {
-            if (!m_data) {
-                allocate(5);
-            }
             if (m_size == m_capacity) {
-                expand();
+                T& element { detail::emplaceGrowing<GrowthPolicy>(m_alloc, m_data, m_size, m_capacity, blockReleaser(),
+                    std::forward<Args>(args)...) };
+                VEC_ASSERT_VALID();
+                return element;
             }
-            new (m_data + m_size) T(std::forward<Args>(args)...);
+            alloc_traits::construct(m_alloc, m_data + m_size, std::forward<Args>(args)...);
             ++m_size;
             VEC_ASSERT_VALID();
             return *(m_data + m_size - 1);
         }
 
         void pop_back() noexcept(std::is_nothrow_destructible_v<T>) {
-            if constexpr (!std::is_trivially_destructible_v<T>) {
-                (m_data + m_size - 1)->~T();
+            if constexpr (!trivialDestroy) {
+                alloc_traits::destroy(m_alloc, m_data + m_size - 1);
             }
             --m_size;
             VEC_ASSERT_VALID();
@@ -252,158 +587,342 @@ namespace systems_dsa {
             m_size = 0;
         }
 
+    // ---------------------
+    // Bulk modifiers
+    // ---------------------
+        // Appends every element of `range`. If its length is known up front, capacity grows once (by the growth
+        // policy, so appending in batches stays amortized) and trivially copyable elements from a contiguous range of
+        // T are copied with one memcpy. Otherwise it's an emplace_back per element.
+        template <std::ranges::input_range R>
+        void append_range(R&& range) {
+            if constexpr (std::ranges::forward_range<R> || std::ranges::sized_range<R>) {
+                const auto count { static_cast<size_type>(std::ranges::distance(range)) };
+                detail::appendElements<GrowthPolicy>(m_alloc, m_data, m_size, m_capacity, blockReleaser(),
+                    std::ranges::begin(range), count);
+            } else {
+                for (auto&& element : range) {
+                    emplace_back(std::forward<decltype(element)>(element));
+                }
+            }
+            VEC_ASSERT_VALID();
+        }
+
+        // Replaces the contents with `range`. Storage is reused if it's big enough, otherwise it's replaced by a block
+        // of exactly the new size.
+        template <std::ranges::input_range R>
+        void assign_range(R&& range) {
+            clear();
+            if constexpr (std::ranges::forward_range<R> || std::ranges::sized_range<R>) {
+                const auto count { static_cast<size_type>(std::ranges::distance(range)) };
+                if (count > m_capacity) {
+                    deallocate(m_data, m_capacity);
+                    m_data = nullptr;
+                    m_capacity = 0;
+                    allocateEmpty(count);
+                }
+                detail::constructElements(m_alloc, m_data, std::ranges::begin(range), count);
+                m_size = count;
+            } else {
+                append_range(std::forward<R>(range));
+            }
+            VEC_ASSERT_VALID();
+        }
+
+        template <std::input_iterator It, std::sentinel_for<It> S>
+        void assign(It first, S last) {
+            assign_range(std::ranges::subrange(std::move(first), std::move(last)));
+        }
+
+        void assign(std::initializer_list<value_type> list) {
+            assign_range(list);
+        }
+
+        // Like std::vector's, `value` must not be an element of this vector
+        void assign(size_type count, const value_type& value) {
+            clear();
+            if (count > m_capacity) {
+                deallocate(m_data, m_capacity);
+                m_data = nullptr;
+                m_capacity = 0;
+                allocateEmpty(count);
+            }
+            for (; m_size < count; ++m_size) {
+                alloc_traits::construct(m_alloc, m_data + m_size, value);
+            }
+            VEC_ASSERT_VALID();
+        }
+
+        // Inserts `range` before `pos` and returns an iterator to the first inserted element. With a known length,
+        // capacity grows once; trivially relocatable elements after `pos` are shifted with one memmove (straight into
+        // their place in the new block if it reallocates), others are appended then rotated into place.
+        template <std::ranges::input_range R>
+        iterator insert_range(const_iterator pos, R&& range) {
+            const auto index { static_cast<size_type>(pos.m_ptr - m_data) };
+            assert(index <= m_size && "Insert position is not in this vector");
+            const size_type oldSize { m_size };
+            if constexpr (std::ranges::forward_range<R> || std::ranges::sized_range<R>) {
+                const auto count { static_cast<size_type>(std::ranges::distance(range)) };
+                detail::insertElements<GrowthPolicy>(m_alloc, m_data, m_size, m_capacity, blockReleaser(), index,
+                    std::ranges::begin(range), count);
+            } else {
+                try {
+                    for (auto&& element : range) {
+                        emplace_back(std::forward<decltype(element)>(element));
+                    }
+                } catch (...) {
+                    destroyData(m_data + oldSize, m_size - oldSize);
+                    m_size = oldSize;
+                    throw;
+                }
+                std::rotate(m_data + index, m_data + oldSize, m_data + m_size);
+            }
+            VEC_ASSERT_VALID();
+            return iterator { m_data + index };
+        }
+
+        template <std::input_iterator It, std::sentinel_for<It> S>
+        iterator insert(const_iterator pos, It first, S last) {
+            return insert_range(pos, std::ranges::subrange(std::move(first), std::move(last)));
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<value_type> list) {
+            return insert_range(pos, list);
+        }
+
+        // Erases [first, last) and returns an iterator to the element that followed them. Trivially relocatable
+        // elements after the range are shifted down with one memmove, others are move-assigned down.
+        iterator erase(const_iterator first, const_iterator last) {
+            const auto from { static_cast<size_type>(first.m_ptr - m_data) };
+            const auto to { static_cast<size_type>(last.m_ptr - m_data) };
+            assert(from <= to && to <= m_size && "Erase range is not in this vector");
+            if (from == to) {
+                return iterator { m_data + from };
+            }
+            detail::eraseElements(m_alloc, m_data, m_size, from, to);
+            VEC_ASSERT_VALID();
+            return iterator { m_data + from };
+        }
+
+        iterator erase(const_iterator pos) {
+            return erase(pos, pos + 1);
+        }
+
+        // Like resize, but new elements are default-initialized instead of value-initialized, so trivial types are
+        // left uninitialized for the caller to overwrite. Allocators with their own construct() still value-initialize.
+        void resize_for_overwrite(size_type newSize) {
+            if (newSize <= m_size) {
+                resize(newSize);
+                return;
+            }
+            if (newSize > m_capacity) {
+                allocate(newSize);
+            }
+            if constexpr (detail::plainConstruct<T, Allocator>) {
+                std::uninitialized_default_construct(m_data + m_size, m_data + newSize);
+                m_size = newSize;
+            } else {
+                for (; m_size < newSize; ++m_size) {
+                    alloc_traits::construct(m_alloc, m_data + m_size);
+                }
+            }
+            VEC_ASSERT_VALID();
+        }
+
         // ---------------------
         // Iteration
         // ---------------------
 
         // begin()
-        iterator begin() {
-            return { 0, this };
+        iterator begin() noexcept {
+            return iterator { m_data };
         }
-        const_iterator begin() const {
-            return { 0, this };
+        const_iterator begin() const noexcept {
+            return const_iterator { m_data };
+        }
+        const_iterator cbegin() const noexcept {
+            return begin();
         }
 
         // end()
-        iterator end() {
-            return { m_size, this };
+        iterator end() noexcept {
+            return iterator { m_data + m_size };
+        }
+        const_iterator end() const noexcept {
+            return const_iterator { m_data + m_size };
         }
-        const_iterator end() const {
-            return { m_size, this };
+        const_iterator cend() const noexcept {
+            return end();
         }
 
     private:
         size_type m_capacity {}; // TODO: Figure out when + how to shrink capacity after size has decreased significantly
         size_type m_size {};
         T* m_data { nullptr };
+        [[no_unique_address]] Allocator m_alloc;
 
-        constexpr void allocate(size_type capacity, vector* vecPtr = nullptr) {
-            vector& vec = vecPtr ? *vecPtr : *this;
-            void* rawMem = ::operator new(sizeof(T) * capacity, static_cast<std::align_val_t>(alignof(T)));
+        constexpr static bool trivialDestroy { detail::trivialDestroy<T, Allocator> };
+        constexpr static bool copiesBitwise { detail::copiesBitwise<T, Allocator> };
 
-            if (!vec.m_data) {
-                // Initial allocation
-                assert(vec.m_size == 0);
-                vec.m_data = static_cast<T*>(rawMem);
-            } else {
-                // Reallocation
-                T* newData = static_cast<T*>(rawMem);
-                size_type i {};
-                try {
-                    for (; i < vec.m_size; ++i) {
-                        new (newData + i) T(std::move_if_noexcept(vec.m_data[i]));
-                    }
-                } catch (...) {
-                    destroyData(newData, i);
-                    deallocate(newData);
-                    throw;
-                }
+        // Takes over other's storage, leaving other empty
+        void steal(vector& other) noexcept {
+            m_data = std::exchange(other.m_data, nullptr);
+            m_capacity = std::exchange(other.m_capacity, 0);
+            m_size = std::exchange(other.m_size, 0);
+        }
 
-                // Destroy the old data and deallocate
-                destroyData(vec.m_data, vec.m_size);
-                deallocate(vec.m_data);
-                // Steal the new data
-                vec.m_data = newData;
-                vec.m_size = i;
+        // First allocation of a vector without storage, there's nothing to move over. A capacity of 0 allocates nothing.
+        void allocateEmpty(size_type capacity) {
+            assert(!m_data && m_size == 0);
+            if (capacity == 0) {
+                return;
             }
-
-            vec.m_capacity = capacity;
-
-            assert(vec.m_capacity >= vec.m_size && "m_capacity is greater than or equal to m_size after allocation");
+            m_data = alloc_traits::allocate(m_alloc, capacity);
+            m_capacity = capacity;
         }
 
-        void expand(std::optional<size_type> desiredCapacity = std::nullopt) {
-            assert(m_size <= m_capacity && "m_size is bigger than m_capacity, there's a bug\n");
-            assert(m_size == m_capacity && "m_size does not equal m_capacity when expansion was attempted\n");
-            if (m_size != m_capacity) {
-                std::cerr << "No need to expand, existing memory block still has room\n";
+        constexpr void allocate(size_type capacity, vector* vecPtr = nullptr) {
+            vector& vec = vecPtr ? *vecPtr : *this;
+            if (capacity == 0) {
+                // Shrinking an empty vector releases its storage
+                assert(vec.m_size == 0);
+                deallocate(vec.m_data, vec.m_capacity);
+                vec.m_data = nullptr;
+                vec.m_capacity = 0;
                 return;
             }
+            // An initial allocation has no elements to relocate and no block to free
+            detail::reallocateElements(vec.m_alloc, vec.m_data, vec.m_size, vec.m_capacity, vec.blockReleaser(), capacity);
 
-            size_type newCapacity { desiredCapacity.value_or(getExpandedCapacity()) };
-            assert(desiredCapacity.has_value() ? newCapacity == desiredCapacity.value() : true);
-            allocate(newCapacity);
+            assert(vec.m_capacity >= vec.m_size && "m_capacity is greater than or equal to m_size after allocation");
         }
 
-        size_type getExpandedCapacity(std::optional<size_type> newSize = std::nullopt) const {
-            size_type cap { newSize.value_or(m_capacity)};
-            return (cap + cap / 2);
+        // Appends `count` elements of `src` into storage that has room for them. Each one is copied, or moved if `Move`,
+        // unless T is trivially copyable, then they're all copied in one memcpy.
+        template <bool Move>
+        void appendFrom(T* src, size_type count) {
+            assert(m_size + count <= m_capacity);
+            if constexpr (copiesBitwise) {
+                if (count > 0) {
+                    std::memcpy(static_cast<void*>(m_data + m_size), static_cast<const void*>(src), count * sizeof(T));
+                }
+                m_size += count;
+            } else {
+                for (size_type i {}; i < count; ++i) {
+                    if constexpr (Move) {
+                        push_back(std::move(src[i]));
+                    } else {
+                        push_back(src[i]);
+                    }
+                }
+            }
         }
 
         void destroyData(T* data, size_type size) noexcept(std::is_nothrow_destructible_v<T>) {
-            if constexpr (!std::is_trivially_destructible_v<T>) {
-                // Reverse order destruction
-                for (size_type i { size }; i > 0; --i) {
-                    (data + (i - 1))->~T();
-                }
+            detail::destroyElements(m_alloc, data, size);
+        }
+        // `capacity` must be the count `data` was allocated with
+        void deallocate(T* data, size_type capacity) noexcept {
+            if (data) {
+                alloc_traits::deallocate(m_alloc, data, capacity);
             }
         }
-        void deallocate(T* data) noexcept {
-            ::operator delete (static_cast<void*>(data), static_cast<std::align_val_t>(alignof(T)));
-            data = nullptr;
+        // Frees a block for the growth steps in detail, see detail::reallocateElements
+        auto blockReleaser() noexcept {
+            return [this](T* data, size_type capacity) noexcept { deallocate(data, capacity); };
         }
 
         // ---------------------
         // Iterators
         // ---------------------
 
+        // A T* with the contiguous iterator interface, so standard algorithms, std::ranges and std::span treat the
+        // vector as contiguous memory. Kept a distinct type (rather than T* itself) so iterators of different containers
+        // don't mix.
         template <bool IsConst>
         class iterator_impl {
-            using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
-            using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
-            using owner_type = std::conditional_t<IsConst, const vector, vector>;
-
-            size_type m_index {};
-            owner_type* m_owner { nullptr };
-
         public:
+            using iterator_concept = std::contiguous_iterator_tag;
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<IsConst, const T*, T*>;
+            using reference = std::conditional_t<IsConst, const T&, T&>;
+
             iterator_impl() = default;
 
-            iterator_impl(size_type index, owner_type* ownerPtr) noexcept
-                : m_index{ index }
-                , m_owner{ ownerPtr }
-            {}
+            explicit iterator_impl(pointer ptr) noexcept : m_ptr { ptr } {}
 
             template <bool OtherConst>
             requires(IsConst && !OtherConst)
-            iterator_impl(const iterator_impl<OtherConst>& other) noexcept {
-                m_index = other.m_index;
-                m_owner = other.m_owner;
-            }
+            iterator_impl(const iterator_impl<OtherConst>& other) noexcept : m_ptr { other.m_ptr } {}
 
-            reference operator*() const {
-                assert(m_owner && "m_owner is a nullptr");
-                assert(m_index != m_owner->m_size && "Attempted to dereference an end iterator");
-                return *(m_owner->m_data + m_index);
+            reference operator*() const noexcept {
+                return *m_ptr;
             }
-
-            pointer operator->() const {
-                assert(m_owner && "m_owner is a nullptr");
-                assert(m_index != m_owner->m_size && "Attempted to dereference an end iterator");
-                return m_owner->m_data + m_index;
+            pointer operator->() const noexcept {
+                return m_ptr;
+            }
+            reference operator[](difference_type offset) const noexcept {
+                return m_ptr[offset];
             }
 
-            iterator_impl& operator++() {
-                ++m_index;
+            iterator_impl& operator++() noexcept {
+                ++m_ptr;
+                return *this;
+            }
+            iterator_impl operator++(int) noexcept {
+                iterator_impl previous { *this };
+                ++m_ptr;
+                return previous;
+            }
+            iterator_impl& operator--() noexcept {
+                --m_ptr;
                 return *this;
             }
+            iterator_impl operator--(int) noexcept {
+                iterator_impl previous { *this };
+                --m_ptr;
+                return previous;
+            }
 
-            iterator_impl operator++(int) {
-                ++m_index;
+            iterator_impl& operator+=(difference_type offset) noexcept {
+                m_ptr += offset;
                 return *this;
             }
+            iterator_impl& operator-=(difference_type offset) noexcept {
+                m_ptr -= offset;
+                return *this;
+            }
+            iterator_impl operator+(difference_type offset) const noexcept {
+                return iterator_impl { m_ptr + offset };
+            }
+            friend iterator_impl operator+(difference_type offset, const iterator_impl& it) noexcept {
+                return iterator_impl { it.m_ptr + offset };
+            }
+            iterator_impl operator-(difference_type offset) const noexcept {
+                return iterator_impl { m_ptr - offset };
+            }
+
+            template <bool OtherConst>
+            difference_type operator-(const iterator_impl<OtherConst>& other) const noexcept {
+                return m_ptr - other.m_ptr;
+            }
 
             template <bool OtherConst>
-            bool operator==(const iterator_impl<OtherConst>& other) const {
-                return (m_owner == other.m_owner && m_index == other.m_index);
+            bool operator==(const iterator_impl<OtherConst>& other) const noexcept {
+                return m_ptr == other.m_ptr;
             }
 
             template <bool OtherConst>
-            bool operator!=(const iterator_impl<OtherConst>& other) const {
-                return (m_owner != other.m_owner || m_index != other.m_index);
+            std::strong_ordering operator<=>(const iterator_impl<OtherConst>& other) const noexcept {
+                return std::compare_three_way {}(m_ptr, other.m_ptr);
             }
 
+        private:
+            pointer m_ptr { nullptr };
+
             friend class vector;
+            friend class iterator_impl<!IsConst>;
         };
 
     #ifndef NDEBUG
@@ -416,4 +935,9 @@ namespace systems_dsa {
         }
     #endif
     };
+
+    namespace pmr {
+        template <typename T, typename GrowthPolicy = one_and_half_growth_policy>
+        using vector = systems_dsa::vector<T, std::pmr::polymorphic_allocator<T>, GrowthPolicy>;
+    }
 }
\ No newline at end of file
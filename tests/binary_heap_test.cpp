@@ -1,3 +1,4 @@
+#include "utils/counting_resource.hpp"
 #include "utils/lifetime_tracker.hpp"
 #include "utils/seed.hpp"
 
@@ -5,6 +6,10 @@
 #include <systems_dsa/binary_heap.hpp>
 #include <queue>
 #include <functional>
+#include <memory_resource>
+#include <sstream>
+#include <algorithm>
+#include <iterator>
 
 class BinaryHeapTest_F : public testing::Test {
 protected:
@@ -24,8 +29,8 @@ protected:
     }
 };
 
-template <typename T, typename Compare>
-::testing::AssertionResult IsValidPopOrder(systems_dsa::binary_heap<T, Compare> heap) {
+template <typename T, typename Compare, typename Allocator, std::size_t Arity>
+::testing::AssertionResult IsValidPopOrder(systems_dsa::binary_heap<T, Compare, Allocator, Arity> heap) {
     Compare comp;
     std::vector<T> popped {};
 
@@ -126,6 +131,35 @@ TEST(BinaryHeapTest, PushedRValueMoveConstructsOnce) {
     LifetimeTracker::resetCounts();
 }
 
+TEST(BinaryHeapTest, SiftsMoveOncePerLevel) {
+    // 127 elements fill exactly 7 levels
+    systems_dsa::binary_heap<LifetimeTracker> heap { 256 };
+    for (int i {}; i < 127; ++i) {
+        heap.push(i);
+    }
+    const int levels { 7 };
+
+    // Each new maximum climbs the 7 levels to the root: moved out, 7 parents shifted down, moved back in
+    LifetimeTracker::resetCounts();
+    heap.push(1'000);
+    EXPECT_EQ(LifetimeTracker::moveCtorCount, 2);
+    EXPECT_EQ(LifetimeTracker::moveAssignCount, levels + 1);
+    EXPECT_EQ(LifetimeTracker::copyAssignCount, 0);
+
+    // A push that stays where it lands is never moved after being emplaced
+    LifetimeTracker::resetCounts();
+    heap.push(-1);
+    EXPECT_EQ(LifetimeTracker::moveCtorCount, 1);
+    EXPECT_EQ(LifetimeTracker::moveAssignCount, 0);
+
+    // Without swaps, a pop is one move per level walked down and up again plus moving the last element aside
+    LifetimeTracker::resetCounts();
+    heap.pop();
+    EXPECT_EQ(LifetimeTracker::moveCtorCount, 1);
+    EXPECT_LE(LifetimeTracker::moveAssignCount, 2 * levels + 1);
+    LifetimeTracker::resetCounts();
+}
+
 TEST(BinaryHeapTest, ReserveAllowsNElementsWithoutReallocation) {
     systems_dsa::binary_heap<LifetimeTracker> heap {};
     ASSERT_LT(heap.capacity(), 100);
@@ -141,6 +175,77 @@ TEST(BinaryHeapTest, ReserveAllowsNElementsWithoutReallocation) {
     ASSERT_GE(LifetimeTracker::moveCtorCount, 100);
 }
 
+TEST(BinaryHeapTest, PmrHeapAllocatesFromItsResource) {
+    CountingResource resource {};
+    {
+        systems_dsa::pmr::binary_heap<int> heap { &resource };
+        for (int i {}; i < 100; ++i) {
+            heap.push(i);
+        }
+        EXPECT_EQ(heap.get_allocator().resource(), &resource);
+        EXPECT_EQ(heap.top(), 99);
+        EXPECT_GT(resource.allocations, 0);
+    }
+    EXPECT_EQ(resource.bytesOutstanding, 0);
+}
+
+TEST(BinaryHeapTest, DaryHeapPartialLastFamily) {
+    // 3-ary with 7 elements: the root has 3 children, the first of them has 3, the second none
+    systems_dsa::binary_heap<int, std::greater<>, std::allocator<int>, 3> heap {};
+    for (int val : { 5, 3, 9, 1, 7, 2, 8 }) {
+        heap.push(val);
+    }
+    static_assert(decltype(heap)::arity == 3);
+    for (int expected : { 1, 2, 3, 5, 7, 8, 9 }) {
+        ASSERT_EQ(heap.top(), expected);
+        heap.pop();
+    }
+    EXPECT_TRUE(heap.empty());
+}
+
+TEST(BinaryHeapTest, RangeConstructorHeapifies) {
+    const std::vector<int> values { 4, 17, 3, 3, 99, -5, 0, 42, 8, 17, 23 };
+    systems_dsa::binary_heap<int> heap(values.begin(), values.end());
+    ASSERT_EQ(heap.size(), values.size());
+
+    std::vector<int> expected { values };
+    std::sort(expected.begin(), expected.end(), std::greater<>());
+    for (int value : expected) {
+        ASSERT_EQ(heap.top(), value);
+        heap.pop();
+    }
+
+    systems_dsa::binary_heap<int> emptyHeap(values.begin(), values.begin());
+    EXPECT_TRUE(emptyHeap.empty());
+}
+
+TEST(BinaryHeapTest, PushRangeTakesBothPaths) {
+    systems_dsa::binary_heap<int, std::less<int>, std::allocator<int>, 4> heap {};
+    std::priority_queue<int> reference {};
+    // Growing from empty rebuilds the heap, the 3-element batch afterwards is sifted up element by element
+    for (const std::vector<int>& batch : { std::vector<int> { 5, 1, 9, 7, 3, 8 }, std::vector<int> { 2, 10, 6 } }) {
+        heap.push_range(batch);
+        for (int value : batch) {
+            reference.push(value);
+        }
+        ASSERT_EQ(heap.size(), reference.size());
+        ASSERT_EQ(heap.top(), reference.top());
+    }
+
+    // Input ranges can only be walked once
+    std::istringstream stream { "11 4 0" };
+    heap.push_range(std::ranges::subrange(std::istream_iterator<int> { stream }, std::istream_iterator<int> {}));
+    for (int value : { 11, 4, 0 }) {
+        reference.push(value);
+    }
+    while (!reference.empty()) {
+        ASSERT_EQ(heap.top(), reference.top());
+        heap.pop();
+        reference.pop();
+    }
+    EXPECT_TRUE(heap.empty());
+}
+
 /////////////////////////
 // Adversarial testing //
 /////////////////////////
@@ -193,4 +298,36 @@ TEST(BinaryHeapTest, RandomSeqPushPop) {
         }
     }
     EXPECT_TRUE(IsValidPopOrder(heap));
-}
\ No newline at end of file
+}
+
+template <std::size_t Arity>
+static void randomPushPopAgainstReference(std::uint64_t seed) {
+    SCOPED_TRACE(Arity);
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<> valDist(1, 1000);
+    std::uniform_int_distribution<> opDist(0, 2);
+
+    std::priority_queue<int> reference;
+    systems_dsa::binary_heap<int, std::less<int>, std::allocator<int>, Arity> heap;
+    for (std::size_t i {}; i < 5'000; ++i) {
+        // Pushes outnumber pops two to one, so the heap grows several levels deep
+        if (opDist(rng) == 0 && !reference.empty()) {
+            ASSERT_EQ(heap.top(), reference.top());
+            heap.pop();
+            reference.pop();
+        } else {
+            const int val { valDist(rng) };
+            heap.push(val);
+            reference.push(val);
+        }
+        ASSERT_EQ(heap.size(), reference.size());
+    }
+    EXPECT_TRUE(IsValidPopOrder(heap));
+}
+
+TEST(BinaryHeapTest, RandomSeqDaryHeaps) {
+    std::uint64_t seed { getSeed("BHEAP_SEED") };
+    randomPushPopAgainstReference<2>(seed);
+    randomPushPopAgainstReference<4>(seed);
+    randomPushPopAgainstReference<8>(seed);
+}
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <atomic>
+#include <gtest/gtest.h>
+#include <memory>
+#include <systems_dsa/concurrent_priority_queue.hpp>
+#include <thread>
+#include <vector>
+
+// These tests are most useful under the tsan preset, which reports any unsynchronized access between the threads.
+
+///////////////////////////////
+// Basic functionality tests //
+///////////////////////////////
+
+TEST(ConcurrentPriorityQueueTest, QueueCountIsThreadsTimesQueuesPerThread) {
+    systems_dsa::concurrent_priority_queue<int> queue { 4, 3 };
+    EXPECT_EQ(queue.queue_count(), 12);
+    systems_dsa::concurrent_priority_queue<int> singleThread { 1, 1 };
+    EXPECT_EQ(singleThread.queue_count(), 2) << "Picking the best of two needs at least two queues";
+}
+
+TEST(ConcurrentPriorityQueueTest, ConstructorWithZeroQueuesThrows) {
+    using concurrent_priority_queue = systems_dsa::concurrent_priority_queue<int>;
+    EXPECT_THROW(concurrent_priority_queue queue(4, 0), std::invalid_argument);
+}
+
+TEST(ConcurrentPriorityQueueTest, PopsEveryElementOnce) {
+    systems_dsa::concurrent_priority_queue<int> queue { 2 };
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.try_pop(), std::nullopt);
+    for (int i {}; i < 1'000; ++i) {
+        queue.push(i);
+    }
+    EXPECT_EQ(queue.size(), 1'000);
+
+    std::vector<int> popped {};
+    while (auto value { queue.try_pop() }) {
+        popped.push_back(*value);
+    }
+    EXPECT_TRUE(queue.empty());
+    std::sort(popped.begin(), popped.end());
+    ASSERT_EQ(popped.size(), 1'000);
+    for (int i {}; i < 1'000; ++i) {
+        ASSERT_EQ(popped[i], i);
+    }
+}
+
+TEST(ConcurrentPriorityQueueTest, PopsComeFromNearTheTop) {
+    // 4 queues of ~2500 random elements each: the better of two queue tops is always near the global top
+    systems_dsa::concurrent_priority_queue<int> queue { 2, 2 };
+    for (int i {}; i < 10'000; ++i) {
+        queue.push(i);
+    }
+    for (int i {}; i < 100; ++i) {
+        const auto value { queue.try_pop() };
+        ASSERT_TRUE(value.has_value());
+        EXPECT_GT(*value, 9'000);
+    }
+}
+
+TEST(ConcurrentPriorityQueueTest, HoldsMoveOnlyElements) {
+    struct PointeeLess {
+        bool operator()(const std::unique_ptr<int>& lhs, const std::unique_ptr<int>& rhs) const {
+            return *lhs < *rhs;
+        }
+    };
+    systems_dsa::concurrent_priority_queue<std::unique_ptr<int>, PointeeLess> queue { 1 };
+    queue.push(std::make_unique<int>(7));
+    queue.emplace(new int { 9 });
+    int sum {};
+    while (auto value { queue.try_pop() }) {
+        sum += **value;
+    }
+    EXPECT_EQ(sum, 16);
+}
+
+/////////////////////////////
+// Multi-threaded tests    //
+/////////////////////////////
+
+TEST(ConcurrentPriorityQueueTest, ConcurrentProducersAndConsumers) {
+    constexpr int producerCount { 4 };
+    constexpr int consumerCount { 4 };
+    constexpr int perProducer { 2'000 };
+    constexpr int total { producerCount * perProducer };
+    systems_dsa::concurrent_priority_queue<int> queue { producerCount + consumerCount };
+
+    std::atomic<int> consumed {};
+    std::vector<std::vector<int>> poppedBy(consumerCount);
+    std::vector<std::thread> threads {};
+    for (int p {}; p < producerCount; ++p) {
+        threads.emplace_back([&queue, p] {
+            for (int i {}; i < perProducer; ++i) {
+                queue.push(p * perProducer + i);
+            }
+        });
+    }
+    for (int c {}; c < consumerCount; ++c) {
+        threads.emplace_back([&, c] {
+            while (consumed.load() < total) {
+                if (auto value { queue.try_pop() }) {
+                    poppedBy[c].push_back(*value);
+                    consumed.fetch_add(1);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<int> popped {};
+    for (const auto& values : poppedBy) {
+        popped.insert(popped.end(), values.begin(), values.end());
+    }
+    std::sort(popped.begin(), popped.end());
+    ASSERT_EQ(popped.size(), total);
+    for (int i {}; i < total; ++i) {
+        ASSERT_EQ(popped[i], i) << "Every pushed element must be popped exactly once";
+    }
+    EXPECT_TRUE(queue.empty());
+}
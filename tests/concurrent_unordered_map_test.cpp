@@ -0,0 +1,197 @@
+#include "utils/seed.hpp"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <systems_dsa/concurrent_unordered_map.hpp>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// These tests are most useful under the tsan preset, which reports any unsynchronized access between the threads.
+
+///////////////////////////////
+// Basic functionality tests //
+///////////////////////////////
+
+TEST(ConcurrentHashMapTest, ShardCountRoundsToPowerOfTwo) {
+    systems_dsa::concurrent_unordered_map<int, int> hashMap { 5 };
+    EXPECT_EQ(hashMap.shard_count(), 8);
+}
+
+TEST(ConcurrentHashMapTest, ConstructorWithZeroThrows) {
+    using concurrent_unordered_map = systems_dsa::concurrent_unordered_map<int, int>;
+    EXPECT_ANY_THROW(concurrent_unordered_map hashMap { 0 });
+}
+
+TEST(ConcurrentHashMapTest, InsertFindErase) {
+    systems_dsa::concurrent_unordered_map<std::string, int> hashMap {};
+    EXPECT_TRUE(hashMap.empty());
+    EXPECT_TRUE(hashMap.insert("one", 1));
+    EXPECT_TRUE(hashMap.insert("two", 2));
+    EXPECT_FALSE(hashMap.insert("one", 100)) << "Duplicate insert should no-op";
+
+    EXPECT_EQ(hashMap.size(), 2);
+    EXPECT_EQ(hashMap.find("one"), 1);
+    EXPECT_EQ(hashMap.find("three"), std::nullopt);
+    EXPECT_TRUE(hashMap.contains("two"));
+
+    EXPECT_EQ(hashMap.erase("one"), 1);
+    EXPECT_EQ(hashMap.erase("one"), 0);
+    EXPECT_FALSE(hashMap.contains("one"));
+
+    hashMap.clear();
+    EXPECT_TRUE(hashMap.empty());
+}
+
+TEST(ConcurrentHashMapTest, VisitModifiesInPlace) {
+    systems_dsa::concurrent_unordered_map<int, std::vector<int>> hashMap {};
+    hashMap.insert(1, {});
+    EXPECT_TRUE(hashMap.visit(1, [](std::vector<int>& vec) { vec.push_back(42); }));
+    EXPECT_FALSE(hashMap.visit(2, [](std::vector<int>&) { FAIL() << "visit called fn for a missing key"; }));
+
+    const auto& constMap { hashMap };
+    std::size_t visitedSize {};
+    EXPECT_TRUE(constMap.visit(1, [&](const std::vector<int>& vec) { visitedSize = vec.size(); }));
+    EXPECT_EQ(visitedSize, 1);
+}
+
+namespace {
+    struct CountingHash {
+        inline static std::size_t calls {};
+        std::size_t operator()(const std::string& key) const noexcept {
+            ++calls;
+            return std::hash<std::string> {}(key);
+        }
+    };
+}
+
+TEST(ConcurrentHashMapTest, HashesEachKeyOncePerOperation) {
+    // Few enough keys that no shard rehashes
+    systems_dsa::concurrent_unordered_map<std::string, int, CountingHash> hashMap { 4 };
+    CountingHash::calls = 0;
+    hashMap.insert("one", 1);
+    hashMap.insert(std::string { "two" }, 2);
+    hashMap.erase("three");
+#ifdef NDEBUG
+    // Debug builds also hash every element when they validate the shard after a modification
+    EXPECT_EQ(CountingHash::calls, 3);
+#endif
+
+    CountingHash::calls = 0;
+    EXPECT_EQ(hashMap.find("one"), 1);
+    EXPECT_FALSE(hashMap.contains("three"));
+    EXPECT_TRUE(hashMap.visit("two", [](int& value) { ++value; }));
+    EXPECT_TRUE(std::as_const(hashMap).visit("two", [](const int& value) { EXPECT_EQ(value, 3); }));
+    EXPECT_EQ(CountingHash::calls, 4);
+}
+
+TEST(ConcurrentHashMapTest, SingleShardBehavesLikeMap) {
+    systems_dsa::concurrent_unordered_map<int, int> hashMap { 1 };
+    for (int i {}; i < 100; ++i) {
+        hashMap.insert(i, i * 2);
+    }
+    for (int i {}; i < 100; ++i) {
+        EXPECT_EQ(hashMap.find(i), i * 2);
+    }
+}
+
+//////////////////////////
+// Multi-threaded tests //
+//////////////////////////
+
+TEST(ConcurrentHashMapTest, ConcurrentDisjointInserts) {
+    constexpr int threadCount { 8 };
+    constexpr int perThread { 500 };
+    systems_dsa::concurrent_unordered_map<int, int> hashMap { 16 };
+
+    std::vector<std::thread> threads {};
+    for (int t {}; t < threadCount; ++t) {
+        threads.emplace_back([&hashMap, t] {
+            for (int i {}; i < perThread; ++i) {
+                const int key { t * perThread + i };
+                hashMap.insert(key, key + 1);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(hashMap.size(), threadCount * perThread);
+    for (int key {}; key < threadCount * perThread; ++key) {
+        EXPECT_EQ(hashMap.find(key), key + 1);
+    }
+}
+
+TEST(ConcurrentHashMapTest, ConcurrentVisitIncrementsAreNotLost) {
+    constexpr int threadCount { 8 };
+    constexpr int increments { 1000 };
+    constexpr int keyCount { 4 };
+    systems_dsa::concurrent_unordered_map<int, int> hashMap { 4 };
+    for (int key {}; key < keyCount; ++key) {
+        hashMap.insert(key, 0);
+    }
+
+    std::vector<std::thread> threads {};
+    for (int t {}; t < threadCount; ++t) {
+        threads.emplace_back([&hashMap] {
+            for (int i {}; i < increments; ++i) {
+                hashMap.visit(i % keyCount, [](int& value) { ++value; });
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (int key {}; key < keyCount; ++key) {
+        EXPECT_EQ(hashMap.find(key), threadCount * increments / keyCount);
+    }
+}
+
+TEST(ConcurrentHashMapTest, ConcurrentMixedReadersAndWriters) {
+    constexpr int threadCount { 6 };
+    constexpr int opsPerThread { 2000 };
+    constexpr int keyRange { 256 };
+    systems_dsa::concurrent_unordered_map<int, int> hashMap { 8 };
+    const std::uint64_t seed { getSeed("CONCURRENT_HASHMAP_SEED") };
+    std::atomic<int> badReads {};
+
+    std::vector<std::thread> threads {};
+    for (int t {}; t < threadCount; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937_64 rng(seed + static_cast<std::uint64_t>(t));
+            std::uniform_int_distribution<int> distKey(0, keyRange - 1);
+            std::uniform_int_distribution<int> distOp(0, 3);
+            for (int i {}; i < opsPerThread; ++i) {
+                const int key { distKey(rng) };
+                switch (distOp(rng)) {
+                case 0:
+                    hashMap.insert(key, key * 3);
+                    break;
+                case 1:
+                    hashMap.erase(key);
+                    break;
+                default:
+                    // Values are only ever key * 3, so any other value is a torn or stale read
+                    if (const auto value { hashMap.find(key) }; value && *value != key * 3) {
+                        ++badReads;
+                    }
+                    break;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(badReads.load(), 0);
+    std::size_t present {};
+    for (int key {}; key < keyRange; ++key) {
+        present += hashMap.contains(key);
+    }
+    EXPECT_EQ(present, hashMap.size());
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <functional>
+#include <systems_dsa/binary_heap.hpp>
+#include <systems_dsa/huge_page_allocator.hpp>
+#include <systems_dsa/unordered_map.hpp>
+#include <systems_dsa/vector.hpp>
+#include <utility>
+
+namespace {
+    template <typename T>
+    using HugeVector = systems_dsa::vector<T, systems_dsa::huge_page_allocator<T>>;
+
+    constexpr std::size_t kHugePage { systems_dsa::huge_page_options::huge_page_size };
+
+    bool isHugePageAligned(const void* ptr) {
+        return reinterpret_cast<std::uintptr_t>(ptr) % kHugePage == 0;
+    }
+}
+
+///////////////////////////////
+// Basic functionality tests //
+///////////////////////////////
+
+TEST(HugePageAllocatorTest, SmallBlocksComeFromOperatorNew) {
+    HugeVector<int> myVec {};
+    for (int i {}; i < 100; ++i) {
+        myVec.push_back(i);
+    }
+    EXPECT_EQ(myVec[99], 99);
+    EXPECT_LT(myVec.capacity() * sizeof(int), systems_dsa::huge_page_options {}.threshold_bytes);
+}
+
+TEST(HugePageAllocatorTest, LargeBlocksAreHugePageAligned) {
+#if !defined(__linux__)
+    GTEST_SKIP() << "Huge page mappings are Linux only";
+#endif
+    HugeVector<std::uint64_t> myVec {};
+    myVec.reserve(kHugePage); // 16MB
+    EXPECT_TRUE(isHugePageAligned(myVec.data()));
+
+    // Growing across the threshold moves the elements into a mapping
+    HugeVector<int> growing {};
+    for (int i {}; i < 1'000'000; ++i) {
+        growing.push_back(i);
+    }
+    EXPECT_TRUE(isHugePageAligned(growing.data()));
+    for (int i {}; i < 1'000'000; i += 999) {
+        ASSERT_EQ(growing[i], i);
+    }
+    growing.resize(10);
+    growing.shrink_to_fit();
+    EXPECT_FALSE(isHugePageAligned(growing.data()) && growing.capacity() * sizeof(int) >= kHugePage);
+    EXPECT_EQ(growing[9], 9);
+}
+
+TEST(HugePageAllocatorTest, MapAndHeapUseIt) {
+    // A low threshold sends even these small bucket arrays through the mmap path
+    const systems_dsa::huge_page_options options { .threshold_bytes = 4096 };
+    using Allocator = systems_dsa::huge_page_allocator<std::pair<const int, int>>;
+    systems_dsa::unordered_map<int, int, std::hash<int>, std::equal_to<int>, systems_dsa::modulo_bucket_policy,
+        systems_dsa::linear_probe_policy, systems_dsa::auto_hash_cache_policy, Allocator> hashMap { Allocator { options } };
+    for (int i {}; i < 2'000; ++i) {
+        hashMap.insert(i, i * 2);
+    }
+    EXPECT_EQ(hashMap.get_allocator().options(), options);
+    for (int i {}; i < 2'000; ++i) {
+        ASSERT_EQ(hashMap.at(i), i * 2);
+    }
+
+    systems_dsa::binary_heap<int, std::less<int>, systems_dsa::huge_page_allocator<int>> heap {
+        systems_dsa::huge_page_allocator<int> { options } };
+    for (int i {}; i < 5'000; ++i) {
+        heap.push(i);
+    }
+    EXPECT_EQ(heap.top(), 4'999);
+    EXPECT_EQ(heap.get_allocator().options(), options);
+}
+
+TEST(HugePageAllocatorTest, NumaPolicyOnNodeZero) {
+    // Node 0 exists on every machine, NUMA or not
+    const systems_dsa::huge_page_options options {
+        .numa = systems_dsa::numa_policy::interleave,
+        .numa_nodes = 1,
+    };
+    HugeVector<int> myVec { systems_dsa::huge_page_allocator<int> { options } };
+    myVec.resize(1 << 21);
+    myVec[(1 << 21) - 1] = 7;
+    EXPECT_EQ(myVec[(1 << 21) - 1], 7);
+}
+
+TEST(HugePageAllocatorTest, NumaPolicyWithoutNodesThrows) {
+    const systems_dsa::huge_page_options options { .numa = systems_dsa::numa_policy::bind };
+    EXPECT_THROW(systems_dsa::huge_page_allocator<int> { options }, std::invalid_argument);
+}
+
+TEST(HugePageAllocatorTest, EqualityFollowsOptions) {
+    const systems_dsa::huge_page_allocator<int> defaults {};
+    const systems_dsa::huge_page_allocator<double> rebound { defaults };
+    const systems_dsa::huge_page_allocator<int> lowThreshold { systems_dsa::huge_page_options { .threshold_bytes = 1 } };
+    EXPECT_TRUE(defaults == rebound);
+    EXPECT_FALSE(defaults == lowThreshold);
+
+    // Move assignment propagates the allocator, so the storage is adopted rather than copied element by element
+    HugeVector<int> source { lowThreshold };
+    source.push_back(1);
+    const int* data { source.data() };
+    HugeVector<int> target {};
+    target = std::move(source);
+    EXPECT_EQ(target.data(), data);
+    EXPECT_EQ(target.get_allocator(), lowThreshold);
+}
@@ -0,0 +1,222 @@
+#include "utils/lifetime_tracker.hpp"
+#include "utils/seed.hpp"
+
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <systems_dsa/incremental_unordered_map.hpp>
+#include <unordered_map>
+
+///////////////////////////////
+// Basic functionality tests //
+///////////////////////////////
+
+TEST(IncrementalHashMapTest, IsEmptyInitially) {
+    systems_dsa::incremental_unordered_map<std::string, int> hashMap {};
+    EXPECT_TRUE(hashMap.empty());
+    EXPECT_FALSE(hashMap.is_migrating());
+}
+
+TEST(IncrementalHashMapTest, GrowthStartsMigrationInsteadOfRehashing) {
+    systems_dsa::incremental_unordered_map<int, int> hashMap { 10 };
+    for (int i {}; i < 7; ++i) {
+        hashMap.insert(i, i + 10);
+    }
+    EXPECT_TRUE(hashMap.is_migrating()) << "Reaching the max load factor should start a migration";
+    EXPECT_EQ(hashMap.bucket_count(), 20);
+    EXPECT_EQ(hashMap.size(), 7);
+    for (int i {}; i < 7; ++i) {
+        EXPECT_TRUE(hashMap.contains(i)) << "key=" << i;
+        EXPECT_EQ(*hashMap.find(i), i + 10);
+    }
+}
+
+TEST(IncrementalHashMapTest, MigrationCompletesAndLosesNoElements) {
+    systems_dsa::incremental_unordered_map<int, int> hashMap {};
+    for (int i {}; i < 1000; ++i) {
+        hashMap.insert(i, i * 2);
+        EXPECT_EQ(hashMap.size(), static_cast<std::size_t>(i + 1));
+    }
+    // Lookups through the non-const find drive the migration forward
+    while (hashMap.is_migrating()) {
+        hashMap.find(0);
+    }
+    for (int i {}; i < 1000; ++i) {
+        ASSERT_NE(hashMap.find(i), nullptr) << "key=" << i;
+        EXPECT_EQ(*hashMap.find(i), i * 2);
+    }
+}
+
+TEST(IncrementalHashMapTest, DuplicateInsertDuringMigrationNoOps) {
+    systems_dsa::incremental_unordered_map<int, int> hashMap { 100 };
+    for (int i {}; i < 70; ++i) {
+        hashMap.insert(i, i);
+    }
+    ASSERT_TRUE(hashMap.is_migrating());
+    for (int i {}; i < 70; ++i) {
+        EXPECT_FALSE(hashMap.insert(i, -1)) << "key=" << i;
+        EXPECT_EQ(hashMap.at(i), i);
+    }
+    EXPECT_EQ(hashMap.size(), 70);
+}
+
+TEST(IncrementalHashMapTest, EraseDuringMigrationFindsEitherTable) {
+    systems_dsa::incremental_unordered_map<int, int> hashMap { 100 };
+    for (int i {}; i < 70; ++i) {
+        hashMap.insert(i, i);
+    }
+    ASSERT_TRUE(hashMap.is_migrating());
+    for (int i {}; i < 70; i += 2) {
+        EXPECT_EQ(hashMap.erase(i), 1) << "key=" << i;
+    }
+    EXPECT_EQ(hashMap.erase(1000), 0);
+    EXPECT_EQ(hashMap.size(), 35);
+    for (int i {}; i < 70; ++i) {
+        EXPECT_EQ(hashMap.contains(i), i % 2 == 1) << "key=" << i;
+    }
+}
+
+TEST(IncrementalHashMapTest, ForEachVisitsBothTables) {
+    systems_dsa::incremental_unordered_map<int, int> hashMap { 100 };
+    for (int i {}; i < 70; ++i) {
+        hashMap.insert(i, 1);
+    }
+    ASSERT_TRUE(hashMap.is_migrating());
+    int sum {};
+    hashMap.for_each([&](const int&, int& value) { sum += value; });
+    EXPECT_EQ(sum, 70);
+}
+
+TEST(IncrementalHashMapTest, ClearAndDestructionDestroyElementsInBothTables) {
+    LifetimeTracker::resetCounts();
+    {
+        systems_dsa::incremental_unordered_map<int, LifetimeTracker> hashMap { 100 };
+        for (int i {}; i < 70; ++i) {
+            hashMap.insert(i, LifetimeTracker { i });
+        }
+        ASSERT_TRUE(hashMap.is_migrating());
+        hashMap.clear();
+        EXPECT_EQ(LifetimeTracker::liveCount, 0);
+        EXPECT_TRUE(hashMap.empty());
+
+        // clear keeps the bucket count, so keep inserting until the next migration starts
+        for (int i {}; !hashMap.is_migrating(); ++i) {
+            hashMap.insert(i, LifetimeTracker { i });
+        }
+    }
+    EXPECT_EQ(LifetimeTracker::liveCount, 0);
+    LifetimeTracker::resetCounts();
+}
+
+TEST(IncrementalHashMapTest, OperatorBracketsInsertsDefault) {
+    systems_dsa::incremental_unordered_map<int, int> hashMap {};
+    hashMap[5] += 3;
+    hashMap[5] += 4;
+    EXPECT_EQ(hashMap.at(5), 7);
+    EXPECT_ANY_THROW(hashMap.at(6));
+}
+
+TEST(IncrementalHashMapTest, OperatorBracketsDuringMigrationKeepsValues) {
+    systems_dsa::incremental_unordered_map<int, int> hashMap { 10 };
+    for (int i {}; i < 7; ++i) {
+        hashMap.insert(i, i + 10);
+    }
+    ASSERT_TRUE(hashMap.is_migrating());
+
+    // Keys still draining are migrated with their value, new keys land in the active table
+    for (int i {}; i < 7; ++i) {
+        hashMap[i] += 1;
+    }
+    hashMap[100] = 5;
+    EXPECT_EQ(hashMap.size(), 8);
+    for (int i {}; i < 7; ++i) {
+        EXPECT_EQ(hashMap.at(i), i + 11) << "key=" << i;
+    }
+    EXPECT_EQ(hashMap.at(100), 5);
+
+    while (hashMap.is_migrating()) {
+        hashMap[100] += 1;
+    }
+    EXPECT_EQ(hashMap.size(), 8);
+    EXPECT_EQ(hashMap.at(3), 14);
+}
+
+TEST(IncrementalHashMapTest, EraseChurnOnlyChangesBucketCountWhenAMigrationBegins) {
+    constexpr std::size_t initialBuckets { 1024 };
+    constexpr int liveCount { 64 };
+    systems_dsa::incremental_unordered_map<int, int> hashMap { initialBuckets };
+
+    std::size_t buckets { hashMap.bucket_count() };
+    bool migrating { hashMap.is_migrating() };
+    std::size_t migrations {};
+    const auto expectNoSynchronousRehash = [&](int i) {
+        const bool began { !migrating && hashMap.is_migrating() };
+        if (hashMap.bucket_count() != buckets) {
+            EXPECT_TRUE(began) << "The active table rehashed outside of a migration at i=" << i;
+        }
+        migrations += began ? 1 : 0;
+        buckets = hashMap.bucket_count();
+        migrating = hashMap.is_migrating();
+    };
+
+    // The live size stays constant, so nearly all of the load that triggers a migration is tombstones
+    for (int i {}; i < 20'000; ++i) {
+        hashMap.insert(i, i);
+        expectNoSynchronousRehash(i);
+        if (i >= liveCount) {
+            EXPECT_EQ(hashMap.erase(i - liveCount), 1);
+            expectNoSynchronousRehash(i);
+        }
+    }
+    EXPECT_GT(migrations, 1) << "Tombstones should have started migrations";
+    EXPECT_EQ(hashMap.bucket_count(), initialBuckets) << "Purging tombstones should not grow the table";
+    EXPECT_EQ(hashMap.size(), static_cast<std::size_t>(liveCount));
+    for (int i { 20'000 - liveCount }; i < 20'000; ++i) {
+        EXPECT_TRUE(hashMap.contains(i)) << "key=" << i;
+    }
+}
+
+/////////////////////////
+// Adversarial testing //
+/////////////////////////
+
+TEST(IncrementalHashMapTest, RandomSeqInsertEraseFindAgainstStd) {
+    enum class OP: std::uint8_t {
+        INSERT,
+        ERASE,
+        FIND,
+    };
+
+    std::uint64_t seed { getSeed("HASHMAP_SEED") };
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> distKeyVal(1, 2000);
+    std::uniform_int_distribution<int> distOp(0, 2);
+
+    systems_dsa::incremental_unordered_map<int, int> hashMap {};
+    std::unordered_map<int, int> reference {};
+
+    for (std::size_t i {}; i < 10'000; ++i) {
+        const int op { distOp(rng) };
+        const int key { distKeyVal(rng) };
+        const int val { distKeyVal(rng) };
+        switch (static_cast<OP>(op)) {
+        case OP::INSERT:
+            EXPECT_EQ(hashMap.insert(key, val), reference.insert({ key, val }).second);
+            break;
+        case OP::ERASE:
+            EXPECT_EQ(hashMap.erase(key), reference.erase(key));
+            break;
+        case OP::FIND:
+            const auto* value { hashMap.find(key) };
+            const auto refIt { reference.find(key) };
+
+            if ((value == nullptr) != (refIt == reference.end())) {
+                FAIL();
+            } else if (value != nullptr) {
+                EXPECT_EQ(*value, refIt->second);
+            }
+            EXPECT_EQ(hashMap.size(), reference.size());
+            break;
+        }
+    }
+}
@@ -0,0 +1,196 @@
+#include "utils/counting_resource.hpp"
+#include "utils/lifetime_tracker.hpp"
+#include "utils/seed.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <functional>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <systems_dsa/indexed_binary_heap.hpp>
+#include <vector>
+
+///////////////////////////////
+// Basic functionality tests //
+///////////////////////////////
+
+TEST(IndexedBinaryHeapTest, HandlesFollowTheirElements) {
+    systems_dsa::indexed_binary_heap<int> heap {};
+    std::vector<systems_dsa::indexed_binary_heap<int>::handle> handles {};
+    for (int val : { 10, 2, 55, 33, 12, 1000, 33, 12, 66, 79 }) {
+        handles.push_back(heap.push(val));
+    }
+    EXPECT_EQ(heap.size(), 10);
+    EXPECT_EQ(heap.top(), 1000);
+    EXPECT_EQ(heap.top_handle(), handles[5]);
+
+    const std::vector<int> expected { 10, 2, 55, 33, 12, 1000, 33, 12, 66, 79 };
+    for (std::size_t i {}; i < handles.size(); ++i) {
+        ASSERT_TRUE(heap.contains(handles[i]));
+        EXPECT_EQ(heap.at(handles[i]), expected[i]);
+    }
+}
+
+TEST(IndexedBinaryHeapTest, UpdateMovesBothWays) {
+    systems_dsa::indexed_binary_heap<int, std::greater<int>> heap {};
+    const auto a { heap.push(50) };
+    const auto b { heap.push(40) };
+    const auto c { heap.push(30) };
+    heap.push(20);
+    EXPECT_EQ(heap.top(), 20);
+
+    // Decrease-key on a min-heap moves the element up
+    heap.update(a, 5);
+    EXPECT_EQ(heap.top(), 5);
+    EXPECT_EQ(heap.top_handle(), a);
+
+    // and raising it moves it back down
+    heap.update(a, 100);
+    EXPECT_EQ(heap.top(), 20);
+    heap.update(c, 1);
+    heap.update(b, 2);
+    for (int expected : { 1, 2, 20, 100 }) {
+        ASSERT_EQ(heap.top(), expected);
+        heap.pop();
+    }
+    EXPECT_TRUE(heap.empty());
+}
+
+TEST(IndexedBinaryHeapTest, EraseRemovesAnyElement) {
+    systems_dsa::indexed_binary_heap<int> heap {};
+    std::vector<systems_dsa::indexed_binary_heap<int>::handle> handles {};
+    for (int val {}; val < 20; ++val) {
+        handles.push_back(heap.push(val));
+    }
+    // The top, a leaf, the last element and one in the middle
+    for (int erased : { 19, 0, 7, 12 }) {
+        heap.erase(handles[erased]);
+        EXPECT_FALSE(heap.contains(handles[erased]));
+    }
+    EXPECT_EQ(heap.size(), 16);
+    for (int expected : { 18, 17, 16, 15, 14, 13, 11, 10, 9, 8, 6, 5, 4, 3, 2, 1 }) {
+        ASSERT_EQ(heap.top(), expected);
+        heap.pop();
+    }
+}
+
+TEST(IndexedBinaryHeapTest, StaleHandlesNeverAliasReusedSlots) {
+    systems_dsa::indexed_binary_heap<std::string> heap {};
+    const auto first { heap.push("first") };
+    heap.pop();
+    EXPECT_FALSE(heap.contains(first));
+    EXPECT_THROW(heap.at(first), std::out_of_range);
+
+    // Reuses the slot of "first", under a new generation
+    const auto second { heap.push("second") };
+    EXPECT_FALSE(heap.contains(first));
+    EXPECT_NE(first, second);
+    EXPECT_EQ(heap.at(second), "second");
+
+    heap.clear();
+    EXPECT_TRUE(heap.empty());
+    EXPECT_FALSE(heap.contains(second));
+    EXPECT_FALSE(heap.contains(systems_dsa::indexed_binary_heap<std::string>::handle {}));
+}
+
+TEST(IndexedBinaryHeapTest, PmrHeapAllocatesFromItsResource) {
+    CountingResource resource {};
+    {
+        systems_dsa::pmr::indexed_binary_heap<int> heap { &resource };
+        for (int i {}; i < 100; ++i) {
+            heap.push(i);
+        }
+        EXPECT_GT(resource.allocations, 0);
+        EXPECT_EQ(heap.get_allocator().resource(), &resource);
+    }
+    EXPECT_EQ(resource.bytesOutstanding, 0);
+}
+
+///////////////////////
+// Lifetime Tracking //
+///////////////////////
+
+TEST(IndexedBinaryHeapTest, DestroysEveryElement) {
+    LifetimeTracker::resetCounts();
+    {
+        systems_dsa::indexed_binary_heap<LifetimeTracker> heap {};
+        std::vector<systems_dsa::indexed_binary_heap<LifetimeTracker>::handle> handles {};
+        for (int i {}; i < 50; ++i) {
+            handles.push_back(heap.push(LifetimeTracker { i }));
+        }
+        heap.erase(handles[10]);
+        heap.update(handles[20], LifetimeTracker { 500 });
+        heap.pop();
+        EXPECT_EQ(LifetimeTracker::liveCount, 48);
+    }
+    EXPECT_EQ(LifetimeTracker::liveCount, 0);
+}
+
+///////////////////////
+// Adversarial Tests //
+///////////////////////
+
+TEST(IndexedBinaryHeapTest, RandomSeqAgainstReference) {
+    const std::uint64_t seed { getSeed("IHEAP_SEED") };
+    SCOPED_TRACE(seed);
+    std::mt19937_64 rng { seed };
+    std::uniform_int_distribution<int> opDist { 0, 4 };
+    std::uniform_int_distribution<int> valDist { 0, 500 };
+
+    using Heap = systems_dsa::indexed_binary_heap<int, std::less<int>, std::allocator<int>, 4>;
+    Heap heap {};
+    // Reference: the live handles and their values
+    std::vector<std::pair<Heap::handle, int>> live {};
+    std::vector<Heap::handle> dead {};
+
+    const auto pickLive { [&]() -> std::size_t {
+        return std::uniform_int_distribution<std::size_t> { 0, live.size() - 1 }(rng);
+    } };
+
+    for (int step {}; step < 3'000; ++step) {
+        const int op { live.empty() ? 0 : opDist(rng) };
+        switch (op) {
+            case 0:
+            case 1: {
+                const int val { valDist(rng) };
+                live.emplace_back(heap.push(val), val);
+                break;
+            }
+            case 2: {
+                const std::size_t i { pickLive() };
+                const int val { valDist(rng) };
+                heap.update(live[i].first, val);
+                live[i].second = val;
+                break;
+            }
+            case 3: {
+                const std::size_t i { pickLive() };
+                heap.erase(live[i].first);
+                dead.push_back(live[i].first);
+                live.erase(live.begin() + static_cast<std::ptrdiff_t>(i));
+                break;
+            }
+            case 4: {
+                int maxValue { live.front().second };
+                for (const auto& [h, val] : live) {
+                    maxValue = std::max(maxValue, val);
+                }
+                ASSERT_EQ(heap.top(), maxValue) << "step=" << step;
+                const auto topHandle { heap.top_handle() };
+                heap.pop();
+                std::erase_if(live, [&](const auto& entry) { return entry.first == topHandle; });
+                dead.push_back(topHandle);
+                break;
+            }
+        }
+        ASSERT_EQ(heap.size(), live.size()) << "step=" << step;
+    }
+    for (const auto& [h, val] : live) {
+        ASSERT_TRUE(heap.contains(h));
+        ASSERT_EQ(heap.at(h), val);
+    }
+    for (const auto& h : dead) {
+        ASSERT_FALSE(heap.contains(h));
+    }
+}
@@ -0,0 +1,212 @@
+#include "utils/counting_resource.hpp"
+#include "utils/lifetime_tracker.hpp"
+#include "utils/seed.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <queue>
+#include <random>
+#include <string>
+#include <systems_dsa/radix_heap.hpp>
+#include <utility>
+#include <vector>
+
+///////////////////////////////
+// Basic functionality tests //
+///////////////////////////////
+
+TEST(RadixHeapTest, PopsInKeyOrder) {
+    systems_dsa::radix_heap<std::uint32_t, std::string> heap {};
+    EXPECT_TRUE(heap.empty());
+    for (std::uint32_t key : { 10u, 2u, 55u, 33u, 12u, 1000u, 33u, 0u, 66u, 79u }) {
+        heap.push({ key, std::to_string(key) });
+    }
+    EXPECT_EQ(heap.size(), 10);
+
+    for (std::uint32_t expected : { 0u, 2u, 10u, 12u, 33u, 33u, 55u, 66u, 79u, 1000u }) {
+        ASSERT_EQ(heap.top().first, expected);
+        EXPECT_EQ(heap.top().second, std::to_string(expected));
+        heap.pop();
+    }
+    EXPECT_TRUE(heap.empty());
+}
+
+TEST(RadixHeapTest, AcceptsKeysDownToTheLastTop) {
+    systems_dsa::radix_heap<std::uint64_t, int> heap {};
+    heap.push({ 100, 1 });
+    heap.push({ 50, 2 });
+    EXPECT_EQ(heap.top().first, 50);
+    heap.pop();
+    // Keys between the last top and the current minimum, and equal to the last top, are both allowed
+    heap.push({ 50, 3 });
+    heap.push({ 70, 4 });
+    for (std::uint64_t expected : { 50u, 70u, 100u }) {
+        ASSERT_EQ(heap.top().first, expected);
+        heap.pop();
+    }
+
+    // clear() lifts the bound
+    heap.push({ 200, 5 });
+    heap.top();
+    heap.clear();
+    heap.push({ 1, 6 });
+    EXPECT_EQ(heap.top().first, 1);
+}
+
+TEST(RadixHeapTest, FloatingPointKeysKeepTheirOrder) {
+    systems_dsa::radix_heap<double, int> heap {};
+    const std::vector<double> keys { 3.5, -0.25, 1e300, -1e300, 0.0, 1e-300, -2.0, 2.0 };
+    for (std::size_t i {}; i < keys.size(); ++i) {
+        heap.push({ keys[i], static_cast<int>(i) });
+    }
+    std::vector<double> sorted { keys };
+    std::sort(sorted.begin(), sorted.end());
+    for (double expected : sorted) {
+        ASSERT_EQ(heap.top().first, expected);
+        EXPECT_EQ(keys[static_cast<std::size_t>(heap.top().second)], expected);
+        heap.pop();
+    }
+
+    systems_dsa::radix_heap<float, int> floatHeap {};
+    for (float key : { 2.5f, -1.0f, 0.5f }) {
+        floatHeap.push({ key, 0 });
+    }
+    EXPECT_EQ(floatHeap.top().first, -1.0f);
+}
+
+TEST(RadixHeapTest, HoldsMoveOnlyValues) {
+    systems_dsa::radix_heap<std::uint16_t, std::unique_ptr<int>> heap {};
+    heap.emplace(7, new int { 7 });
+    heap.push({ 3, std::make_unique<int>(3) });
+    EXPECT_EQ(*heap.top().second, 3);
+    heap.pop();
+    EXPECT_EQ(*heap.top().second, 7);
+}
+
+TEST(RadixHeapTest, PmrHeapAllocatesFromItsResource) {
+    CountingResource resource {};
+    {
+        systems_dsa::pmr::radix_heap<std::uint32_t, int> heap { &resource };
+        for (std::uint32_t i {}; i < 100; ++i) {
+            heap.push({ i * 7919 % 1000, 0 });
+        }
+        heap.pop();
+        EXPECT_GT(resource.allocations, 0);
+        EXPECT_EQ(heap.get_allocator().resource(), &resource);
+    }
+    EXPECT_EQ(resource.bytesOutstanding, 0);
+}
+
+// Fails every allocation once `allocationsLeft` runs out
+class LimitedResource : public std::pmr::memory_resource {
+public:
+    int allocationsLeft { -1 };
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (allocationsLeft == 0) {
+            throw std::bad_alloc();
+        }
+        --allocationsLeft;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+TEST(RadixHeapTest, FailedRedistributionLeavesHeapUnchanged) {
+    // Past the small string buffer, so a moved-from value is visibly empty
+    const auto valueOf { [](std::uint32_t key) { return std::string(24, '#') + std::to_string(key); } };
+    int failures {};
+    // Every fail point of the first top(), which spreads one bucket of 64 keys over the buckets below it
+    for (int allowed {}; allowed < 64; ++allowed) {
+        LimitedResource resource {};
+        systems_dsa::pmr::radix_heap<std::uint32_t, std::string> heap { &resource };
+        for (std::uint32_t key { 1'000 }; key < 1'064; ++key) {
+            heap.push({ key, valueOf(key) });
+        }
+        resource.allocationsLeft = allowed;
+        try {
+            EXPECT_EQ(heap.top().first, 1'000);
+        } catch (const std::bad_alloc&) {
+            ++failures;
+        }
+        resource.allocationsLeft = -1;
+
+        ASSERT_EQ(heap.size(), 64) << "allowed=" << allowed;
+        for (std::uint32_t key { 1'000 }; key < 1'064; ++key) {
+            ASSERT_EQ(heap.top().first, key) << "allowed=" << allowed;
+            ASSERT_EQ(heap.top().second, valueOf(key)) << "allowed=" << allowed;
+            heap.pop();
+        }
+    }
+    EXPECT_GT(failures, 0);
+}
+
+///////////////////////
+// Lifetime Tracking //
+///////////////////////
+
+TEST(RadixHeapTest, DestroysEveryElement) {
+    LifetimeTracker::resetCounts();
+    {
+        systems_dsa::radix_heap<std::uint32_t, LifetimeTracker> heap {};
+        for (int i {}; i < 50; ++i) {
+            heap.emplace(static_cast<std::uint32_t>((i * 37) % 50), i);
+        }
+        heap.pop();
+        heap.pop();
+        EXPECT_EQ(LifetimeTracker::liveCount, 48);
+    }
+    EXPECT_EQ(LifetimeTracker::liveCount, 0);
+}
+
+///////////////////////
+// Adversarial Tests //
+///////////////////////
+
+TEST(RadixHeapTest, RandomEventSimulationAgainstReference) {
+    const std::uint64_t seed { getSeed("RHEAP_SEED") };
+    SCOPED_TRACE(seed);
+    std::mt19937_64 rng { seed };
+    std::uniform_int_distribution<std::uint64_t> delayDist { 0, 1'000 };
+    std::uniform_int_distribution<int> burstDist { 0, 3 };
+
+    // Each popped event schedules 0-3 more at or after its own time, as a discrete-event simulator does
+    systems_dsa::radix_heap<std::uint64_t, int> heap {};
+    std::priority_queue<std::uint64_t, std::vector<std::uint64_t>, std::greater<>> reference {};
+    for (int i {}; i < 100; ++i) {
+        const std::uint64_t time { delayDist(rng) };
+        heap.push({ time, i });
+        reference.push(time);
+    }
+    for (int step {}; step < 5'000 && !reference.empty(); ++step) {
+        ASSERT_EQ(heap.size(), reference.size()) << "step=" << step;
+        const std::uint64_t now { heap.top().first };
+        ASSERT_EQ(now, reference.top()) << "step=" << step;
+        heap.pop();
+        reference.pop();
+        for (int burst { burstDist(rng) }; burst > 0; --burst) {
+            const std::uint64_t time { now + delayDist(rng) };
+            heap.push({ time, step });
+            reference.push(time);
+        }
+    }
+    while (!reference.empty()) {
+        ASSERT_EQ(heap.top().first, reference.top());
+        heap.pop();
+        reference.pop();
+    }
+    EXPECT_TRUE(heap.empty());
+}
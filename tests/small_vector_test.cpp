@@ -0,0 +1,487 @@
+#include "utils/counting_resource.hpp"
+#include "utils/lifetime_tracker.hpp"
+#include "utils/seed.hpp"
+#include "utils/throws_on_copy.hpp"
+
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include <random>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <systems_dsa/small_vector.hpp>
+#include <vector>
+
+///////////////////////////////
+// Basic functionality tests //
+///////////////////////////////
+
+TEST(SmallVectorTest, StaysInlineUpToN) {
+    CountingResource resource {};
+    {
+        systems_dsa::pmr::small_vector<int, 8> myVec { &resource };
+        EXPECT_EQ(myVec.capacity(), 8);
+        for (int i {}; i < 8; ++i) {
+            myVec.push_back(i);
+        }
+        EXPECT_TRUE(myVec.is_inline());
+        EXPECT_EQ(resource.allocations, 0);
+
+        myVec.push_back(8);
+        EXPECT_FALSE(myVec.is_inline());
+        EXPECT_EQ(resource.allocations, 1);
+        EXPECT_GT(myVec.capacity(), 8);
+        for (int i {}; i < 9; ++i) {
+            EXPECT_EQ(myVec[i], i);
+        }
+    }
+    EXPECT_EQ(resource.bytesOutstanding, 0);
+}
+
+TEST(SmallVectorTest, PushBackOfOwnElementAtCapacity) {
+    // Strings long enough to live on the heap, so reading one after it's moved from would see an empty string
+    const auto name = [](int i) { return std::string(32, 'a') + std::to_string(i); };
+    systems_dsa::small_vector<std::string, 4> myVec;
+    for (int i {}; i < 4; ++i) {
+        myVec.push_back(name(i));
+    }
+
+    // Spills from inline storage, then regrows the heap block
+    myVec.push_back(myVec.back());
+    EXPECT_FALSE(myVec.is_inline());
+    while (myVec.size() < myVec.capacity()) {
+        myVec.push_back(myVec.front());
+    }
+    myVec.push_back(myVec.back());
+
+    ASSERT_GT(myVec.size(), 5);
+    for (int i {}; i < 4; ++i) {
+        EXPECT_EQ(myVec[i], name(i));
+    }
+    EXPECT_EQ(myVec[4], name(3));
+    EXPECT_EQ(myVec.back(), myVec[myVec.size() - 2]);
+}
+
+TEST(SmallVectorTest, ReserveAndResizeOnlyAllocatePastN) {
+    systems_dsa::small_vector<int, 4> myVec(3);
+    EXPECT_TRUE(myVec.is_inline());
+    EXPECT_EQ(myVec.size(), 0);
+    myVec.resize(4);
+    EXPECT_TRUE(myVec.is_inline());
+    myVec.resize(20);
+    EXPECT_FALSE(myVec.is_inline());
+    EXPECT_EQ(myVec.capacity(), 20);
+    EXPECT_EQ(myVec[19], 0);
+    myVec.reserve(10);
+    EXPECT_EQ(myVec.capacity(), 20);
+    EXPECT_THROW(myVec.at(20), std::out_of_range);
+}
+
+TEST(SmallVectorTest, ShrinkToFitMovesBackInline) {
+    systems_dsa::small_vector<std::string, 2> myVec { "first", "second", "third" };
+    EXPECT_FALSE(myVec.is_inline());
+    myVec.pop_back();
+    myVec.shrink_to_fit();
+    EXPECT_TRUE(myVec.is_inline());
+    EXPECT_EQ(myVec.capacity(), 2);
+    EXPECT_EQ(myVec.front(), "first");
+    EXPECT_EQ(myVec.back(), "second");
+}
+
+TEST(SmallVectorTest, RangeBasedForLoopWorks) {
+    systems_dsa::small_vector<int, 4> myVec { 1, 2, 3, 4, 5 };
+    int sum {};
+    for (const int value : myVec) {
+        sum += value;
+    }
+    EXPECT_EQ(sum, 15);
+}
+
+////////////////////
+// Bulk Modifiers //
+////////////////////
+
+TEST(SmallVectorTest, AppendRangeSpillsOnce) {
+    CountingResource resource {};
+    {
+        systems_dsa::pmr::small_vector<int, 4> myVec { &resource };
+        myVec.append_range(std::vector<int> { 0, 1, 2 });
+        EXPECT_TRUE(myVec.is_inline());
+        EXPECT_EQ(resource.allocations, 0);
+
+        myVec.append_range(std::vector<int> { 3, 4, 5 });
+        EXPECT_FALSE(myVec.is_inline());
+        EXPECT_EQ(resource.allocations, 1);
+        ASSERT_EQ(myVec.size(), 6);
+        for (int i {}; i < 6; ++i) {
+            EXPECT_EQ(myVec[i], i);
+        }
+    }
+    EXPECT_EQ(resource.bytesOutstanding, 0);
+
+    systems_dsa::small_vector<std::string, 2> strings { "a" };
+    const std::vector<std::string> batch { "b", "c" };
+    strings.append_range(batch);
+    EXPECT_FALSE(strings.is_inline());
+    ASSERT_EQ(strings.size(), 3);
+    EXPECT_EQ(strings[2], "c");
+
+    std::istringstream input { "1 2 3 4 5" };
+    systems_dsa::small_vector<int, 4> fromInput { 0 };
+    fromInput.append_range(std::views::istream<int>(input));
+    EXPECT_FALSE(fromInput.is_inline());
+    ASSERT_EQ(fromInput.size(), 6);
+    EXPECT_EQ(fromInput[5], 5);
+}
+
+TEST(SmallVectorTest, AssignSpillsAndReusesHeapBlock) {
+    systems_dsa::small_vector<std::string, 2> myVec { "a" };
+    myVec.assign(2, "x");
+    EXPECT_TRUE(myVec.is_inline());
+    ASSERT_EQ(myVec.size(), 2);
+    EXPECT_EQ(myVec[1], "x");
+
+    const std::vector<std::string> source { "d", "e", "f", "g", "h" };
+    myVec.assign(source.begin(), source.end());
+    EXPECT_FALSE(myVec.is_inline());
+    EXPECT_EQ(myVec.capacity(), 5);
+    ASSERT_EQ(myVec.size(), 5);
+    EXPECT_EQ(myVec[4], "h");
+
+    myVec.assign({ "i" });
+    ASSERT_EQ(myVec.size(), 1);
+    EXPECT_EQ(myVec[0], "i");
+    EXPECT_EQ(myVec.capacity(), 5) << "A heap block that's big enough should be reused";
+
+    systems_dsa::small_vector<int, 4> ints {};
+    ints.assign(6, 7);
+    EXPECT_FALSE(ints.is_inline());
+    EXPECT_EQ(ints.capacity(), 6);
+    EXPECT_EQ(ints[5], 7);
+}
+
+TEST(SmallVectorTest, InsertRangeSpillsFromInline) {
+    systems_dsa::small_vector<int, 4> ints { 0, 1, 5, 6 };
+    const std::vector<int> middle { 2, 3, 4 };
+    const auto inserted { ints.insert(ints.begin() + 2, middle.begin(), middle.end()) };
+    EXPECT_FALSE(ints.is_inline());
+    EXPECT_EQ(*inserted, 2);
+    ASSERT_EQ(ints.size(), 7);
+    for (int i {}; i < 7; ++i) {
+        EXPECT_EQ(ints[i], i);
+    }
+
+    systems_dsa::small_vector<std::string, 4> strings { "a", "d" };
+    strings.insert(strings.begin() + 1, { "b", "c" });
+    EXPECT_TRUE(strings.is_inline());
+    strings.insert(strings.begin(), { "0" });
+    EXPECT_FALSE(strings.is_inline());
+    strings.insert(strings.cend(), { "e" });
+    ASSERT_EQ(strings.size(), 6);
+    EXPECT_EQ(strings[0], "0");
+    EXPECT_EQ(strings[1], "a");
+    EXPECT_EQ(strings[3], "c");
+    EXPECT_EQ(strings[5], "e");
+
+    std::istringstream input { "2 3" };
+    systems_dsa::small_vector<int, 2> fromInput { 1, 4 };
+    fromInput.insert_range(fromInput.begin() + 1, std::views::istream<int>(input));
+    EXPECT_FALSE(fromInput.is_inline());
+    ASSERT_EQ(fromInput.size(), 4);
+    for (int i {}; i < 4; ++i) {
+        EXPECT_EQ(fromInput[i], i + 1);
+    }
+}
+
+TEST(SmallVectorTest, EraseShiftsTheRestDownAndKeepsStorage) {
+    systems_dsa::small_vector<std::string, 4> inlineVec { "a", "b", "c", "d" };
+    auto next { inlineVec.erase(inlineVec.begin() + 1) };
+    EXPECT_EQ(*next, "c");
+    EXPECT_TRUE(inlineVec.is_inline());
+    ASSERT_EQ(inlineVec.size(), 3);
+    EXPECT_EQ(inlineVec[2], "d");
+
+    systems_dsa::small_vector<int, 2> heapVec { 0, 1, 2, 3, 4, 5 };
+    const std::size_t capacity { heapVec.capacity() };
+    const auto heapNext { heapVec.erase(heapVec.begin() + 1, heapVec.begin() + 5) };
+    EXPECT_EQ(*heapNext, 5);
+    EXPECT_FALSE(heapVec.is_inline()) << "Erasing keeps the heap block, like clear()";
+    EXPECT_EQ(heapVec.capacity(), capacity);
+    ASSERT_EQ(heapVec.size(), 2);
+    EXPECT_EQ(heapVec[0], 0);
+    EXPECT_EQ(heapVec[1], 5);
+    const auto end { heapVec.erase(heapVec.cbegin(), heapVec.cend()) };
+    EXPECT_EQ(end, heapVec.end());
+    EXPECT_TRUE(heapVec.empty());
+}
+
+TEST(SmallVectorTest, ResizeForOverwriteSpillsPastN) {
+    systems_dsa::small_vector<int, 4> ints { 1, 2 };
+    ints.resize_for_overwrite(4);
+    EXPECT_TRUE(ints.is_inline());
+    ints.resize_for_overwrite(100);
+    EXPECT_FALSE(ints.is_inline());
+    EXPECT_EQ(ints.size(), 100);
+    EXPECT_EQ(ints.capacity(), 100);
+    EXPECT_EQ(ints[1], 2);
+
+    LifetimeTracker::resetCounts();
+    systems_dsa::small_vector<LifetimeTracker, 2> trackers {};
+    trackers.resize_for_overwrite(5);
+    EXPECT_FALSE(trackers.is_inline());
+    EXPECT_EQ(LifetimeTracker::ctorCount, 5);
+    trackers.resize_for_overwrite(2);
+    EXPECT_EQ(LifetimeTracker::dtorCount, 3);
+}
+
+TEST(SmallVectorTest, SwapExchangesInlineAndHeapElements) {
+    systems_dsa::small_vector<std::string, 2> inlineVec { "a" };
+    systems_dsa::small_vector<std::string, 2> heapVec { "b", "c", "d" };
+    const std::string* heapData { heapVec.data() };
+
+    inlineVec.swap(heapVec);
+    EXPECT_FALSE(inlineVec.is_inline());
+    EXPECT_EQ(inlineVec.data(), heapData) << "A heap block should change hands, not be copied";
+    ASSERT_EQ(inlineVec.size(), 3);
+    EXPECT_EQ(inlineVec[2], "d");
+    EXPECT_TRUE(heapVec.is_inline());
+    ASSERT_EQ(heapVec.size(), 1);
+    EXPECT_EQ(heapVec[0], "a");
+
+    systems_dsa::small_vector<std::string, 2> otherInline { "x", "y" };
+    swap(heapVec, otherInline);
+    EXPECT_TRUE(heapVec.is_inline());
+    EXPECT_TRUE(otherInline.is_inline());
+    ASSERT_EQ(heapVec.size(), 2);
+    EXPECT_EQ(heapVec[1], "y");
+    ASSERT_EQ(otherInline.size(), 1);
+    EXPECT_EQ(otherInline[0], "a");
+
+    systems_dsa::small_vector<std::string, 2> otherHeap { "1", "2", "3", "4" };
+    const std::string* otherHeapData { otherHeap.data() };
+    std::ranges::swap(inlineVec, otherHeap);
+    EXPECT_EQ(inlineVec.data(), otherHeapData);
+    EXPECT_EQ(otherHeap.data(), heapData);
+    EXPECT_EQ(inlineVec.size(), 4);
+    EXPECT_EQ(otherHeap.size(), 3);
+}
+
+TEST(SmallVectorTest, PmrSwapReturnsEveryBlock) {
+    CountingResource resource {};
+    {
+        systems_dsa::pmr::small_vector<int, 4> inlineVec { &resource };
+        systems_dsa::pmr::small_vector<int, 4> heapVec { &resource };
+        inlineVec.push_back(1);
+        for (int i {}; i < 10; ++i) {
+            heapVec.push_back(i);
+        }
+        const auto allocationsBefore { resource.allocations };
+        inlineVec.swap(heapVec);
+        EXPECT_EQ(inlineVec.size(), 10);
+        EXPECT_EQ(heapVec.size(), 1);
+        EXPECT_EQ(resource.allocations, allocationsBefore) << "Swapping should not allocate";
+    }
+    EXPECT_EQ(resource.bytesOutstanding, 0);
+}
+
+////////////////////////
+// Copy / move tests  //
+////////////////////////
+
+TEST(SmallVectorTest, CopiesAreIndependent) {
+    systems_dsa::small_vector<std::string, 2> inlineVec { "a", "b" };
+    systems_dsa::small_vector<std::string, 2> heapVec { "c", "d", "e" };
+
+    systems_dsa::small_vector<std::string, 2> inlineCopy { inlineVec };
+    systems_dsa::small_vector<std::string, 2> heapCopy { heapVec };
+    EXPECT_TRUE(inlineCopy.is_inline());
+    EXPECT_FALSE(heapCopy.is_inline());
+    inlineVec[0] = "changed";
+    heapVec[0] = "changed";
+    EXPECT_EQ(inlineCopy[0], "a");
+    EXPECT_EQ(heapCopy[0], "c");
+
+    heapCopy = inlineCopy;
+    EXPECT_TRUE(heapCopy.is_inline());
+    EXPECT_EQ(heapCopy.size(), 2);
+    EXPECT_EQ(heapCopy[1], "b");
+}
+
+TEST(SmallVectorTest, MoveTakesHeapBlockAndRelocatesInline) {
+    systems_dsa::small_vector<std::string, 2> heapVec { "a", "b", "c" };
+    const std::string* heapData { &heapVec[0] };
+    systems_dsa::small_vector<std::string, 2> movedHeap { std::move(heapVec) };
+    EXPECT_EQ(&movedHeap[0], heapData) << "A heap block should be taken over, not copied";
+    EXPECT_TRUE(heapVec.empty());
+    EXPECT_TRUE(heapVec.is_inline());
+
+    systems_dsa::small_vector<std::string, 2> inlineVec { "x" };
+    movedHeap = std::move(inlineVec);
+    EXPECT_TRUE(movedHeap.is_inline());
+    ASSERT_EQ(movedHeap.size(), 1);
+    EXPECT_EQ(movedHeap[0], "x");
+    EXPECT_TRUE(inlineVec.empty());
+}
+
+TEST(SmallVectorTest, PmrMoveAssignAcrossResourcesKeepsAllocator) {
+    CountingResource resourceA {};
+    CountingResource resourceB {};
+    {
+        systems_dsa::pmr::small_vector<int, 4> vecA { &resourceA };
+        systems_dsa::pmr::small_vector<int, 4> vecB { &resourceB };
+        for (int i {}; i < 50; ++i) {
+            vecA.push_back(i);
+        }
+        vecB = std::move(vecA);
+        EXPECT_EQ(vecB.get_allocator().resource(), &resourceB);
+        ASSERT_EQ(vecB.size(), 50);
+        EXPECT_EQ(vecB[49], 49);
+        EXPECT_GT(resourceB.allocations, 0);
+    }
+    EXPECT_EQ(resourceA.bytesOutstanding, 0);
+    EXPECT_EQ(resourceB.bytesOutstanding, 0);
+}
+
+//////////////////////
+// Exception Safety //
+//////////////////////
+
+TEST(SmallVectorTest, ContainerUnmodifiedAfterSpillThrows) {
+    ThrowsOnCopy::resetCounts();
+    {
+        systems_dsa::small_vector<ThrowsOnCopy, 4> myVec;
+        for (int i {}; i < 4; ++i) {
+            ThrowsOnCopy myObj { i };
+            myVec.push_back(myObj);
+        }
+        ThrowsOnCopy::throwOnInstance = 6;
+        EXPECT_ANY_THROW(myVec.reserve(10));
+        EXPECT_TRUE(myVec.is_inline());
+        ASSERT_EQ(myVec.size(), 4);
+        for (int i {}; i < 4; ++i) {
+            EXPECT_EQ(myVec[i].id, i);
+        }
+    }
+    EXPECT_EQ(ThrowsOnCopy::instanceCount, 0);
+}
+
+///////////////////////
+// Lifetime Tracking //
+///////////////////////
+
+TEST(SmallVectorTest, DestructorDestroysInlineAndHeapElements) {
+    for (std::size_t count : { 3, 10 }) {
+        {
+            systems_dsa::small_vector<LifetimeTracker, 4> myVec {};
+            for (std::size_t i {}; i < count; ++i) {
+                myVec.emplace_back(static_cast<int>(i));
+            }
+            LifetimeTracker::resetCounts();
+        }
+        EXPECT_EQ(LifetimeTracker::dtorCount, static_cast<int>(count));
+    }
+}
+
+///////////////////////
+// Adversarial Tests //
+///////////////////////
+
+TEST(SmallVectorTest, RandomSeqAgainstStd) {
+    const std::uint64_t seed { getSeed("SMALL_VECTOR_SEED") };
+    SCOPED_TRACE(seed);
+    std::mt19937_64 rng { seed };
+    std::uniform_int_distribution<int> opDist { 0, 5 };
+    std::uniform_int_distribution<std::size_t> sizeDist { 0, 24 };
+
+    systems_dsa::small_vector<std::string, 8> myVec;
+    std::vector<std::string> stdVec;
+    for (int step {}; step < 2'000; ++step) {
+        switch (opDist(rng)) {
+            case 0:
+            case 1:
+                myVec.push_back(std::to_string(step));
+                stdVec.push_back(std::to_string(step));
+                break;
+            case 2:
+                if (!stdVec.empty()) {
+                    myVec.pop_back();
+                    stdVec.pop_back();
+                }
+                break;
+            case 3: {
+                const std::size_t newSize { sizeDist(rng) };
+                myVec.resize(newSize);
+                stdVec.resize(newSize);
+                break;
+            }
+            case 4:
+                myVec.shrink_to_fit();
+                break;
+            case 5: {
+                systems_dsa::small_vector<std::string, 8> moved { std::move(myVec) };
+                myVec = moved;
+                break;
+            }
+        }
+        ASSERT_EQ(myVec.size(), stdVec.size()) << "step=" << step;
+        for (std::size_t i {}; i < stdVec.size(); ++i) {
+            ASSERT_EQ(myVec[i], stdVec[i]) << "step=" << step << " i=" << i;
+        }
+    }
+}
+
+TEST(SmallVectorTest, RandomBulkOpsAgainstStd) {
+    const std::uint64_t seed { getSeed("SMALL_VECTOR_SEED") };
+    SCOPED_TRACE(seed);
+    std::mt19937_64 rng { seed };
+    std::uniform_int_distribution<int> opDist { 0, 5 };
+    std::uniform_int_distribution<std::size_t> countDist { 0, 6 };
+
+    systems_dsa::small_vector<std::string, 8> myVec;
+    std::vector<std::string> stdVec;
+    systems_dsa::small_vector<std::string, 8> otherVec;
+    std::vector<std::string> otherStd;
+    for (int step {}; step < 2'000; ++step) {
+        std::vector<std::string> batch(countDist(rng));
+        for (std::size_t i {}; i < batch.size(); ++i) {
+            batch[i] = std::to_string(step) + "." + std::to_string(i);
+        }
+        std::uniform_int_distribution<std::size_t> posDist { 0, stdVec.size() };
+        const std::size_t pos { posDist(rng) };
+        switch (opDist(rng)) {
+            case 0:
+                myVec.append_range(batch);
+                stdVec.insert(stdVec.end(), batch.begin(), batch.end());
+                break;
+            case 1:
+                myVec.insert(myVec.begin() + pos, batch.begin(), batch.end());
+                stdVec.insert(stdVec.begin() + static_cast<std::ptrdiff_t>(pos), batch.begin(), batch.end());
+                break;
+            case 2: {
+                const std::size_t last { std::min(stdVec.size(), pos + countDist(rng)) };
+                myVec.erase(myVec.begin() + pos, myVec.begin() + last);
+                stdVec.erase(stdVec.begin() + static_cast<std::ptrdiff_t>(pos),
+                    stdVec.begin() + static_cast<std::ptrdiff_t>(last));
+                break;
+            }
+            case 3:
+                if (step % 4 == 0) {
+                    myVec.assign(batch.begin(), batch.end());
+                    stdVec.assign(batch.begin(), batch.end());
+                }
+                break;
+            case 4:
+                myVec.swap(otherVec);
+                stdVec.swap(otherStd);
+                break;
+            case 5:
+                myVec.shrink_to_fit();
+                break;
+        }
+        ASSERT_EQ(myVec.size(), stdVec.size()) << "step=" << step;
+        for (std::size_t i {}; i < stdVec.size(); ++i) {
+            ASSERT_EQ(myVec[i], stdVec[i]) << "step=" << step << " i=" << i;
+        }
+        ASSERT_EQ(otherVec.size(), otherStd.size()) << "step=" << step;
+    }
+}
@@ -0,0 +1,282 @@
+#include "utils/seed.hpp"
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory_resource>
+#include <random>
+#include <systems_dsa/unordered_map_snapshot.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    // A file in the temp directory, removed when the test ends
+    class TempFile {
+    public:
+        explicit TempFile(const std::string& name)
+            : m_path { std::filesystem::temp_directory_path() / ("systems_dsa_" + name + ".snapshot") } {}
+
+        ~TempFile() {
+            std::error_code ec {};
+            std::filesystem::remove(m_path, ec);
+        }
+
+        const std::filesystem::path& path() const noexcept {
+            return m_path;
+        }
+
+    private:
+        std::filesystem::path m_path;
+    };
+
+    struct Point {
+        double x {};
+        double y {};
+    };
+
+    using Header = systems_dsa::detail::SnapshotHeader;
+
+    // Overwrites the header of the snapshot at `path` with `patch` applied to it
+    template <typename Patch>
+    void patchHeader(const std::filesystem::path& path, Patch patch) {
+        Header header {};
+        {
+            std::ifstream in { path, std::ios::binary };
+            in.read(reinterpret_cast<char*>(&header), sizeof(Header));
+        }
+        patch(header);
+        std::fstream out { path, std::ios::binary | std::ios::in | std::ios::out };
+        out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    }
+
+    template <typename Snapshot, typename Map>
+    void expectCorruptHeaderThrows(const TempFile& file, const Map& hashMap, auto patch, const char* what) {
+        Snapshot::write(hashMap, file.path());
+        patchHeader(file.path(), patch);
+        EXPECT_THROW((void)Snapshot::open(file.path()), std::runtime_error) << what;
+    }
+}
+
+///////////////////////////////
+// Basic functionality tests //
+///////////////////////////////
+
+TEST(HashMapSnapshotTest, RoundTripMatchesMap) {
+    const TempFile file { "round_trip" };
+    systems_dsa::unordered_map<int, Point> hashMap {};
+    for (int i {}; i < 1000; ++i) {
+        hashMap.insert(i, Point { i * 0.5, -i * 2.0 });
+    }
+    systems_dsa::unordered_map_snapshot<int, Point>::write(hashMap, file.path());
+
+    const auto snapshot { systems_dsa::unordered_map_snapshot<int, Point>::open(file.path()) };
+    EXPECT_EQ(snapshot.size(), 1000);
+    EXPECT_EQ(snapshot.bucket_count(), hashMap.bucket_count());
+    for (int i {}; i < 1000; ++i) {
+        const auto* element { snapshot.find(i) };
+        ASSERT_NE(element, nullptr) << "key=" << i;
+        EXPECT_EQ(element->first, i);
+        EXPECT_EQ(element->second.x, i * 0.5);
+        EXPECT_EQ(snapshot.at(i).y, -i * 2.0);
+    }
+    EXPECT_FALSE(snapshot.contains(1000));
+    EXPECT_EQ(snapshot.find(-1), nullptr);
+    EXPECT_THROW((void)snapshot.at(5000), std::out_of_range);
+}
+
+TEST(HashMapSnapshotTest, TombstonesSurviveRoundTrip) {
+    const TempFile file { "tombstones" };
+    systems_dsa::unordered_map<int, int> hashMap {};
+    std::unordered_map<int, int> reference {};
+    std::mt19937_64 rng(getSeed("HASHMAP_SEED"));
+    std::uniform_int_distribution<int> distKey(1, 2000);
+    for (int i {}; i < 5000; ++i) {
+        const int key { distKey(rng) };
+        if (i % 3 == 0) {
+            EXPECT_EQ(hashMap.erase(key), reference.erase(key));
+        } else {
+            hashMap.insert(key, i);
+            reference.insert({ key, i });
+        }
+    }
+    systems_dsa::unordered_map_snapshot<int, int>::write(hashMap, file.path());
+
+    const auto snapshot { systems_dsa::unordered_map_snapshot<int, int>::open(file.path()) };
+    EXPECT_EQ(snapshot.size(), reference.size());
+    for (int key { 1 }; key <= 2000; ++key) {
+        const auto refIt { reference.find(key) };
+        if (refIt == reference.end()) {
+            EXPECT_FALSE(snapshot.contains(key)) << "key=" << key;
+        } else {
+            EXPECT_EQ(snapshot.at(key), refIt->second) << "key=" << key;
+        }
+    }
+    std::size_t visited {};
+    snapshot.for_each([&](const int& key, const int& value) {
+        EXPECT_EQ(reference.at(key), value);
+        ++visited;
+    });
+    EXPECT_EQ(visited, reference.size());
+}
+
+TEST(HashMapSnapshotTest, NonDefaultPoliciesRoundTrip) {
+    const TempFile file { "policies" };
+    systems_dsa::unordered_map<std::uint64_t, std::uint32_t, std::hash<std::uint64_t>, std::equal_to<std::uint64_t>,
+        systems_dsa::power_of_two_bucket_policy, systems_dsa::robin_hood_probe_policy, systems_dsa::cache_hash_policy> hashMap {};
+    for (std::uint64_t i {}; i < 500; ++i) {
+        hashMap.insert(i * 7919, static_cast<std::uint32_t>(i));
+    }
+    using Snapshot = systems_dsa::unordered_map_snapshot<std::uint64_t, std::uint32_t, std::hash<std::uint64_t>,
+        std::equal_to<std::uint64_t>, systems_dsa::power_of_two_bucket_policy, systems_dsa::robin_hood_probe_policy,
+        systems_dsa::cache_hash_policy>;
+    Snapshot::write(hashMap, file.path());
+
+    auto snapshot { Snapshot::open(file.path()) };
+    for (std::uint64_t i {}; i < 500; ++i) {
+        EXPECT_EQ(snapshot.at(i * 7919), i);
+        EXPECT_FALSE(snapshot.contains(i * 7919 + 1));
+    }
+
+    // The mapping moves with the snapshot
+    Snapshot moved { std::move(snapshot) };
+    EXPECT_EQ(moved.size(), 500);
+    EXPECT_EQ(moved.at(7919), 1);
+}
+
+TEST(HashMapSnapshotTest, SameMapWritesSameFile) {
+    const TempFile first { "deterministic_1" };
+    const TempFile second { "deterministic_2" };
+    systems_dsa::unordered_map<int, int> hashMap {};
+    for (int i {}; i < 100; ++i) {
+        hashMap.insert(i, i);
+    }
+    systems_dsa::unordered_map_snapshot<int, int>::write(hashMap, first.path());
+    systems_dsa::unordered_map_snapshot<int, int>::write(hashMap, second.path());
+
+    auto read = [](const std::filesystem::path& path) {
+        std::ifstream in { path, std::ios::binary };
+        return std::string { std::istreambuf_iterator<char> { in }, std::istreambuf_iterator<char> {} };
+    };
+    EXPECT_EQ(read(first.path()), read(second.path()));
+}
+
+TEST(HashMapSnapshotTest, PaddingDoesNotReachTheFile) {
+    // std::pair<const char, double> has 7 bytes of padding after the key, left as whatever the buckets' memory held
+    const TempFile first { "padding_1" };
+    const TempFile second { "padding_2" };
+    auto writeFrom = [](std::byte garbage, const std::filesystem::path& path) {
+        std::vector<std::byte> buffer(1 << 16, garbage);
+        std::pmr::monotonic_buffer_resource resource { buffer.data(), buffer.size(), std::pmr::null_memory_resource() };
+        systems_dsa::pmr::unordered_map<char, double> hashMap { &resource };
+        for (char c { 'a' }; c <= 'z'; ++c) {
+            hashMap.insert(c, c * 0.5);
+        }
+        systems_dsa::unordered_map_snapshot<char, double>::write(hashMap, path);
+    };
+    writeFrom(std::byte { 0xAB }, first.path());
+    writeFrom(std::byte { 0xCD }, second.path());
+
+    auto read = [](const std::filesystem::path& path) {
+        std::ifstream in { path, std::ios::binary };
+        return std::string { std::istreambuf_iterator<char> { in }, std::istreambuf_iterator<char> {} };
+    };
+    EXPECT_EQ(read(first.path()), read(second.path()));
+
+    auto snapshot { systems_dsa::unordered_map_snapshot<char, double>::open(first.path()) };
+    EXPECT_EQ(snapshot.size(), 26);
+    EXPECT_EQ(snapshot.at('q'), 'q' * 0.5);
+}
+
+////////////////////
+// Error handling //
+////////////////////
+
+TEST(HashMapSnapshotTest, MismatchedLayoutThrows) {
+    const TempFile file { "mismatch" };
+    systems_dsa::unordered_map<int, int> hashMap {};
+    hashMap.insert(1, 1);
+    systems_dsa::unordered_map_snapshot<int, int>::write(hashMap, file.path());
+
+    EXPECT_THROW((void)(systems_dsa::unordered_map_snapshot<int, double>::open(file.path())), std::runtime_error);
+}
+
+TEST(HashMapSnapshotTest, CorruptFilesThrow) {
+    const TempFile file { "corrupt" };
+    EXPECT_THROW((void)(systems_dsa::unordered_map_snapshot<int, int>::open(file.path())), std::system_error);
+
+    {
+        std::ofstream out { file.path(), std::ios::binary };
+        out << "not a snapshot, just some text that is long enough to hold a header of the expected size........";
+    }
+    EXPECT_THROW((void)(systems_dsa::unordered_map_snapshot<int, int>::open(file.path())), std::runtime_error);
+
+    systems_dsa::unordered_map<int, int> hashMap {};
+    hashMap.insert(1, 1);
+    systems_dsa::unordered_map_snapshot<int, int>::write(hashMap, file.path());
+    std::filesystem::resize_file(file.path(), std::filesystem::file_size(file.path()) - 1);
+    EXPECT_THROW((void)(systems_dsa::unordered_map_snapshot<int, int>::open(file.path())), std::runtime_error);
+}
+
+TEST(HashMapSnapshotTest, MismatchedPoliciesThrow) {
+    const TempFile file { "policy_mismatch" };
+    using Linear = systems_dsa::unordered_map_snapshot<int, int>;
+    using RobinHood = systems_dsa::unordered_map_snapshot<int, int, std::hash<int>, std::equal_to<int>,
+        systems_dsa::modulo_bucket_policy, systems_dsa::robin_hood_probe_policy>;
+    using CachesHash = systems_dsa::unordered_map_snapshot<int, int, std::hash<int>, std::equal_to<int>,
+        systems_dsa::modulo_bucket_policy, systems_dsa::linear_probe_policy, systems_dsa::cache_hash_policy>;
+    using PowerOfTwo = systems_dsa::unordered_map_snapshot<int, int, std::hash<int>, std::equal_to<int>,
+        systems_dsa::power_of_two_bucket_policy>;
+
+    systems_dsa::unordered_map<int, int> hashMap { 16 };
+    hashMap.insert(1, 1);
+    Linear::write(hashMap, file.path());
+    EXPECT_NO_THROW((void)Linear::open(file.path()));
+    EXPECT_THROW((void)RobinHood::open(file.path()), std::runtime_error);
+    EXPECT_THROW((void)CachesHash::open(file.path()), std::runtime_error);
+    EXPECT_THROW((void)PowerOfTwo::open(file.path()), std::runtime_error);
+}
+
+TEST(HashMapSnapshotTest, CorruptHeadersThrow) {
+    const TempFile file { "corrupt_header" };
+    using Snapshot = systems_dsa::unordered_map_snapshot<int, int>;
+    using CachingSnapshot = systems_dsa::unordered_map_snapshot<int, int, std::hash<int>, std::equal_to<int>,
+        systems_dsa::modulo_bucket_policy, systems_dsa::linear_probe_policy, systems_dsa::cache_hash_policy>;
+    systems_dsa::unordered_map<int, int> hashMap {};
+    systems_dsa::unordered_map<int, int, std::hash<int>, std::equal_to<int>, systems_dsa::modulo_bucket_policy,
+        systems_dsa::linear_probe_policy, systems_dsa::cache_hash_policy> cachingMap {};
+    for (int i {}; i < 5; ++i) {
+        hashMap.insert(i, i);
+        cachingMap.insert(i, i);
+    }
+
+    expectCorruptHeaderThrows<Snapshot>(file, hashMap,
+        [](Header& header) { header.hashOffset = 0; }, "hash offset on a map that doesn't cache hashes");
+    expectCorruptHeaderThrows<CachingSnapshot>(file, cachingMap,
+        [](Header& header) { header.hashOffset = header.bucketStride; }, "cached hash past the end of the bucket");
+    expectCorruptHeaderThrows<CachingSnapshot>(file, cachingMap,
+        [](Header& header) { header.hashOffset = Header::noHashOffset; }, "no cached hash on a map that caches them");
+    expectCorruptHeaderThrows<Snapshot>(file, hashMap,
+        [](Header& header) { header.bucketStride = 1; }, "bucket stride smaller than a bucket");
+    expectCorruptHeaderThrows<Snapshot>(file, hashMap,
+        [](Header& header) { header.ctrlOffset = 0; }, "control bytes overlapping the header");
+    expectCorruptHeaderThrows<Snapshot>(file, hashMap,
+        [](Header& header) { header.ctrlOffset = header.bucketsOffset + 1; }, "control bytes after the buckets");
+    expectCorruptHeaderThrows<Snapshot>(file, hashMap,
+        [](Header& header) { header.bucketsOffset = header.fileSize + 1; }, "buckets past the end of the file");
+    expectCorruptHeaderThrows<Snapshot>(file, hashMap,
+        [](Header& header) { header.bucketCount = (std::uint64_t { 1 } << 61) + 1; },
+        "bucket count whose byte size wraps around");
+    expectCorruptHeaderThrows<Snapshot>(file, hashMap,
+        [](Header& header) { header.bucketCount = std::numeric_limits<std::uint64_t>::max(); },
+        "bucket count whose control bytes wrap around");
+    expectCorruptHeaderThrows<Snapshot>(file, hashMap,
+        [](Header& header) { header.bucketCount = header.bucketsOffset - header.ctrlOffset; },
+        "control bytes running into the buckets");
+    expectCorruptHeaderThrows<Snapshot>(file, hashMap,
+        [](Header& header) { header.size = header.bucketCount + 1; }, "more elements than buckets");
+    expectCorruptHeaderThrows<Snapshot>(file, hashMap,
+        [](Header& header) { header.robinHood = 1; }, "probe policy");
+    expectCorruptHeaderThrows<Snapshot>(file, hashMap,
+        [](Header& header) { header.bucketPolicy = 2; }, "bucket policy");
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include <numeric>
+#include <systems_dsa/unordered_map.hpp>
+#include <vector>
+
+// Built into its own executable with SYSTEMS_DSA_HM_STATS defined, see CMakeLists.txt
+#ifndef SYSTEMS_DSA_HM_STATS
+#error "unordered_map_stats_test.cpp must be compiled with SYSTEMS_DSA_HM_STATS"
+#endif
+
+namespace {
+    std::uint64_t total(const std::array<std::uint64_t, systems_dsa::unordered_map_stats::histogramBins>& histogram) {
+        return std::accumulate(histogram.begin(), histogram.end(), std::uint64_t {});
+    }
+
+    struct IntHasher {
+        std::size_t operator()(const int& key) const noexcept {
+            return static_cast<std::size_t>(key);
+        }
+    };
+
+    struct ConstantHasher {
+        std::size_t operator()(const int&) const noexcept {
+            return 0;
+        }
+    };
+}
+
+TEST(HashMapStatsTest, EmptyMapReportsZeroes) {
+    systems_dsa::unordered_map<int, int> hashMap {};
+    const auto stats { hashMap.stats() };
+    EXPECT_EQ(total(stats.hit_probes), 0);
+    EXPECT_EQ(total(stats.miss_probes), 0);
+    EXPECT_EQ(stats.max_displacement, 0);
+    EXPECT_EQ(stats.rehash_count, 0);
+    EXPECT_EQ(stats.load_factor, 0.0);
+}
+
+TEST(HashMapStatsTest, LookupsAreRecordedAsHitsAndMisses) {
+    systems_dsa::unordered_map<int, int> hashMap {};
+    for (int i {}; i < 5; ++i) {
+        hashMap.insert(i, i);
+    }
+    hashMap.reset_stats();
+
+    for (int i {}; i < 5; ++i) {
+        EXPECT_TRUE(hashMap.contains(i));
+    }
+    for (int i { 100 }; i < 103; ++i) {
+        EXPECT_FALSE(hashMap.contains(i));
+    }
+    const auto stats { hashMap.stats() };
+    EXPECT_EQ(total(stats.hit_probes), 5);
+    EXPECT_EQ(total(stats.miss_probes), 3);
+}
+
+TEST(HashMapStatsTest, ProbeLengthsCountBucketsFromHome) {
+    systems_dsa::unordered_map<int, int, ConstantHasher> hashMap { 100 };
+    for (int i {}; i < 10; ++i) {
+        hashMap.insert(i, i);
+    }
+    hashMap.reset_stats();
+
+    // Key i sits i buckets past the shared home bucket
+    for (int i {}; i < 10; ++i) {
+        hashMap.find(i);
+    }
+    // The first OPEN bucket is 10 past home
+    hashMap.find(-1);
+
+    const auto stats { hashMap.stats() };
+    for (std::size_t bin {}; bin < 10; ++bin) {
+        EXPECT_EQ(stats.hit_probes[bin], 1) << "bin=" << bin;
+    }
+    EXPECT_EQ(stats.miss_probes[10], 1);
+    EXPECT_EQ(stats.max_displacement, 9);
+    EXPECT_DOUBLE_EQ(stats.mean_displacement, 4.5);
+}
+
+TEST(HashMapStatsTest, LongProbesLandInTheLastBin) {
+    systems_dsa::unordered_map<int, int, ConstantHasher> hashMap { 1000 };
+    constexpr int count { static_cast<int>(systems_dsa::unordered_map_stats::histogramBins) + 10 };
+    for (int i {}; i < count; ++i) {
+        hashMap.insert(i, i);
+    }
+    hashMap.reset_stats();
+    hashMap.find(count - 1);
+    EXPECT_EQ(hashMap.stats().hit_probes.back(), 1);
+}
+
+TEST(HashMapStatsTest, TombstoneRatioAndLoadFactor) {
+    systems_dsa::unordered_map<int, int> hashMap { 100 };
+    for (int i {}; i < 40; ++i) {
+        hashMap.insert(i, i);
+    }
+    for (int i {}; i < 10; ++i) {
+        hashMap.erase(i);
+    }
+    const auto stats { hashMap.stats() };
+    EXPECT_DOUBLE_EQ(stats.tombstone_ratio, 0.1);
+    EXPECT_DOUBLE_EQ(stats.load_factor, 0.4);
+}
+
+TEST(HashMapStatsTest, RehashesAreCountedAndTimed) {
+    systems_dsa::unordered_map<int, int> hashMap { 10 };
+    for (int i {}; i < 1000; ++i) {
+        hashMap.insert(i, i);
+    }
+    const auto stats { hashMap.stats() };
+    EXPECT_GT(stats.rehash_count, 0);
+    EXPECT_GT(stats.rehash_time.count(), 0);
+
+    hashMap.reset_stats();
+    EXPECT_EQ(hashMap.stats().rehash_count, 0);
+}
+
+TEST(HashMapStatsTest, InsertRangeRehashesOnce) {
+    std::vector<std::pair<int, int>> pairs {};
+    for (int i {}; i < 1000; ++i) {
+        pairs.emplace_back(i, i);
+    }
+    systems_dsa::unordered_map<int, int> hashMap { 10 };
+    hashMap.insert_range(pairs);
+    EXPECT_EQ(hashMap.stats().rehash_count, 1);
+
+    systems_dsa::unordered_map<int, int> constructed(pairs.begin(), pairs.end());
+    EXPECT_EQ(constructed.stats().rehash_count, 0);
+}
+
+TEST(HashMapStatsTest, ChiSquaredFlagsClusteringHasher) {
+    // Consecutive keys under an identity hash fill home buckets perfectly evenly
+    systems_dsa::unordered_map<int, int, IntHasher> evenMap { 1000 };
+    for (int i {}; i < 500; ++i) {
+        evenMap.insert(i, i);
+    }
+    const auto evenStats { evenMap.stats() };
+    EXPECT_LT(evenStats.home_chi_squared_z, 3.0);
+
+    systems_dsa::unordered_map<int, int, ConstantHasher> clusteredMap { 1000 };
+    for (int i {}; i < 500; ++i) {
+        clusteredMap.insert(i, i);
+    }
+    const auto clusteredStats { clusteredMap.stats() };
+    EXPECT_GT(clusteredStats.home_chi_squared, evenStats.home_chi_squared);
+    EXPECT_GT(clusteredStats.home_chi_squared_z, 100.0);
+}
+
+TEST(HashMapStatsTest, RobinHoodPolicyIsInstrumented) {
+    systems_dsa::unordered_map<int, int, ConstantHasher, std::equal_to<int>,
+        systems_dsa::modulo_bucket_policy, systems_dsa::robin_hood_probe_policy> hashMap { 100 };
+    for (int i {}; i < 10; ++i) {
+        hashMap.insert(i, i);
+    }
+    hashMap.erase(0);
+    hashMap.reset_stats();
+    hashMap.find(5);
+    const auto stats { hashMap.stats() };
+    EXPECT_EQ(total(stats.hit_probes), 1);
+    EXPECT_EQ(stats.max_displacement, 8) << "Backward shifting should have pulled the run one bucket closer";
+    EXPECT_EQ(stats.tombstone_ratio, 0.0);
+}
+
+TEST(HashMapStatsTest, MoveCarriesCounters) {
+    systems_dsa::unordered_map<int, int> hashMap {};
+    hashMap.insert(1, 1);
+    hashMap.reset_stats();
+    hashMap.find(1);
+
+    systems_dsa::unordered_map<int, int> moved { std::move(hashMap) };
+    EXPECT_EQ(total(moved.stats().hit_probes), 1);
+}
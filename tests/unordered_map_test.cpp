@@ -1,12 +1,20 @@
+#include "utils/counting_resource.hpp"
 #include "utils/lifetime_tracker.hpp"
 #include "utils/seed.hpp"
 #include "utils/throws_on_copy.hpp"
 
 #include <gtest/gtest.h>
+#include <array>
 #include <random>
 #include <unordered_map>
 #include <string>
+#include <string_view>
+#include <bit>
 #include <cctype>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <span>
 #include <systems_dsa/unordered_map.hpp>
 
 class HashMapTest_F : public testing::Test {
@@ -188,7 +196,7 @@ TEST(HashMapTest, ReservedMapAllowsCountElementsWithoutRehash) {
     systems_dsa::unordered_map<int, int> hashMap {};
     hashMap.reserve(100);
     std::size_t bucketCount { hashMap.bucket_count() };
-    for (std::size_t i {}; i < 100; ++i) {
+    for (int i {}; i < 100; ++i) {
         hashMap.insert({ i, {} });
     }
     EXPECT_EQ(bucketCount, hashMap.bucket_count()) << "Reserve didn't guarantee the map could hold N elements without a rehash";
@@ -198,11 +206,12 @@ TEST(HashMapTest, ReservedMapAllowsCountElementsWithoutRehash) {
 TEST(HashMapTest, ContainerUnmodifiedAfterReserveException) {
     systems_dsa::unordered_map<std::size_t, ThrowsOnCopy> hashMap { 10 };
     ThrowsOnCopy::resetCounts();
-    ThrowsOnCopy::throwOnInstance = 9;
 
     for (std::size_t i {}; i < 4; ++i) {
         EXPECT_NO_THROW(hashMap.insert(i, ThrowsOnCopy{})) << "insert threw for i=" << i;
     }
+    // The second element copied by the rehash throws
+    ThrowsOnCopy::throwOnInstance = ThrowsOnCopy::copyCtorCount + 2;
 
     // Throws on reserve
     EXPECT_ANY_THROW(hashMap.reserve(15));
@@ -221,12 +230,12 @@ TEST(HashMapTest, ContainerUnmodifiedAfterReserveException) {
 TEST(HashMapTest, ContainerUnmodifiedAfterInsertException) {
     systems_dsa::unordered_map<std::size_t, ThrowsOnCopy> hashMap { 10 };
     ThrowsOnCopy::resetCounts();
-    ThrowsOnCopy::throwOnInstance = 7;
 
     for (std::size_t i {}; i < 3; ++i) {
         EXPECT_NO_THROW(hashMap.insert(i, ThrowsOnCopy{}));
     }
-    std::cout << "copyCtorCount" << ThrowsOnCopy::copyCtorCount << '\n';
+    // The next copy, of the inserted value into its bucket, throws
+    ThrowsOnCopy::throwOnInstance = ThrowsOnCopy::copyCtorCount + 1;
 
     // Throws on insert
     EXPECT_ANY_THROW(hashMap.insert(3, ThrowsOnCopy{}));
@@ -252,6 +261,39 @@ TEST_F(HashMapTest_F, DuplicateInsertNoOps) {
     }
 }
 
+TEST_F(HashMapTest_F, FindBatchMatchesFind) {
+    std::vector<int> keys {};
+    for (int i {}; i < 50; ++i) {
+        keys.push_back(i); // Hits and misses, and not a multiple of the batch width
+    }
+    std::vector<decltype(hashMap)::iterator> results(keys.size());
+    hashMap.find_batch(keys, results);
+    for (std::size_t i {}; i < keys.size(); ++i) {
+        EXPECT_EQ(results[i], hashMap.find(keys[i])) << "key=" << keys[i];
+    }
+
+    const auto& constMap { hashMap };
+    std::vector<decltype(hashMap)::const_iterator> constResults(keys.size());
+    constMap.find_batch(keys, constResults);
+    for (std::size_t i {}; i < keys.size(); ++i) {
+        EXPECT_EQ(constResults[i], constMap.find(keys[i])) << "key=" << keys[i];
+    }
+}
+
+TEST_F(HashMapTest_F, ContainsBatchMatchesContains) {
+    std::vector<int> keys {};
+    for (int i {}; i < 50; ++i) {
+        keys.push_back(i);
+    }
+    std::unique_ptr<bool[]> results { new bool[keys.size()] };
+    hashMap.contains_batch(keys, std::span<bool> { results.get(), keys.size() });
+    for (std::size_t i {}; i < keys.size(); ++i) {
+        EXPECT_EQ(results[i], hashMap.contains(keys[i])) << "key=" << keys[i];
+    }
+
+    hashMap.contains_batch({}, {});
+}
+
 TEST_F(HashMapTest_F, IteratorPreIncrementTraversal) {
     std::size_t i {};
     for (auto it = hashMap.begin(); it != hashMap.end(); ++it, ++i) {
@@ -318,7 +360,7 @@ TEST(HashMapTest, GrowthPolicyEnforced) {
 
     EXPECT_EQ(hashMap.bucket_count(), 10);
 
-    for (std::size_t i{}; i < 7; ++i) {
+    for (int i{}; i < 7; ++i) {
         hashMap.insert({ i, {} });
     }
     EXPECT_GT(hashMap.bucket_count(), 10);
@@ -335,7 +377,7 @@ TEST(HashMapTest, DestructorDestroysElements) {
     LifetimeTracker::resetCounts();
     {
         systems_dsa::unordered_map<int, LifetimeTracker> hashMap;
-        for (std::size_t i{}; i < 5; ++i) {
+        for (int i{}; i < 5; ++i) {
             hashMap.insert({ i, {} });
         }
         EXPECT_EQ(LifetimeTracker::liveCount, 5);
@@ -344,6 +386,25 @@ TEST(HashMapTest, DestructorDestroysElements) {
     LifetimeTracker::resetCounts();
 }
 
+TEST(HashMapTest, PowerOfTwoPolicyRoundsBucketCount) {
+    using unordered_map = systems_dsa::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+        systems_dsa::power_of_two_bucket_policy>;
+    unordered_map hashMap { 10 };
+    EXPECT_EQ(hashMap.bucket_count(), 16);
+
+    hashMap.reserve(100);
+    EXPECT_TRUE(std::has_single_bit(hashMap.bucket_count()));
+    EXPECT_GE(hashMap.bucket_count() * hashMap.max_load_factor(), 100);
+
+    for (int i {}; i < 1000; ++i) {
+        hashMap.insert(i * 1024, i); // Stride that collides on the low bits without mixing
+    }
+    EXPECT_TRUE(std::has_single_bit(hashMap.bucket_count()));
+    for (int i {}; i < 1000; ++i) {
+        EXPECT_EQ(hashMap.find(i * 1024)->second, i);
+    }
+}
+
 TEST_F(HashMapTest_F, ReserveDoesntAllowShrinking) {
     std::size_t bucketCount { hashMap.bucket_count() };
     hashMap.reserve(1);
@@ -365,7 +426,32 @@ TEST(HashMapTest, ConstructorWithZeroThrows) {
 // Adversarial testing //
 /////////////////////////
 
-TEST(HashMapTest, RandomSeqInsertEraseFindAgainstStd) {
+// Every bucket and probe policy combination runs the same random sequence against std::unordered_map
+template <typename Map>
+class HashMapRandomSeqTest : public testing::Test {};
+
+using RandomSeqMaps = testing::Types<
+    systems_dsa::unordered_map<int, int>,
+    systems_dsa::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+        systems_dsa::power_of_two_bucket_policy>,
+    systems_dsa::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+        systems_dsa::modulo_bucket_policy, systems_dsa::robin_hood_probe_policy>,
+    systems_dsa::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+        systems_dsa::power_of_two_bucket_policy, systems_dsa::robin_hood_probe_policy>>;
+
+// Same order as RandomSeqMaps
+struct RandomSeqMapNames {
+    template <typename Map>
+    static std::string GetName(int index) {
+        constexpr std::array<std::string_view, 4> names {
+            "ModuloLinear", "PowerOfTwoLinear", "ModuloRobinHood", "PowerOfTwoRobinHood"
+        };
+        return std::string { names[static_cast<std::size_t>(index)] };
+    }
+};
+TYPED_TEST_SUITE(HashMapRandomSeqTest, RandomSeqMaps, RandomSeqMapNames);
+
+TYPED_TEST(HashMapRandomSeqTest, InsertEraseFindAgainstStd) {
     enum class OP: std::uint8_t {
         INSERT,
         ERASE,
@@ -377,7 +463,7 @@ TEST(HashMapTest, RandomSeqInsertEraseFindAgainstStd) {
     std::uniform_int_distribution<int> distKeyVal(1, 1000);
     std::uniform_int_distribution<int> distOp(0, 2);
 
-    systems_dsa::unordered_map<int, int> hashMap {};
+    TypeParam hashMap {};
     std::unordered_map<int, int> reference {};
 
     for (std::size_t i {}; i < 10'000; ++i) {
@@ -386,12 +472,10 @@ TEST(HashMapTest, RandomSeqInsertEraseFindAgainstStd) {
         const int val { distKeyVal(rng) };
         switch (static_cast<OP>(op)) {
         case OP::INSERT:
-            hashMap.insert({ key, val });
-            reference.insert({ key, val });
+            EXPECT_EQ(hashMap.insert({ key, val }).second, reference.insert({ key, val }).second);
             break;
         case OP::ERASE:
-            hashMap.erase(key);
-            reference.erase(key);
+            EXPECT_EQ(hashMap.erase(key), reference.erase(key));
             break;
         case OP::FIND:
             const auto it{ hashMap.find(key) };
@@ -556,6 +640,207 @@ TEST(HashMapTest, EverythingCollides) {
     EXPECT_EQ(hashMap.find(5)->second, 5 + 10);
 }
 
+TEST(HashMapTest, ProbingWrapsAroundTableEnd) {
+    struct IntHasher {
+        std::size_t operator()(const int& key) const noexcept {
+            return key;
+        }
+    };
+    systems_dsa::unordered_map<int, int, IntHasher> hashMap { 20 };
+
+    // Every key's home bucket is 18 or 19, so the probe sequence wraps into buckets 0, 1, 2
+    const std::vector<int> keys { 18, 19, 38, 39, 58 };
+    for (const int key : keys) {
+        hashMap.insert(key, key + 10);
+    }
+    EXPECT_EQ(hashMap.bucket_count(), 20);
+    for (const int key : keys) {
+        EXPECT_EQ(hashMap.find(key)->second, key + 10);
+    }
+
+    hashMap.erase(38);
+    EXPECT_FALSE(hashMap.contains(38));
+    EXPECT_EQ(hashMap.find(39)->second, 39 + 10);
+    EXPECT_EQ(hashMap.find(58)->second, 58 + 10);
+    EXPECT_FALSE(hashMap.contains(78));
+}
+
+TEST(HashMapTest, TablesSmallerThanAGroup) {
+    for (std::size_t bucketCount { 1 }; bucketCount < 20; ++bucketCount) {
+        systems_dsa::unordered_map<int, int> hashMap { bucketCount };
+        for (int i {}; i < 40; ++i) {
+            hashMap.insert(i, i * 2);
+        }
+        for (int i {}; i < 40; i += 2) {
+            hashMap.erase(i);
+        }
+        for (int i {}; i < 40; ++i) {
+            EXPECT_EQ(hashMap.contains(i), i % 2 == 1) << "bucketCount=" << bucketCount << " key=" << i;
+        }
+    }
+}
+
+TEST(HashMapTest, RobinHoodChurnCreatesNoTombstones) {
+    systems_dsa::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+        systems_dsa::modulo_bucket_policy, systems_dsa::robin_hood_probe_policy> hashMap {};
+    for (int i {}; i < 50; ++i) {
+        hashMap.insert(i, i);
+    }
+    const std::size_t bucketCount { hashMap.bucket_count() };
+
+    // Steady size churn, the tombstone scheme would keep growing the table here
+    for (int i { 50 }; i < 5000; ++i) {
+        EXPECT_EQ(hashMap.erase(i - 50), 1);
+        hashMap.insert(i, i);
+        EXPECT_FLOAT_EQ(hashMap.load_factor(), static_cast<float>(hashMap.size()) / hashMap.bucket_count());
+    }
+    EXPECT_EQ(hashMap.bucket_count(), bucketCount);
+    for (int i { 4950 }; i < 5000; ++i) {
+        EXPECT_EQ(hashMap.at(i), i);
+    }
+}
+
+TEST(HashMapTest, RobinHoodEverythingCollidesAndWraps) {
+    struct ConstantHasher {
+        std::size_t operator()(const int&) const noexcept {
+            return 19;
+        }
+    };
+    systems_dsa::unordered_map<int, int, ConstantHasher, std::equal_to<int>,
+        systems_dsa::modulo_bucket_policy, systems_dsa::robin_hood_probe_policy> hashMap { 20 };
+
+    // Every key's home bucket is 19, so the run wraps into the start of the table
+    for (int i {}; i < 10; ++i) {
+        hashMap.insert(i, i + 10);
+    }
+    EXPECT_EQ(hashMap.bucket_count(), 20);
+    hashMap.erase(0);
+    hashMap.erase(4);
+    hashMap.erase(9);
+    for (int i {}; i < 10; ++i) {
+        EXPECT_EQ(hashMap.contains(i), i != 0 && i != 4 && i != 9) << "key=" << i;
+    }
+    EXPECT_EQ(hashMap.find(5)->second, 5 + 10);
+    EXPECT_EQ(hashMap.bucket(1), 19) << "The run should have shifted back into the home bucket";
+}
+
+TEST(HashMapTest, RobinHoodIteratorEraseVisitsEveryElement) {
+    systems_dsa::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+        systems_dsa::modulo_bucket_policy, systems_dsa::robin_hood_probe_policy> hashMap {};
+    for (int i {}; i < 200; ++i) {
+        hashMap.insert(i, i);
+    }
+    int visited {};
+    for (auto it { hashMap.begin() }; it != hashMap.end();) {
+        ++visited;
+        if (it->first % 2 == 0) {
+            it = hashMap.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    EXPECT_GE(visited, 200);
+    EXPECT_EQ(hashMap.size(), 100);
+    for (int i {}; i < 200; ++i) {
+        EXPECT_EQ(hashMap.contains(i), i % 2 == 1) << "key=" << i;
+    }
+}
+
+TEST(HashMapTest, RobinHoodShiftsDestroyNoElements) {
+    LifetimeTracker::resetCounts();
+    {
+        systems_dsa::unordered_map<int, LifetimeTracker, std::hash<int>, std::equal_to<int>,
+            systems_dsa::modulo_bucket_policy, systems_dsa::robin_hood_probe_policy> hashMap {};
+        for (int i {}; i < 500; ++i) {
+            hashMap.insert(i, LifetimeTracker { i });
+        }
+        for (int i {}; i < 500; i += 3) {
+            hashMap.erase(i);
+        }
+        EXPECT_EQ(LifetimeTracker::liveCount, static_cast<int>(hashMap.size()));
+        for (const auto& pair : hashMap) {
+            EXPECT_EQ(pair.first, pair.second.id);
+        }
+    }
+    EXPECT_EQ(LifetimeTracker::liveCount, 0);
+    LifetimeTracker::resetCounts();
+}
+
+TEST(HashMapTest, RobinHoodThrowingRelocationKeepsMapValid) {
+    struct ConstantHasher {
+        std::size_t operator()(const int&) const noexcept {
+            return 0;
+        }
+    };
+    systems_dsa::unordered_map<int, ThrowsOnCopy, ConstantHasher, std::equal_to<int>,
+        systems_dsa::modulo_bucket_policy, systems_dsa::robin_hood_probe_policy> hashMap { 20 };
+    ThrowsOnCopy::resetCounts();
+    for (int i {}; i < 8; ++i) {
+        hashMap.insert(i, ThrowsOnCopy { i });
+    }
+
+    // Erasing the head of the run relocates the 7 elements after it, the third relocation throws
+    ThrowsOnCopy::throwOnInstance = ThrowsOnCopy::copyCtorCount + 3;
+    EXPECT_ANY_THROW(hashMap.erase(0));
+    ThrowsOnCopy::throwOnInstance = 0;
+
+    // Strong guarantee: the shift is undone and the erased element put back
+    EXPECT_EQ(hashMap.size(), 8);
+    EXPECT_EQ(static_cast<int>(hashMap.size()), ThrowsOnCopy::instanceCount);
+    for (int i {}; i < 8; ++i) {
+        ASSERT_TRUE(hashMap.contains(i)) << "key=" << i;
+        EXPECT_EQ(hashMap.at(i).id, i);
+    }
+    EXPECT_EQ(hashMap.erase(0), 1);
+    hashMap.insert(100, ThrowsOnCopy { 100 });
+    EXPECT_TRUE(hashMap.contains(100));
+    ThrowsOnCopy::resetCounts();
+}
+
+TEST(HashMapTest, RobinHoodThrowingInsertIntoDisplacedRunKeepsEveryElement) {
+    // Keys 0-9 share home bucket 0, 10-19 home bucket 1, and so on
+    struct TensHasher {
+        std::size_t operator()(const int& key) const noexcept {
+            return static_cast<std::size_t>(key / 10);
+        }
+    };
+    using Map = systems_dsa::unordered_map<int, ThrowsOnCopy, TensHasher, std::equal_to<int>,
+        systems_dsa::modulo_bucket_policy, systems_dsa::robin_hood_probe_policy>;
+    const std::vector<int> keys { 0, 1, 2, 3, 10, 11, 20 };
+
+    // Inserting key 4 takes bucket 4 and shifts keys 10, 11 and 20 forward. Each pass throws on a later copy: building
+    // the element, each of the three relocations, then constructing the element in its bucket.
+    for (int throwAt { 1 }; throwAt <= 5; ++throwAt) {
+        SCOPED_TRACE(throwAt);
+        ThrowsOnCopy::resetCounts();
+        {
+            Map hashMap { 20 };
+            for (const int key : keys) {
+                hashMap.insert(key, ThrowsOnCopy { key });
+            }
+            const ThrowsOnCopy value { 4 };
+            ThrowsOnCopy::throwOnInstance = ThrowsOnCopy::copyCtorCount + throwAt;
+            EXPECT_ANY_THROW(hashMap.insert(4, value));
+            ThrowsOnCopy::throwOnInstance = 0;
+
+            EXPECT_EQ(hashMap.size(), keys.size());
+            EXPECT_FALSE(hashMap.contains(4));
+            for (const int key : keys) {
+                ASSERT_TRUE(hashMap.contains(key)) << "key=" << key;
+                EXPECT_EQ(hashMap.at(key).id, key);
+            }
+            EXPECT_EQ(ThrowsOnCopy::instanceCount, static_cast<int>(keys.size()) + 1);
+
+            EXPECT_TRUE(hashMap.insert(4, value).second);
+            for (const int key : keys) {
+                EXPECT_TRUE(hashMap.contains(key)) << "key=" << key;
+            }
+        }
+        EXPECT_EQ(ThrowsOnCopy::instanceCount, 0);
+    }
+    ThrowsOnCopy::resetCounts();
+}
+
 TEST(HashMapTest, IteratorTraversalWithTombstonesAndOpen) {
     struct IntHasher {
         std::size_t operator()(const int& key) const noexcept {
@@ -579,3 +864,495 @@ TEST(HashMapTest, IteratorTraversalWithTombstonesAndOpen) {
     }
     EXPECT_EQ(filledCount, hashMap.size());
 }
+
+TEST(HashMapTest, TransparentLookupWithStringView) {
+    systems_dsa::unordered_map<std::string, int, systems_dsa::string_hash, std::equal_to<>> hashMap {};
+    for (int i {}; i < 100; ++i) {
+        hashMap.insert("key_number_" + std::to_string(i) + "_is_past_the_sso_buffer", i);
+    }
+
+    const std::string buffer { "key_number_42_is_past_the_sso_buffer" };
+    const std::string_view view { buffer };
+    ASSERT_NE(hashMap.find(view), hashMap.end());
+    EXPECT_EQ(hashMap.find(view)->second, 42);
+    EXPECT_TRUE(hashMap.contains(view));
+    EXPECT_TRUE(hashMap.contains("key_number_7_is_past_the_sso_buffer"));
+    EXPECT_FALSE(hashMap.contains(std::string_view { "missing" }));
+    EXPECT_EQ(hashMap.at(view), 42);
+    EXPECT_THROW((void)hashMap.at(std::string_view { "missing" }), std::out_of_range);
+
+    const auto& constMap { hashMap };
+    EXPECT_EQ(constMap.find(view)->second, 42);
+    EXPECT_EQ(constMap.at(view), 42);
+
+    hashMap[view] = 1000;
+    EXPECT_EQ(hashMap.at(buffer), 1000);
+    hashMap[std::string_view { "new_key" }] = 5;
+    EXPECT_EQ(hashMap.size(), 101);
+    EXPECT_EQ(hashMap.at("new_key"), 5);
+
+    EXPECT_EQ(hashMap.erase(view), 1);
+    EXPECT_EQ(hashMap.erase(view), 0);
+    EXPECT_FALSE(hashMap.contains(buffer));
+    EXPECT_EQ(hashMap.size(), 100);
+}
+
+namespace {
+    struct TrackerHash {
+        using is_transparent = void;
+        std::size_t operator()(int id) const noexcept {
+            return std::hash<int> {}(id);
+        }
+        std::size_t operator()(const LifetimeTracker& key) const noexcept {
+            return (*this)(key.id);
+        }
+    };
+
+    struct TrackerEqual {
+        using is_transparent = void;
+        bool operator()(const LifetimeTracker& lhs, const LifetimeTracker& rhs) const noexcept {
+            return lhs.id == rhs.id;
+        }
+        bool operator()(const LifetimeTracker& lhs, int rhs) const noexcept {
+            return lhs.id == rhs;
+        }
+    };
+}
+
+TEST(HashMapTest, TryEmplaceConstructsNothingOnHit) {
+    systems_dsa::unordered_map<LifetimeTracker, LifetimeTracker, TrackerHash, TrackerEqual> hashMap { 64 };
+    hashMap.try_emplace(1, 10);
+    LifetimeTracker::resetCounts();
+
+    auto [it, inserted] { hashMap.try_emplace(1, 20) };
+    EXPECT_FALSE(inserted);
+    EXPECT_EQ(it->second.id, 10);
+    EXPECT_EQ(LifetimeTracker::ctorCount, 0);
+    EXPECT_EQ(LifetimeTracker::copyCtorCount, 0);
+    EXPECT_EQ(LifetimeTracker::moveCtorCount, 0);
+
+    hashMap[1].id = 11;
+    EXPECT_EQ(LifetimeTracker::ctorCount, 0);
+    EXPECT_EQ(hashMap.at(1).id, 11);
+
+    // A miss constructs the key and the value in place, once each
+    std::tie(it, inserted) = hashMap.try_emplace(2, 30);
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(it->first.id, 2);
+    EXPECT_EQ(it->second.id, 30);
+    EXPECT_EQ(LifetimeTracker::ctorCount, 2);
+    EXPECT_EQ(LifetimeTracker::copyCtorCount, 0);
+    EXPECT_EQ(LifetimeTracker::moveCtorCount, 0);
+    LifetimeTracker::resetCounts();
+}
+
+TEST(HashMapTest, TryEmplaceLeavesArgumentsOnHit) {
+    systems_dsa::unordered_map<std::string, std::string> hashMap {};
+    std::string key { "a_key_long_enough_to_live_on_the_heap" };
+    std::string value { "a_value_long_enough_to_live_on_the_heap" };
+
+    EXPECT_TRUE(hashMap.try_emplace(key, value).second);
+    EXPECT_FALSE(hashMap.try_emplace(std::move(key), std::move(value)).second);
+    // Nothing was moved from on a hit
+    EXPECT_EQ(key, "a_key_long_enough_to_live_on_the_heap");
+    EXPECT_EQ(value, "a_value_long_enough_to_live_on_the_heap");
+
+    EXPECT_TRUE(hashMap.try_emplace("other", 3, 'x').second);
+    EXPECT_EQ(hashMap.at("other"), "xxx");
+    EXPECT_EQ(hashMap.size(), 2);
+}
+
+TEST(HashMapTest, PiecewiseEmplaceConstructsInPlace) {
+    systems_dsa::unordered_map<LifetimeTracker, LifetimeTracker, TrackerHash, TrackerEqual> hashMap { 64 };
+    LifetimeTracker::resetCounts();
+
+    auto [it, inserted] { hashMap.emplace(std::piecewise_construct, std::forward_as_tuple(1), std::forward_as_tuple(10)) };
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(it->first.id, 1);
+    EXPECT_EQ(it->second.id, 10);
+    EXPECT_EQ(LifetimeTracker::ctorCount, 2);
+    EXPECT_EQ(LifetimeTracker::copyCtorCount, 0);
+    EXPECT_EQ(LifetimeTracker::moveCtorCount, 0);
+
+    // A hit constructs nothing when the key argument can be probed with directly
+    std::tie(it, inserted) = hashMap.emplace(std::piecewise_construct, std::forward_as_tuple(1), std::forward_as_tuple(20));
+    EXPECT_FALSE(inserted);
+    EXPECT_EQ(it->second.id, 10);
+    EXPECT_EQ(LifetimeTracker::ctorCount, 2);
+
+    std::tie(it, inserted) = hashMap.emplace(2, 30);
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(LifetimeTracker::ctorCount, 4);
+    EXPECT_EQ(LifetimeTracker::copyCtorCount, 0);
+    EXPECT_EQ(LifetimeTracker::moveCtorCount, 0);
+    EXPECT_EQ(hashMap.size(), 2);
+    LifetimeTracker::resetCounts();
+}
+
+TEST(HashMapTest, EmplaceBuildsKeyWhenNotTransparent) {
+    systems_dsa::unordered_map<std::string, std::vector<int>> hashMap {};
+    EXPECT_TRUE(hashMap.emplace("key", std::vector<int> { 1, 2, 3 }).second);
+    EXPECT_FALSE(hashMap.emplace("key", std::vector<int> { 4 }).second);
+    EXPECT_TRUE(hashMap.emplace(std::piecewise_construct, std::forward_as_tuple(3, 'k'), std::forward_as_tuple(5, 7)).second);
+    EXPECT_FALSE(hashMap.emplace(std::piecewise_construct, std::forward_as_tuple("kkk"), std::forward_as_tuple()).second);
+
+    EXPECT_EQ(hashMap.at("key"), (std::vector<int> { 1, 2, 3 }));
+    EXPECT_EQ(hashMap.at("kkk"), (std::vector<int>(5, 7)));
+    EXPECT_EQ(hashMap.size(), 2);
+}
+
+TEST(HashMapTest, InsertOrAssign) {
+    systems_dsa::unordered_map<int, LifetimeTracker> hashMap { 64 };
+    LifetimeTracker::resetCounts();
+
+    LifetimeTracker value { 10 };
+    auto [it, inserted] { hashMap.insert_or_assign(1, value) };
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(it->second.id, 10);
+    EXPECT_EQ(LifetimeTracker::copyCtorCount, 1);
+    EXPECT_EQ(LifetimeTracker::copyAssignCount, 0);
+
+    std::tie(it, inserted) = hashMap.insert_or_assign(1, LifetimeTracker { 20 });
+    EXPECT_FALSE(inserted);
+    EXPECT_EQ(it->second.id, 20);
+    EXPECT_EQ(LifetimeTracker::moveAssignCount, 1);
+    EXPECT_EQ(LifetimeTracker::moveCtorCount, 0);
+    EXPECT_EQ(hashMap.size(), 1);
+    LifetimeTracker::resetCounts();
+}
+
+TEST(HashMapTest, TransparentInsertOrAssign) {
+    systems_dsa::unordered_map<std::string, int, systems_dsa::string_hash, std::equal_to<>> hashMap {};
+    EXPECT_TRUE(hashMap.insert_or_assign(std::string_view { "key" }, 1).second);
+    EXPECT_FALSE(hashMap.insert_or_assign("key", 2).second);
+    EXPECT_EQ(hashMap.at("key"), 2);
+}
+
+namespace {
+    template <typename ProbePolicy>
+    using StringStringMap = systems_dsa::unordered_map<std::string, std::string, std::hash<std::string>,
+        std::equal_to<std::string>, systems_dsa::modulo_bucket_policy, ProbePolicy>;
+
+    // Past the small string buffer, so a copy made from a moved-from or destroyed element comes out wrong
+    std::string longString(int i) {
+        return "a_string_that_does_not_fit_inline_" + std::to_string(i);
+    }
+
+    // Every insert takes its key or value from an element of the map, across several rehashes and (Robin Hood) shifts
+    template <typename ProbePolicy>
+    void expectArgumentsFromTheMapSurviveInsert() {
+        StringStringMap<ProbePolicy> hashMap {};
+        hashMap.try_emplace(longString(0), longString(0));
+        hashMap.try_emplace("next", longString(0));
+        const std::size_t initialBuckets { hashMap.bucket_count() };
+        for (int i { 1 }; i < 300; ++i) {
+            switch (i % 3) {
+            case 0:
+                hashMap.try_emplace(longString(i), hashMap.at(longString(0)));
+                break;
+            case 1:
+                hashMap.insert_or_assign(longString(i), hashMap.at(longString(0)));
+                break;
+            default:
+                // The key is the value of "next"
+                hashMap.insert_or_assign("next", longString(i));
+                hashMap[hashMap.at("next")] = longString(0);
+                break;
+            }
+        }
+        EXPECT_GT(hashMap.bucket_count(), initialBuckets);
+        EXPECT_EQ(hashMap.size(), 301);
+        for (int i {}; i < 300; ++i) {
+            ASSERT_EQ(hashMap.at(longString(i)), longString(0)) << "i=" << i;
+        }
+    }
+}
+
+TEST(HashMapTest, TryEmplaceAndInsertOrAssignTakeArgumentsFromTheMap) {
+    expectArgumentsFromTheMapSurviveInsert<systems_dsa::linear_probe_policy>();
+    expectArgumentsFromTheMapSurviveInsert<systems_dsa::robin_hood_probe_policy>();
+}
+
+namespace {
+    // insert(const K&, const V&) with a value from the map itself, up to and including the insert that rehashes
+    template <typename ProbePolicy>
+    void expectInsertFromTheMapAtThreshold() {
+        systems_dsa::unordered_map<int, std::string, std::hash<int>, std::equal_to<int>,
+            systems_dsa::modulo_bucket_policy, ProbePolicy> hashMap {};
+        hashMap.reserve(16);
+        hashMap.insert(0, longString(0));
+        const std::size_t reservedBuckets { hashMap.bucket_count() };
+        for (int key { 1 }; hashMap.bucket_count() == reservedBuckets; ++key) {
+            const std::string& value { hashMap.at(0) };
+            hashMap.insert(key, value);
+            ASSERT_EQ(hashMap.at(key), longString(0)) << "key=" << key;
+        }
+    }
+}
+
+TEST(HashMapTest, InsertValueFromTheMapAtRehashThreshold) {
+    expectInsertFromTheMapAtThreshold<systems_dsa::linear_probe_policy>();
+    expectInsertFromTheMapAtThreshold<systems_dsa::robin_hood_probe_policy>();
+}
+
+static_assert(systems_dsa::auto_hash_cache_policy::cache_hash<std::string>);
+static_assert(!systems_dsa::auto_hash_cache_policy::cache_hash<int>);
+
+namespace {
+    struct CountingStringHash {
+        inline static std::size_t calls {};
+        std::size_t operator()(const std::string& key) const noexcept {
+            ++calls;
+            return std::hash<std::string> {}(key);
+        }
+    };
+
+    struct CountingStringEqual {
+        inline static std::size_t calls {};
+        bool operator()(const std::string& lhs, const std::string& rhs) const noexcept {
+            ++calls;
+            return lhs == rhs;
+        }
+    };
+
+    template <typename HashCachePolicy>
+    using CountingStringMap = systems_dsa::unordered_map<std::string, int, CountingStringHash, CountingStringEqual,
+        systems_dsa::modulo_bucket_policy, systems_dsa::linear_probe_policy, HashCachePolicy>;
+}
+
+TEST(HashMapTest, HashCacheRehashReusesHashes) {
+    CountingStringMap<systems_dsa::cache_hash_policy> cached {};
+    CountingStringMap<systems_dsa::no_hash_cache_policy> uncached {};
+    for (int i {}; i < 100; ++i) {
+        cached.insert("key_" + std::to_string(i), i);
+        uncached.insert("key_" + std::to_string(i), i);
+    }
+
+    CountingStringHash::calls = 0;
+    cached.rehash(cached.bucket_count() * 4);
+    const std::size_t cachedCalls [[maybe_unused]] { CountingStringHash::calls };
+    CountingStringHash::calls = 0;
+    uncached.rehash(uncached.bucket_count() * 4);
+    const std::size_t uncachedCalls [[maybe_unused]] { CountingStringHash::calls };
+    // Debug builds rehash every key in assertValid, so the counts are only exact without it
+#ifdef NDEBUG
+    EXPECT_EQ(cachedCalls, 0);
+    EXPECT_EQ(uncachedCalls, 100);
+#endif
+
+    for (int i {}; i < 100; ++i) {
+        EXPECT_EQ(cached.at("key_" + std::to_string(i)), i);
+    }
+}
+
+TEST(HashMapTest, HashCacheSkipsEqualityOnMisses) {
+    CountingStringMap<systems_dsa::cache_hash_policy> hashMap {};
+    for (int i {}; i < 1000; ++i) {
+        hashMap.insert("present_" + std::to_string(i), i);
+    }
+    std::vector<std::string> missing {};
+    for (int i {}; i < 1000; ++i) {
+        missing.push_back("missing_" + std::to_string(i));
+    }
+
+    CountingStringEqual::calls = 0;
+    for (const auto& key : missing) {
+        EXPECT_FALSE(hashMap.contains(key));
+    }
+    // 7-bit tags alone would let roughly one in 128 FILLED candidates through to the key equality
+    EXPECT_EQ(CountingStringEqual::calls, 0);
+
+    CountingStringEqual::calls = 0;
+    EXPECT_TRUE(hashMap.contains("present_500"));
+    EXPECT_EQ(CountingStringEqual::calls, 1);
+}
+
+TEST(HashMapTest, RandomSeqRobinHoodCachedHashAgainstStd) {
+    std::uint64_t seed { getSeed("HASHMAP_SEED") };
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> distKey(1, 500);
+    std::uniform_int_distribution<int> distOp(0, 2);
+
+    systems_dsa::unordered_map<std::string, int, std::hash<std::string>, std::equal_to<std::string>,
+        systems_dsa::modulo_bucket_policy, systems_dsa::robin_hood_probe_policy, systems_dsa::cache_hash_policy> hashMap {};
+    std::unordered_map<std::string, int> reference {};
+
+    for (int i {}; i < 5'000; ++i) {
+        const std::string key { "a_key_that_does_not_fit_inline_" + std::to_string(distKey(rng)) };
+        switch (distOp(rng)) {
+        case 0:
+            EXPECT_EQ(hashMap.insert(key, i).second, reference.insert({ key, i }).second);
+            break;
+        case 1:
+            EXPECT_EQ(hashMap.erase(key), reference.erase(key));
+            break;
+        default:
+            EXPECT_EQ(hashMap.contains(key), reference.contains(key));
+            break;
+        }
+    }
+    EXPECT_EQ(hashMap.size(), reference.size());
+    for (const auto& [key, value] : reference) {
+        EXPECT_EQ(hashMap.at(key), value);
+    }
+}
+
+TEST(HashMapTest, RangeConstructorSizesTableOnce) {
+    std::vector<std::pair<int, int>> pairs {};
+    for (int i {}; i < 1000; ++i) {
+        pairs.emplace_back(i, i * 2);
+    }
+    systems_dsa::unordered_map<int, int> hashMap(pairs.begin(), pairs.end());
+    EXPECT_EQ(hashMap.size(), 1000);
+    // The smallest bucket count that stays under the max load factor with 1000 elements
+    EXPECT_EQ(hashMap.bucket_count(), 1429);
+    for (int i {}; i < 1000; ++i) {
+        EXPECT_EQ(hashMap.at(i), i * 2);
+    }
+}
+
+TEST(HashMapTest, InitializerListKeepsFirstDuplicate) {
+    systems_dsa::unordered_map<std::string, int> hashMap { { "one", 1 }, { "two", 2 }, { "one", 3 } };
+    EXPECT_EQ(hashMap.size(), 2);
+    EXPECT_EQ(hashMap.at("one"), 1);
+    EXPECT_EQ(hashMap.at("two"), 2);
+}
+
+TEST(HashMapTest, ReserveHoldsExactlyCountWithoutRehash) {
+    for (std::size_t count : { 1, 7, 10, 70, 100, 700 }) {
+        systems_dsa::unordered_map<std::size_t, int> hashMap {};
+        hashMap.reserve(count);
+        const std::size_t bucketCount { hashMap.bucket_count() };
+        for (std::size_t i {}; i < count; ++i) {
+            hashMap.insert(i, 1);
+        }
+        EXPECT_EQ(hashMap.bucket_count(), bucketCount) << "count=" << count;
+    }
+}
+
+TEST(HashMapTest, InsertRangeFromViews) {
+    systems_dsa::unordered_map<int, int> hashMap {};
+    hashMap.insert(0, -1);
+    auto evens { std::views::iota(0, 200)
+        | std::views::filter([](int i) { return i % 2 == 0; })
+        | std::views::transform([](int i) { return std::pair<int, int> { i, i }; }) };
+    hashMap.insert_range(evens);
+    EXPECT_EQ(hashMap.size(), 100);
+    EXPECT_EQ(hashMap.at(0), -1) << "insert_range must not overwrite existing keys";
+    EXPECT_EQ(hashMap.at(198), 198);
+    EXPECT_FALSE(hashMap.contains(1));
+
+    const std::vector<std::pair<int, int>> more { { 1, 1 }, { 3, 3 } };
+    hashMap.insert(more.begin(), more.end());
+    EXPECT_EQ(hashMap.size(), 102);
+}
+
+namespace {
+    // Every build is checked against std::unordered_map::insert, which keeps the first of equal keys
+    template <typename Map>
+    void expectParallelBuildMatches(const std::vector<std::pair<int, int>>& pairs, std::size_t threads) {
+        Map hashMap {};
+        hashMap.insert_range(pairs, threads);
+        std::unordered_map<int, int> reference {};
+        for (const auto& pair : pairs) {
+            reference.insert(pair);
+        }
+        ASSERT_EQ(hashMap.size(), reference.size()) << "threads=" << threads;
+        for (const auto& [key, value] : reference) {
+            ASSERT_TRUE(hashMap.contains(key)) << "key=" << key << " threads=" << threads;
+            EXPECT_EQ(hashMap.at(key), value) << "key=" << key << " threads=" << threads;
+        }
+    }
+}
+
+TEST(HashMapTest, ParallelBuildMatchesSerialInsert) {
+    std::mt19937_64 rng(getSeed("HASHMAP_SEED"));
+    std::uniform_int_distribution<int> distKey(0, 3'000);
+    std::vector<std::pair<int, int>> pairs {};
+    for (int i {}; i < 4'000; ++i) {
+        pairs.emplace_back(distKey(rng), i);
+    }
+
+    using PowerOfTwoCachedMap = systems_dsa::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+        systems_dsa::power_of_two_bucket_policy, systems_dsa::linear_probe_policy, systems_dsa::cache_hash_policy>;
+    for (std::size_t threads : { 1, 2, 3, 8 }) {
+        expectParallelBuildMatches<systems_dsa::unordered_map<int, int>>(pairs, threads);
+        expectParallelBuildMatches<PowerOfTwoCachedMap>(pairs, threads);
+    }
+}
+
+TEST(HashMapTest, ParallelBuildDefersRunsPastPartition) {
+    struct FewHomesHasher {
+        std::size_t operator()(const int& key) const noexcept {
+            return static_cast<std::size_t>(key % 3);
+        }
+    };
+    std::vector<std::pair<int, int>> pairs {};
+    for (int i {}; i < 1000; ++i) {
+        pairs.emplace_back(i, i);
+    }
+    // Every key's home is one of the first three buckets, so nearly all of them overflow the first partition
+    expectParallelBuildMatches<systems_dsa::unordered_map<int, int, FewHomesHasher>>(pairs, 4);
+}
+
+TEST(HashMapTest, PmrMapAllocatesTableFromItsResource) {
+    CountingResource resource {};
+    {
+        systems_dsa::pmr::unordered_map<int, int> hashMap { &resource };
+        for (int i {}; i < 500; ++i) {
+            hashMap.insert(i, i);
+        }
+        EXPECT_EQ(hashMap.get_allocator().resource(), &resource);
+        EXPECT_GT(resource.allocations, 0);
+        for (int i {}; i < 500; ++i) {
+            EXPECT_EQ(hashMap.at(i), i);
+        }
+
+        // Keys are constructed through the allocator, so pmr keys allocate from the map's resource too
+        systems_dsa::pmr::unordered_map<std::pmr::string, int> stringMap { &resource };
+        const std::size_t before { resource.allocations };
+        stringMap.insert(std::pmr::string { "a key long enough to not fit the small buffer" }, 1);
+        EXPECT_EQ(stringMap.begin()->first.get_allocator().resource(), &resource);
+        EXPECT_GT(resource.allocations, before);
+    }
+    EXPECT_EQ(resource.bytesOutstanding, 0);
+}
+
+TEST(HashMapTest, MonotonicBufferHoldsWholeTable) {
+    // The upstream refuses every allocation, so any allocation that doesn't come from the buffer throws
+    alignas(std::max_align_t) static std::byte buffer[1 << 20];
+    std::pmr::monotonic_buffer_resource arena { buffer, sizeof(buffer), std::pmr::null_memory_resource() };
+    systems_dsa::pmr::unordered_map<int, int, std::hash<int>, std::equal_to<int>, systems_dsa::modulo_bucket_policy,
+        systems_dsa::robin_hood_probe_policy> hashMap { &arena };
+    for (int i {}; i < 1'000; ++i) {
+        hashMap.insert(i, -i);
+    }
+    hashMap.erase(3);
+    EXPECT_EQ(hashMap.size(), 999);
+    EXPECT_FALSE(hashMap.contains(3));
+    EXPECT_EQ(hashMap.at(999), -999);
+}
+
+TEST(HashMapTest, PmrMoveAssignAcrossResourcesRebuildsTable) {
+    CountingResource resourceA {};
+    CountingResource resourceB {};
+    {
+        systems_dsa::pmr::unordered_map<std::string, LifetimeTracker> mapA { &resourceA };
+        systems_dsa::pmr::unordered_map<std::string, LifetimeTracker> mapB { &resourceB };
+        mapA.insert("stale", LifetimeTracker { 1 });
+        for (int i {}; i < 100; ++i) {
+            mapB.insert(std::to_string(i), LifetimeTracker { i });
+        }
+        mapA = std::move(mapB);
+        EXPECT_EQ(mapA.get_allocator().resource(), &resourceA);
+        EXPECT_EQ(mapA.size(), 100);
+        EXPECT_FALSE(mapA.contains("stale"));
+        for (int i {}; i < 100; ++i) {
+            EXPECT_EQ(mapA.at(std::to_string(i)).id, i);
+        }
+        EXPECT_TRUE(mapB.empty());
+    }
+    EXPECT_EQ(resourceA.bytesOutstanding, 0);
+    EXPECT_EQ(resourceB.bytesOutstanding, 0);
+    LifetimeTracker::resetCounts();
+}
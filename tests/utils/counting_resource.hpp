@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+
+// Forwards to an upstream resource and tracks what passes through it
+class CountingResource : public std::pmr::memory_resource {
+    public:
+    std::size_t allocations {};
+    std::size_t deallocations {};
+    std::size_t bytesOutstanding {};
+
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : m_upstream { upstream } {}
+
+    private:
+    std::pmr::memory_resource* m_upstream;
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        void* ptr { m_upstream->allocate(bytes, alignment) };
+        ++allocations;
+        bytesOutstanding += bytes;
+        return ptr;
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {
+        m_upstream->deallocate(ptr, bytes, alignment);
+        ++deallocations;
+        bytesOutstanding -= bytes;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
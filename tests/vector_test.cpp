@@ -1,8 +1,18 @@
+#include "utils/counting_resource.hpp"
 #include "utils/lifetime_tracker.hpp"
 #include "utils/seed.hpp"
 #include "utils/throws_on_copy.hpp"
 
+#include <algorithm>
 #include <gtest/gtest.h>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <sstream>
+#include <string>
 #include <systems_dsa/vector.hpp>
 
 ///////////////////////////////
@@ -141,6 +151,23 @@ TEST(VectorTest, EmplaceBackConstructsInContainer) {
     LifetimeTracker::resetCounts();
 }
 
+TEST(VectorTest, PushBackOfOwnElementAtCapacity) {
+    // Strings long enough to live on the heap, so reading one after it's moved from would see an empty string
+    const std::string first(32, 'a');
+    systems_dsa::vector<std::string> myVec(1);
+    myVec.push_back(first);
+    ASSERT_EQ(myVec.size(), myVec.capacity());
+
+    myVec.push_back(myVec.back());
+    while (myVec.size() < myVec.capacity()) {
+        myVec.emplace_back(myVec.front());
+    }
+    myVec.emplace_back(myVec.back());
+    for (const std::string& element : myVec) {
+        EXPECT_EQ(element, first);
+    }
+}
+
 TEST(VectorTest, ResizeDefaultConstructs) {
     systems_dsa::vector<int> myVec(2);
     std::size_t newSize1 { 5 };
@@ -222,6 +249,322 @@ TEST(VectorTest, RangeBasedForLoopWorks) {
     }
 }
 
+static_assert(std::contiguous_iterator<systems_dsa::vector<int>::iterator>);
+static_assert(std::contiguous_iterator<systems_dsa::vector<int>::const_iterator>);
+static_assert(std::ranges::contiguous_range<systems_dsa::vector<int>>);
+static_assert(std::ranges::sized_range<const systems_dsa::vector<std::string>>);
+
+TEST(VectorTest, IteratorsSupportRandomAccess) {
+    systems_dsa::vector<int> myVec { 10, 20, 30, 40 };
+    auto it { myVec.begin() };
+    EXPECT_EQ(*it++, 10) << "Post-increment must return the previous position";
+    EXPECT_EQ(*it, 20);
+    it += 2;
+    EXPECT_EQ(*it, 40);
+    EXPECT_EQ(*--it, 30);
+    EXPECT_EQ(it[-2], 10);
+    EXPECT_EQ(myVec.end() - myVec.begin(), 4);
+    EXPECT_LT(myVec.begin(), myVec.end());
+    EXPECT_EQ(2 + myVec.cbegin(), myVec.begin() + 2);
+    EXPECT_EQ(std::to_address(myVec.begin()), myVec.data());
+    EXPECT_EQ(*std::prev(myVec.end()), 40);
+}
+
+TEST(VectorTest, StandardAlgorithmsAndSpanWork) {
+    systems_dsa::vector<int> myVec { 5, 3, 9, 1, 7 };
+    std::sort(myVec.begin(), myVec.end());
+    EXPECT_TRUE(std::is_sorted(myVec.begin(), myVec.end()));
+    std::ranges::sort(myVec, std::greater {});
+    EXPECT_EQ(myVec.front(), 9);
+    EXPECT_EQ(std::accumulate(myVec.begin(), myVec.end(), 0), 25);
+
+    const std::span<int> view { myVec };
+    EXPECT_EQ(view.size(), myVec.size());
+    EXPECT_EQ(view.data(), myVec.data());
+    view[0] = 100;
+    EXPECT_EQ(myVec[0], 100);
+
+    const systems_dsa::vector<int>& constVec { myVec };
+    const std::span<const int> constView { constVec };
+    EXPECT_EQ(constView.back(), 1);
+}
+
+// Owns a heap int like std::unique_ptr, and opts in to bitwise relocation
+struct RelocatableBox {
+    std::unique_ptr<int> value;
+    inline static int moveCount = 0;
+
+    explicit RelocatableBox(int val) : value { std::make_unique<int>(val) } {}
+    RelocatableBox(RelocatableBox&& other) noexcept : value { std::move(other.value) } {
+        ++moveCount;
+    }
+};
+
+template <>
+struct systems_dsa::is_trivially_relocatable<RelocatableBox> : std::true_type {};
+
+static_assert(systems_dsa::is_trivially_relocatable_v<int>);
+static_assert(!systems_dsa::is_trivially_relocatable_v<std::string>);
+static_assert(!systems_dsa::is_trivially_relocatable_v<LifetimeTracker>);
+
+TEST(VectorTest, TriviallyRelocatableGrowthSkipsMoveConstructor) {
+    RelocatableBox::moveCount = 0;
+    systems_dsa::vector<RelocatableBox> myVec {};
+    for (int i {}; i < 1'000; ++i) {
+        myVec.emplace_back(i);
+    }
+    // Each reallocation memcpys the boxes, so none are moved and every heap int is still owned exactly once
+    EXPECT_EQ(RelocatableBox::moveCount, 0);
+    for (int i {}; i < 1'000; ++i) {
+        ASSERT_EQ(*myVec[i].value, i);
+    }
+}
+
+TEST(VectorTest, TriviallyCopyableCopiesAreIndependent) {
+    systems_dsa::vector<int> original {};
+    for (int i {}; i < 100; ++i) {
+        original.push_back(i);
+    }
+    systems_dsa::vector<int> copy { original };
+    systems_dsa::vector<int> assigned {};
+    assigned.push_back(-1);
+    assigned = original;
+    original[0] = 1'000;
+
+    ASSERT_EQ(copy.size(), 100);
+    ASSERT_EQ(assigned.size(), 100);
+    for (int i {}; i < 100; ++i) {
+        EXPECT_EQ(copy[i], i);
+        EXPECT_EQ(assigned[i], i);
+    }
+}
+
+TEST(VectorTest, PmrVectorAllocatesFromItsResource) {
+    CountingResource resource {};
+    {
+        systems_dsa::pmr::vector<std::pmr::string> myVec { &resource };
+        for (int i {}; i < 100; ++i) {
+            myVec.emplace_back("a string long enough to not fit the small buffer");
+        }
+        EXPECT_EQ(myVec.get_allocator().resource(), &resource);
+        // Elements are constructed through the allocator, so they use the same resource
+        EXPECT_EQ(myVec[0].get_allocator().resource(), &resource);
+        EXPECT_GT(resource.allocations, 100);
+    }
+    EXPECT_EQ(resource.bytesOutstanding, 0);
+    EXPECT_EQ(resource.deallocations, resource.allocations);
+}
+
+TEST(VectorTest, PmrMoveAssignAcrossResourcesKeepsAllocator) {
+    CountingResource resourceA {};
+    CountingResource resourceB {};
+    {
+        systems_dsa::pmr::vector<int> vecA { &resourceA };
+        systems_dsa::pmr::vector<int> vecB { &resourceB };
+        for (int i {}; i < 50; ++i) {
+            vecB.push_back(i);
+        }
+        vecA = std::move(vecB);
+        // polymorphic_allocator doesn't propagate, so the elements are moved into storage from resourceA
+        EXPECT_EQ(vecA.get_allocator().resource(), &resourceA);
+        ASSERT_EQ(vecA.size(), 50);
+        for (int i {}; i < 50; ++i) {
+            EXPECT_EQ(vecA[i], i);
+        }
+
+        systems_dsa::pmr::vector<int> moved { std::move(vecA) };
+        EXPECT_EQ(moved.get_allocator().resource(), &resourceA);
+        systems_dsa::pmr::vector<int> copied { moved };
+        EXPECT_EQ(copied.get_allocator().resource(), std::pmr::get_default_resource());
+        EXPECT_EQ(copied.size(), 50);
+    }
+    EXPECT_EQ(resourceA.bytesOutstanding, 0);
+    EXPECT_EQ(resourceB.bytesOutstanding, 0);
+}
+
+////////////////////
+// Growth & Sizing //
+////////////////////
+
+TEST(VectorTest, DefaultConstructionAllocatesNothing) {
+    CountingResource resource {};
+    {
+        systems_dsa::pmr::vector<int> myVec { &resource };
+        EXPECT_EQ(myVec.capacity(), 0);
+        EXPECT_EQ(resource.allocations, 0);
+        myVec.push_back(1);
+        EXPECT_GE(myVec.capacity(), 1);
+        EXPECT_EQ(resource.allocations, 1);
+    }
+    EXPECT_EQ(resource.bytesOutstanding, 0);
+}
+
+TEST(VectorTest, ResizeAndReserveAllocateExactly) {
+    systems_dsa::vector<int> myVec;
+    myVec.resize(100);
+    EXPECT_EQ(myVec.capacity(), 100);
+    myVec.resize(10);
+    myVec.resize(50);
+    EXPECT_EQ(myVec.capacity(), 100); // Fits, no reallocation
+    myVec.reserve(1000);
+    EXPECT_EQ(myVec.capacity(), 1000);
+    myVec.reserve(10);
+    EXPECT_EQ(myVec.capacity(), 1000);
+
+    systems_dsa::vector<int> copied { myVec };
+    EXPECT_EQ(copied.capacity(), 50);
+
+    systems_dsa::vector<int> emptied { 1, 2, 3 };
+    emptied.clear();
+    emptied.shrink_to_fit();
+    EXPECT_EQ(emptied.capacity(), 0);
+    emptied.push_back(4);
+    EXPECT_EQ(emptied[0], 4);
+}
+
+TEST(VectorTest, GrowthPoliciesPickCapacity) {
+    systems_dsa::vector<int, std::allocator<int>, systems_dsa::doubling_growth_policy> doubling;
+    systems_dsa::vector<std::uint64_t, std::allocator<std::uint64_t>, systems_dsa::size_class_growth_policy> sized;
+    std::size_t lastDoubling {};
+    for (int i {}; i < 1000; ++i) {
+        doubling.push_back(i);
+        sized.push_back(i);
+        if (doubling.capacity() != lastDoubling && lastDoubling != 0) {
+            EXPECT_EQ(doubling.capacity(), lastDoubling * 2);
+        }
+        lastDoubling = doubling.capacity();
+        EXPECT_EQ(sized.capacity() * sizeof(std::uint64_t),
+            systems_dsa::size_class_growth_policy::size_class(sized.capacity() * sizeof(std::uint64_t)));
+    }
+    EXPECT_EQ(systems_dsa::size_class_growth_policy::size_class(1), 16);
+    EXPECT_EQ(systems_dsa::size_class_growth_policy::size_class(129), 160);
+    EXPECT_EQ(systems_dsa::size_class_growth_policy::size_class(257), 320);
+    EXPECT_EQ(doubling[999], 999);
+    EXPECT_EQ(sized[999], 999);
+}
+
+///////////////////
+// Bulk Modifiers //
+///////////////////
+
+TEST(VectorTest, AppendRangeGrowsOnce) {
+    CountingResource resource {};
+    {
+        systems_dsa::pmr::vector<int> myVec { &resource };
+        myVec.push_back(-1);
+        const std::vector<int> batch(1'000, 7);
+        const auto allocationsBefore { resource.allocations };
+        myVec.append_range(batch);
+        EXPECT_EQ(resource.allocations, allocationsBefore + 1);
+        ASSERT_EQ(myVec.size(), 1'001);
+        EXPECT_EQ(myVec[0], -1);
+        EXPECT_EQ(myVec[1'000], 7);
+    }
+    EXPECT_EQ(resource.bytesOutstanding, 0);
+}
+
+TEST(VectorTest, AppendRangeFromInputRange) {
+    std::istringstream input { "1 2 3 4 5" };
+    systems_dsa::vector<int> myVec { 0 };
+    myVec.append_range(std::views::istream<int>(input));
+    ASSERT_EQ(myVec.size(), 6);
+    for (int i {}; i < 6; ++i) {
+        EXPECT_EQ(myVec[i], i);
+    }
+}
+
+TEST(VectorTest, AssignReplacesContents) {
+    systems_dsa::vector<std::string> myVec { "a", "b", "c" };
+    myVec.assign(2, "x");
+    ASSERT_EQ(myVec.size(), 2);
+    EXPECT_EQ(myVec[1], "x");
+
+    const std::vector<std::string> source { "d", "e", "f", "g", "h" };
+    myVec.assign(source.begin(), source.end());
+    ASSERT_EQ(myVec.size(), 5);
+    EXPECT_EQ(myVec.capacity(), 5);
+    EXPECT_EQ(myVec[4], "h");
+
+    myVec.assign({ "i" });
+    ASSERT_EQ(myVec.size(), 1);
+    EXPECT_EQ(myVec[0], "i");
+    EXPECT_EQ(myVec.capacity(), 5) << "Storage that's big enough should be reused";
+}
+
+TEST(VectorTest, InsertRangeInTheMiddle) {
+    systems_dsa::vector<int> ints { 0, 1, 5, 6 };
+    const std::vector<int> middle { 2, 3, 4 };
+    const auto inserted { ints.insert(ints.begin() + 2, middle.begin(), middle.end()) };
+    EXPECT_EQ(*inserted, 2);
+    ASSERT_EQ(ints.size(), 7);
+    for (int i {}; i < 7; ++i) {
+        EXPECT_EQ(ints[i], i);
+    }
+
+    systems_dsa::vector<std::string> strings { "a", "e" };
+    strings.reserve(10);
+    strings.insert(strings.begin() + 1, { "b", "c", "d" });
+    strings.insert(strings.end(), { "f" });
+    strings.insert(strings.begin(), { "0" });
+    ASSERT_EQ(strings.size(), 7);
+    EXPECT_EQ(strings[0], "0");
+    EXPECT_EQ(strings[1], "a");
+    EXPECT_EQ(strings[3], "c");
+    EXPECT_EQ(strings[6], "f");
+}
+
+TEST(VectorTest, InsertAndEraseRelocateWithoutMoving) {
+    RelocatableBox::moveCount = 0;
+    systems_dsa::vector<RelocatableBox> myVec {};
+    for (int i {}; i < 4; ++i) {
+        myVec.emplace_back(i * 10);
+    }
+    std::vector<RelocatableBox> source {};
+    source.emplace_back(11);
+    source.emplace_back(12);
+    const int movesBefore { RelocatableBox::moveCount };
+    myVec.insert(myVec.begin() + 2, std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()));
+    // Only the two inserted elements are moved, the ones after them are relocated
+    EXPECT_EQ(RelocatableBox::moveCount, movesBefore + 2);
+    ASSERT_EQ(myVec.size(), 6);
+    EXPECT_EQ(*myVec[2].value, 11);
+    EXPECT_EQ(*myVec[5].value, 30);
+
+    const auto next { myVec.erase(myVec.begin() + 1, myVec.begin() + 3) };
+    EXPECT_EQ(*next->value, 12);
+    ASSERT_EQ(myVec.size(), 4);
+    EXPECT_EQ(*myVec[0].value, 0);
+    EXPECT_EQ(*myVec[3].value, 30);
+}
+
+TEST(VectorTest, EraseShiftsTheRestDown) {
+    systems_dsa::vector<std::string> myVec { "a", "b", "c", "d", "e" };
+    auto next { myVec.erase(myVec.begin() + 1) };
+    EXPECT_EQ(*next, "c");
+    next = myVec.erase(myVec.begin() + 2, myVec.end());
+    EXPECT_EQ(next, myVec.end());
+    ASSERT_EQ(myVec.size(), 2);
+    EXPECT_EQ(myVec[0], "a");
+    EXPECT_EQ(myVec[1], "c");
+    myVec.erase(myVec.begin(), myVec.begin());
+    EXPECT_EQ(myVec.size(), 2);
+}
+
+TEST(VectorTest, ResizeForOverwriteDefaultInitializes) {
+    systems_dsa::vector<int> ints { 1, 2 };
+    ints.resize_for_overwrite(100);
+    EXPECT_EQ(ints.size(), 100);
+    EXPECT_EQ(ints.capacity(), 100);
+    EXPECT_EQ(ints[1], 2);
+
+    LifetimeTracker::resetCounts();
+    systems_dsa::vector<LifetimeTracker> trackers {};
+    trackers.resize_for_overwrite(5);
+    EXPECT_EQ(LifetimeTracker::ctorCount, 5);
+    trackers.resize_for_overwrite(2);
+    EXPECT_EQ(LifetimeTracker::dtorCount, 3);
+}
+
 //////////////////////
 // Exception Safety //
 //////////////////////
@@ -250,6 +593,37 @@ TEST(VectorTest, ContainerUnmodifiedAfterException) {
     }
 }
 
+// Movable, unlike ThrowsOnCopy, so it can be shifted by insert. Throws on the copy after `copiesLeft` more.
+struct ThrowsOnNthCopy {
+    int id {};
+    inline static int copiesLeft = -1;
+
+    explicit ThrowsOnNthCopy(int val) : id { val } {}
+    ThrowsOnNthCopy(const ThrowsOnNthCopy& other) : id { other.id } {
+        if (copiesLeft-- == 0) {
+            throw std::runtime_error("Copy failed");
+        }
+    }
+    ThrowsOnNthCopy(ThrowsOnNthCopy&&) noexcept = default;
+    ThrowsOnNthCopy& operator=(const ThrowsOnNthCopy&) = default;
+    ThrowsOnNthCopy& operator=(ThrowsOnNthCopy&&) noexcept = default;
+};
+
+TEST(VectorTest, InsertRangeUnmodifiedAfterException) {
+    systems_dsa::vector<ThrowsOnNthCopy> myVec;
+    for (int i {}; i < 4; ++i) {
+        myVec.emplace_back(i);
+    }
+    const std::vector<ThrowsOnNthCopy> source { ThrowsOnNthCopy { 100 }, ThrowsOnNthCopy { 101 }, ThrowsOnNthCopy { 102 } };
+    ThrowsOnNthCopy::copiesLeft = 1;
+    EXPECT_ANY_THROW(myVec.insert(myVec.begin() + 1, source.begin(), source.end()));
+    ThrowsOnNthCopy::copiesLeft = -1;
+    ASSERT_EQ(myVec.size(), 4);
+    for (int i {}; i < 4; ++i) {
+        EXPECT_EQ(myVec[i].id, i);
+    }
+}
+
 ///////////////////////
 // Lifetime Tracking //
 ///////////////////////
@@ -345,4 +719,60 @@ TEST(VectorTest, RandomSeqEmplacePopResizeAccessAgainstStd) {
             break;
         }
     }
-}
\ No newline at end of file
+}
+
+TEST(VectorTest, RandomSeqInsertEraseAppendAgainstStd) {
+    std::uint64_t seed { getSeed("VECTOR_SEED") };
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> distOp(0, 3);
+    std::uniform_int_distribution<std::size_t> distCount(0, 16);
+
+    systems_dsa::vector<std::string> strings {};
+    systems_dsa::vector<int> ints {};
+    std::vector<std::string> reference {};
+
+    for (std::size_t i {}; i < 2'000; ++i) {
+        const std::size_t pos { std::uniform_int_distribution<std::size_t>(0, reference.size())(rng) };
+        switch (distOp(rng)) {
+        case 0: {
+                std::vector<std::string> batch(distCount(rng), std::to_string(i));
+                strings.insert(strings.begin() + static_cast<std::ptrdiff_t>(pos), batch.begin(), batch.end());
+                std::vector<int> intBatch(batch.size(), static_cast<int>(i));
+                ints.insert(ints.begin() + static_cast<std::ptrdiff_t>(pos), intBatch.begin(), intBatch.end());
+                reference.insert(reference.begin() + static_cast<std::ptrdiff_t>(pos), batch.begin(), batch.end());
+                break;
+            }
+        case 1: {
+                const std::size_t last { std::min(reference.size(), pos + distCount(rng)) };
+                strings.erase(strings.begin() + static_cast<std::ptrdiff_t>(pos), strings.begin() + static_cast<std::ptrdiff_t>(last));
+                ints.erase(ints.begin() + static_cast<std::ptrdiff_t>(pos), ints.begin() + static_cast<std::ptrdiff_t>(last));
+                reference.erase(reference.begin() + static_cast<std::ptrdiff_t>(pos), reference.begin() + static_cast<std::ptrdiff_t>(last));
+                break;
+            }
+        case 2: {
+                std::vector<std::string> batch(distCount(rng), std::to_string(i));
+                strings.append_range(batch);
+                ints.append_range(std::vector<int>(batch.size(), static_cast<int>(i)));
+                reference.insert(reference.end(), batch.begin(), batch.end());
+                break;
+            }
+        case 3:
+            if (reference.size() > 64) {
+                reference.resize(8);
+                strings.assign(reference.begin(), reference.end());
+                std::vector<int> intValues {};
+                for (const auto& str : reference) {
+                    intValues.push_back(std::stoi(str));
+                }
+                ints.assign_range(intValues);
+            }
+            break;
+        }
+        ASSERT_EQ(strings.size(), reference.size()) << "seed=" << seed;
+        ASSERT_EQ(ints.size(), reference.size()) << "seed=" << seed;
+        for (std::size_t j {}; j < reference.size(); ++j) {
+            ASSERT_EQ(strings[j], reference[j]) << "seed=" << seed;
+            ASSERT_EQ(ints[j], std::stoi(reference[j])) << "seed=" << seed;
+        }
+    }
+}